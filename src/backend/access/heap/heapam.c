@@ -45,6 +45,7 @@
 #include "commands/vacuum.h"
 #include "pgstat.h"
 #include "port/pg_bitutils.h"
+#include "storage/checksum_logical.h"
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "storage/procarray.h"
@@ -2170,6 +2171,9 @@ heap_insert(Relation relation, HeapTuple tup, CommandId cid,
 	 */
 	heaptup = heap_prepare_insert(relation, tup, xid, cid, options);
 
+	if (RelationHasLogicalChecksum(relation))
+		pg_logical_checksum_insert(relation, heaptup);
+
 	/*
 	 * Find buffer to insert this tuple into.  If the page is all visible,
 	 * this will also pin the requisite visibility map page.
@@ -2456,6 +2460,9 @@ heap_multi_insert(Relation relation, TupleTableSlot **slots, int ntuples,
 		tuple->t_tableOid = slots[i]->tts_tableOid;
 		heaptuples[i] = heap_prepare_insert(relation, tuple, xid, cid,
 											options);
+
+		if (RelationHasLogicalChecksum(relation))
+			pg_logical_checksum_insert(relation, heaptuples[i]);
 	}
 
 	/*
@@ -3099,6 +3106,9 @@ l1:
 	 */
 	old_key_tuple = ExtractReplicaIdentity(relation, &tp, true, &old_key_copied);
 
+	if (RelationHasLogicalChecksum(relation))
+		pg_logical_checksum_delete(relation, &tp);
+
 	/*
 	 * If this is the first possibly-multixact-able operation in the current
 	 * transaction, set my per-backend OldestMemberMXactId setting. We can be
@@ -4124,6 +4134,12 @@ l2:
 										   id_has_external,
 										   &old_key_copied);
 
+	if (RelationHasLogicalChecksum(relation))
+	{
+		pg_logical_checksum_delete(relation, &oldtup);
+		pg_logical_checksum_insert(relation, heaptup);
+	}
+
 	/* NO EREPORT(ERROR) from here till changes are logged */
 	START_CRIT_SECTION();
 
@@ -6307,6 +6323,9 @@ heap_abort_speculative(Relation relation, const ItemPointerData *tid)
 	 * do anything special with infomask bits.
 	 */
 
+	if (RelationHasLogicalChecksum(relation))
+		pg_logical_checksum_delete(relation, &tp);
+
 	START_CRIT_SECTION();
 
 	/*
@@ -0,0 +1,58 @@
+/*-------------------------------------------------------------------------
+ *
+ * logicalchecksumdesc.c
+ *	  rmgr descriptor routines for storage/checksum/checksum_logical.c
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/access/rmgrdesc/logicalchecksumdesc.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "storage/checksum_logical_xlog.h"
+
+void
+logical_checksum_desc(StringInfo buf, XLogReaderState *record)
+{
+	char	   *rec = XLogRecGetData(record);
+	uint8		info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+
+	if (info == XLOG_LOGICAL_CHECKSUM_DELTA)
+	{
+		xl_logical_checksum_delta *xlrec = (xl_logical_checksum_delta *) rec;
+
+		appendStringInfo(buf, "db %u; nitems %d", xlrec->dbid, xlrec->nitems);
+		for (int i = 0; i < xlrec->nitems; i++)
+		{
+			xl_logical_checksum_item *item = &xlrec->items[i];
+
+			appendStringInfo(buf, "; rel %u: checksum " UINT64_FORMAT
+							 " ntuples " INT64_FORMAT,
+							 item->relid, item->checksum, item->ntuples);
+			if (item->flags & XLLC_RESET)
+				appendStringInfoString(buf, " reset");
+			if (item->flags & XLLC_DROP)
+				appendStringInfoString(buf, " drop");
+		}
+	}
+}
+
+const char *
+logical_checksum_identify(uint8 info)
+{
+	const char *id = NULL;
+
+	switch (info & ~XLR_INFO_MASK)
+	{
+		case XLOG_LOGICAL_CHECKSUM_DELTA:
+			id = "DELTA";
+			break;
+	}
+
+	return id;
+}
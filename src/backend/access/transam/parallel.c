@@ -34,6 +34,8 @@
 #include "miscadmin.h"
 #include "optimizer/optimizer.h"
 #include "pgstat.h"
+#include "storage/checksum_database.h"
+#include "storage/checksum_table.h"
 #include "storage/ipc.h"
 #include "storage/predicate.h"
 #include "storage/spin.h"
@@ -154,6 +156,12 @@ static const struct
 	},
 	{
 		"parallel_vacuum_main", parallel_vacuum_main
+	},
+	{
+		"checksum_table_parallel_main", checksum_table_parallel_main
+	},
+	{
+		"database_checksum_parallel_main", database_checksum_parallel_main
 	}
 };
 
@@ -53,6 +53,7 @@
 #include "replication/snapbuild.h"
 #include "replication/syncrep.h"
 #include "storage/aio_subsys.h"
+#include "storage/checksum_logical.h"
 #include "storage/condition_variable.h"
 #include "storage/fd.h"
 #include "storage/lmgr.h"
@@ -1409,6 +1410,12 @@ RecordTransactionCommit(void)
 	{
 		bool		replorigin;
 
+		/*
+		 * Log the changes to incrementally maintained table checksums.  This
+		 * must happen before the critical section, since it may fail.
+		 */
+		LogicalChecksumLogDeltas();
+
 		/*
 		 * Are we using the replication origins feature?  Or, in other words,
 		 * are we replaying remote actions?
@@ -1481,6 +1488,9 @@ RecordTransactionCommit(void)
 		TransactionTreeSetCommitTsData(xid, nchildren, children,
 									   replorigin_session_origin_timestamp,
 									   replorigin_session_origin);
+
+		/* Apply them, now that the commit record is written */
+		LogicalChecksumApplyDeltas(XactLastRecEnd);
 	}
 
 	/*
@@ -2486,6 +2496,7 @@ CommitTransaction(void)
 	AtEOXact_ComboCid();
 	AtEOXact_HashTables(true);
 	AtEOXact_PgStat(true, is_parallel_worker);
+	AtEOXact_LogicalChecksum(true);
 	AtEOXact_Snapshot(true, false);
 	AtEOXact_ApplyLauncher(true);
 	AtEOXact_LogicalRepWorkers(true);
@@ -2684,6 +2695,7 @@ PrepareTransaction(void)
 	AtPrepare_Locks();
 	AtPrepare_PredicateLocks();
 	AtPrepare_PgStat();
+	AtPrepare_LogicalChecksum();
 	AtPrepare_MultiXact();
 	AtPrepare_RelationMap();
 
@@ -2781,6 +2793,7 @@ PrepareTransaction(void)
 	AtEOXact_ComboCid();
 	AtEOXact_HashTables(true);
 	/* don't call AtEOXact_PgStat here; we fixed pgstat state above */
+	AtEOXact_LogicalChecksum(false);
 	AtEOXact_Snapshot(true, true);
 	/* we treat PREPARE as ROLLBACK so far as waking workers goes */
 	AtEOXact_ApplyLauncher(false);
@@ -3011,6 +3024,7 @@ AbortTransaction(void)
 		AtEOXact_ComboCid();
 		AtEOXact_HashTables(false);
 		AtEOXact_PgStat(false, is_parallel_worker);
+		AtEOXact_LogicalChecksum(false);
 		AtEOXact_ApplyLauncher(false);
 		AtEOXact_LogicalRepWorkers(false);
 		AtEOXact_LogicalCtl();
@@ -5213,6 +5227,7 @@ CommitSubTransaction(void)
 					  s->parent->subTransactionId);
 	AtEOSubXact_HashTables(true, s->nestingLevel);
 	AtEOSubXact_PgStat(true, s->nestingLevel);
+	AtEOSubXact_LogicalChecksum(true, s->nestingLevel);
 	AtSubCommit_Snapshot(s->nestingLevel);
 
 	/*
@@ -5382,6 +5397,7 @@ AbortSubTransaction(void)
 						  s->parent->subTransactionId);
 		AtEOSubXact_HashTables(false, s->nestingLevel);
 		AtEOSubXact_PgStat(false, s->nestingLevel);
+		AtEOSubXact_LogicalChecksum(false, s->nestingLevel);
 		AtSubAbort_Snapshot(s->nestingLevel);
 	}
 
@@ -6176,6 +6192,9 @@ xact_redo_commit(xl_xact_parsed_commit *parsed,
 	TransactionTreeSetCommitTsData(xid, parsed->nsubxacts, parsed->subxacts,
 								   commit_time, origin_id);
 
+	/* Apply the changes to incrementally maintained table checksums */
+	LogicalChecksumRedoCommit(xid, lsn);
+
 	if (standbyState == STANDBY_DISABLED)
 	{
 		/*
@@ -6316,6 +6335,8 @@ xact_redo_abort(xl_xact_parsed_abort *parsed, TransactionId xid,
 								  parsed->subxacts);
 	AdvanceNextFullTransactionIdPastXid(max_xid);
 
+	LogicalChecksumRedoAbort(xid);
+
 	if (standbyState == STANDBY_DISABLED)
 	{
 		/* Mark the transaction aborted in pg_xact, no need for async stuff */
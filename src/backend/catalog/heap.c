@@ -67,6 +67,7 @@
 #include "parser/parsetree.h"
 #include "partitioning/partdesc.h"
 #include "pgstat.h"
+#include "storage/checksum_logical.h"
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "utils/array.h"
@@ -1884,6 +1885,10 @@ heap_drop_with_catalog(Oid relid)
 	/* ensure that stats are dropped if transaction commits */
 	pgstat_drop_relation(rel);
 
+	/* likewise for the logical checksum */
+	if (RelationHasLogicalChecksum(rel))
+		pg_logical_checksum_disable(RelationGetRelid(rel));
+
 	/*
 	 * Close relcache entry, but *keep* AccessExclusiveLock on the relation
 	 * until transaction commit.  This ensures no one else will try to do
@@ -1385,6 +1385,31 @@ CREATE VIEW pg_stat_progress_copy AS
     FROM pg_stat_get_progress_info('COPY') AS S
         LEFT JOIN pg_database D ON S.datid = D.oid;
 
+CREATE VIEW pg_stat_progress_checksum AS
+    SELECT
+        S.pid AS pid, S.datid AS datid, D.datname AS datname,
+        S.relid AS relid,
+        CASE S.param1 WHEN 1 THEN 'table'
+                      WHEN 2 THEN 'index'
+                      WHEN 3 THEN 'index verify'
+                      WHEN 4 THEN 'database'
+                      END AS command,
+        CASE S.param2 WHEN 0 THEN 'initializing'
+                      WHEN 1 THEN 'collecting relations'
+                      WHEN 2 THEN 'scanning table'
+                      WHEN 3 THEN 'scanning index'
+                      WHEN 4 THEN 'waiting for workers'
+                      END AS phase,
+        CAST(S.param3 AS oid) AS current_relid,
+        S.param4 AS relations_total,
+        S.param5 AS relations_done,
+        S.param6 AS blocks_total,
+        S.param7 AS blocks_done,
+        S.param8 AS tuples_done,
+        S.param9 AS bytes_done
+    FROM pg_stat_get_progress_info('CHECKSUM') AS S
+        LEFT JOIN pg_database D ON S.datid = D.oid;
+
 CREATE VIEW pg_user_mappings AS
     SELECT
         U.oid       AS umid,
@@ -1443,6 +1468,50 @@ CREATE VIEW pg_stat_subscription_stats AS
     FROM pg_subscription as s,
          pg_stat_get_subscription_stats(s.oid) as ss;
 
+CREATE VIEW pg_stat_checksums AS
+    SELECT
+            C.oid AS relid,
+            N.nspname AS schemaname,
+            C.relname AS relname,
+            S.invocations,
+            S.tuples,
+            S.bytes,
+            S.total_time,
+            S.mismatches,
+            S.last_result,
+            S.last_run_time,
+            S.scrub_count,
+            S.scrub_failures,
+            S.last_checksum,
+            S.last_verified_lsn,
+            S.last_verified_time,
+            S.last_failure_time,
+            S.stats_reset
+    FROM pg_class C LEFT JOIN pg_namespace N ON (N.oid = C.relnamespace),
+         pg_stat_get_checksum_stats(C.oid) S
+    WHERE C.relkind IN ('r', 't', 'm', 'i')
+    UNION ALL
+    -- One row for the database as a whole
+    SELECT
+            NULL::oid AS relid,
+            NULL::name AS schemaname,
+            NULL::name AS relname,
+            S.invocations,
+            S.tuples,
+            S.bytes,
+            S.total_time,
+            S.mismatches,
+            S.last_result,
+            S.last_run_time,
+            S.scrub_count,
+            S.scrub_failures,
+            S.last_checksum,
+            S.last_verified_lsn,
+            S.last_verified_time,
+            S.last_failure_time,
+            S.stats_reset
+    FROM pg_stat_get_checksum_stats(0::oid) S;
+
 CREATE VIEW pg_wait_events AS
     SELECT * FROM pg_get_wait_events();
 
@@ -43,6 +43,7 @@
 #include "optimizer/optimizer.h"
 #include "pgstat.h"
 #include "storage/bufmgr.h"
+#include "storage/checksum_logical.h"
 #include "storage/lmgr.h"
 #include "storage/predicate.h"
 #include "utils/acl.h"
@@ -1514,6 +1515,9 @@ finish_heap_swap(Oid OIDOldHeap, Oid OIDNewHeap,
 
 	reindex_relation(NULL, OIDOldHeap, reindex_flags, &reindex_params);
 
+	/* The rewrite bypassed heap_insert(); recompute the logical checksum */
+	pg_logical_checksum_rewrite(OIDOldHeap);
+
 	/* Report that we are now doing clean up */
 	pgstat_progress_update_param(PROGRESS_CLUSTER_PHASE,
 								 PROGRESS_CLUSTER_PHASE_FINAL_CLEANUP);
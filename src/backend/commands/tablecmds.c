@@ -90,6 +90,7 @@
 #include "rewrite/rewriteHandler.h"
 #include "rewrite/rewriteManip.h"
 #include "storage/bufmgr.h"
+#include "storage/checksum_logical.h"
 #include "storage/lmgr.h"
 #include "storage/lock.h"
 #include "storage/predicate.h"
@@ -1093,6 +1094,10 @@ DefineRelation(CreateStmt *stmt, char relkind, Oid ownerId,
 	 */
 	rel = relation_open(relationId, AccessExclusiveLock);
 
+	/* Start maintaining the logical checksum of the (empty) table */
+	if (RelationGetLogicalChecksum(rel))
+		pg_logical_checksum_enable(rel);
+
 	/*
 	 * Now add any newly specified column default and generation expressions
 	 * to the new relation.  These are passed to us in the form of raw
@@ -2246,6 +2251,9 @@ ExecuteTruncateGuts(List *explicit_rels,
 							 &reindex_params);
 		}
 
+		if (RelationHasLogicalChecksum(rel))
+			pg_logical_checksum_truncate(rel);
+
 		pgstat_count_truncate(rel);
 	}
 
@@ -16681,6 +16689,7 @@ ATExecSetRelOptions(Relation rel, List *defList, AlterTableType operation,
 	HeapTuple	newtuple;
 	Datum		datum;
 	Datum		newOptions;
+	bytea	   *newHeapOptions = NULL;
 	Datum		repl_val[Natts_pg_class];
 	bool		repl_null[Natts_pg_class];
 	bool		repl_repl[Natts_pg_class];
@@ -16725,7 +16734,8 @@ ATExecSetRelOptions(Relation rel, List *defList, AlterTableType operation,
 	{
 		case RELKIND_RELATION:
 		case RELKIND_MATVIEW:
-			(void) heap_reloptions(rel->rd_rel->relkind, newOptions, true);
+			newHeapOptions = heap_reloptions(rel->rd_rel->relkind, newOptions,
+											 true);
 			break;
 		case RELKIND_PARTITIONED_TABLE:
 			(void) partitioned_table_reloptions(newOptions, true);
@@ -16808,6 +16818,28 @@ ATExecSetRelOptions(Relation rel, List *defList, AlterTableType operation,
 
 	ReleaseSysCache(tuple);
 
+	/*
+	 * Start or stop maintaining the logical checksum.  Setting the option
+	 * again while it is on recomputes the checksum from scratch.
+	 */
+	if (newHeapOptions != NULL &&
+		((StdRdOptions *) newHeapOptions)->logical_checksum)
+	{
+		bool		recompute = !RelationGetLogicalChecksum(rel);
+
+		foreach_node(DefElem, def, defList)
+		{
+			if (def->defnamespace == NULL &&
+				strcmp(def->defname, "logical_checksum") == 0)
+				recompute = true;
+		}
+
+		if (recompute)
+			pg_logical_checksum_enable(rel);
+	}
+	else if (RelationGetLogicalChecksum(rel))
+		pg_logical_checksum_disable(RelationGetRelid(rel));
+
 	/* repeat the whole exercise for the toast table, if there's one */
 	if (OidIsValid(rel->rd_rel->reltoastrelid))
 	{
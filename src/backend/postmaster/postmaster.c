@@ -110,6 +110,7 @@
 #include "replication/slotsync.h"
 #include "replication/walsender.h"
 #include "storage/aio_subsys.h"
+#include "storage/checksum_scrubber.h"
 #include "storage/fd.h"
 #include "storage/io_worker.h"
 #include "storage/ipc.h"
@@ -929,6 +930,11 @@ PostmasterMain(int argc, char *argv[])
 	 */
 	ApplyLauncherRegister();
 
+	/*
+	 * Register the checksum scrubber, if one is configured.
+	 */
+	ChecksumScrubberRegister();
+
 	/*
 	 * process any libraries that should be preloaded at postmaster start
 	 */
@@ -14,9 +14,163 @@
 #include "postgres.h"
 
 #include "storage/checksum.h"
+#include "storage/checksum_simd.h"
+
+/*
+ * Route the row kernel of pg_checksum_data() through the runtime-selected
+ * implementation rather than the portable one.
+ */
+#define PG_CHECKSUM_DATA_ROWS(sums, data, nrows) \
+	pg_checksum_data_rows(sums, data, nrows)
+#define PG_CHECKSUM_DATA_ROWS64(sums, data, nrows) \
+	 pg_checksum_data_rows64(sums, data, nrows)
+#define PG_CHECKSUM_DATA_ROWS128(sums_a, sums_b, data, nrows) \
+	 pg_checksum_data_rows128(sums_a, sums_b, data, nrows)
+
 /*
  * The actual code is in storage/checksum_impl.h.  This is done so that
  * external programs can incorporate the checksum code by #include'ing
  * that file from the exported Postgres headers.  (Compare our CRC code.)
  */
-#include "storage/checksum_impl.h"	/* IWYU pragma: keep */
\ No newline at end of file
+#include "storage/checksum_impl.h"	/* IWYU pragma: keep */
+
+StaticAssertDecl(N_SUMS == CHECKSUM_SIMD_N_SUMS,
+				 "checksum kernels disagree on the number of lanes");
+StaticAssertDecl(N_SUMS == PG_CHECKSUM_DATA_LANES,
+				 "incremental checksum state has the wrong number of lanes");
+StaticAssertDecl(FNV_PRIME == CHECKSUM_SIMD_FNV_PRIME,
+				 "checksum kernels disagree on the FNV prime");
+StaticAssertDecl(FNV_PRIME64 == CHECKSUM_SIMD_FNV_PRIME64 &&
+				 WIDE_PRIME64 == CHECKSUM_SIMD_WIDE_PRIME64,
+				 "wide checksum kernels disagree on the multipliers");
+
+/*
+ * Row kernels in order of preference.  The portable kernel comes last and is
+ * always usable.
+ */
+const pg_checksum_rows_kernel pg_checksum_data_kernels[] = {
+#ifdef USE_CHECKSUM_AVX512_WITH_RUNTIME_CHECK
+	{"avx512", pg_checksum_avx512_available, pg_checksum_data_rows_avx512},
+#endif
+#ifdef USE_CHECKSUM_AVX2_WITH_RUNTIME_CHECK
+	{"avx2", pg_checksum_avx2_available, pg_checksum_data_rows_avx2},
+#endif
+#ifdef USE_CHECKSUM_SSE41_WITH_RUNTIME_CHECK
+	{"sse4.1", pg_checksum_sse41_available, pg_checksum_data_rows_sse41},
+#endif
+#ifdef USE_CHECKSUM_NEON
+	{"neon", NULL, pg_checksum_data_rows_neon},
+#endif
+	{"generic", NULL, pg_checksum_data_rows_generic}
+};
+
+const int	pg_checksum_data_nkernels = lengthof(pg_checksum_data_kernels);
+
+static const char *pg_checksum_data_kernel = NULL;
+
+/*
+ * Pick the fastest row kernel the CPU we're running on supports.
+ */
+static pg_checksum_rows_function
+pg_checksum_data_rows_select(const char **name)
+{
+	int			i;
+
+	for (i = 0; i < pg_checksum_data_nkernels; i++)
+	{
+		const pg_checksum_rows_kernel *kernel = &pg_checksum_data_kernels[i];
+
+		if (kernel->available == NULL || kernel->available())
+		{
+			*name = kernel->name;
+			return kernel->rows;
+		}
+	}
+
+	pg_unreachable();
+}
+
+/*
+ * This gets called on the first call. It replaces the function pointer
+ * so that subsequent calls are routed directly to the chosen implementation.
+ */
+static void
+pg_checksum_data_rows_choose(uint32 *sums, const char *data, uint32 nrows)
+{
+	pg_checksum_data_rows = pg_checksum_data_rows_select(&pg_checksum_data_kernel);
+	pg_checksum_data_rows(sums, data, nrows);
+}
+
+pg_checksum_rows_function pg_checksum_data_rows = pg_checksum_data_rows_choose;
+
+/*
+ * Row kernels of the wide variants in order of preference.  Below AVX2, an
+ * emulated 64-bit vector multiply doesn't beat the scalar one, so the
+ * portable kernels are used; see checksum_simd.c.
+ */
+const pg_checksum_wide_kernel pg_checksum_data_wide_kernels[] = {
+#ifdef USE_CHECKSUM_AVX512_WITH_RUNTIME_CHECK
+	{"avx512", pg_checksum_avx512dq_available,
+	 pg_checksum_data_rows64_avx512, pg_checksum_data_rows128_avx512},
+#endif
+#ifdef USE_CHECKSUM_AVX2_WITH_RUNTIME_CHECK
+	{"avx2", pg_checksum_avx2_available,
+	 pg_checksum_data_rows64_avx2, pg_checksum_data_rows128_avx2},
+#endif
+	{"generic", NULL,
+	 pg_checksum_data_rows64_generic, pg_checksum_data_rows128_generic}
+};
+
+const int	pg_checksum_data_nwide_kernels = lengthof(pg_checksum_data_wide_kernels);
+
+/*
+ * Pick the fastest wide row kernels the CPU we're running on supports.
+ */
+static const pg_checksum_wide_kernel *
+pg_checksum_data_wide_select(void)
+{
+	int			i;
+
+	for (i = 0; i < pg_checksum_data_nwide_kernels; i++)
+	{
+		const pg_checksum_wide_kernel *kernel = &pg_checksum_data_wide_kernels[i];
+
+		if (kernel->available == NULL || kernel->available())
+			return kernel;
+	}
+
+	pg_unreachable();
+}
+
+/*
+ * Choosers for the row kernels of the wide variants.  Like the one above,
+ * they replace the function pointer on first call.
+ */
+static void
+pg_checksum_data_rows64_choose(uint64 *sums, const char *data, uint32 nrows)
+{
+	 pg_checksum_data_rows64 = pg_checksum_data_wide_select()->rows64;
+	 pg_checksum_data_rows64(sums, data, nrows);
+}
+
+static void
+pg_checksum_data_rows128_choose(uint64 *sums_a, uint64 *sums_b,
+								const char *data, uint32 nrows)
+{
+	 pg_checksum_data_rows128 = pg_checksum_data_wide_select()->rows128;
+	 pg_checksum_data_rows128(sums_a, sums_b, data, nrows);
+}
+
+pg_checksum_rows64_function pg_checksum_data_rows64 = pg_checksum_data_rows64_choose;
+pg_checksum_rows128_function pg_checksum_data_rows128 = pg_checksum_data_rows128_choose;
+
+/*
+ * Report which row kernel pg_checksum_data() uses on this machine.
+ */
+const char *
+pg_checksum_data_kernel_name(void)
+{
+	if (pg_checksum_data_kernel == NULL)
+		(void) pg_checksum_data_rows_select(&pg_checksum_data_kernel);
+	return pg_checksum_data_kernel;
+}
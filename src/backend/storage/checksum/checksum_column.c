@@ -17,6 +17,12 @@
  *    - Fixed-length pass-by-reference types
  *    - NULL values (returns special CHECKSUM_NULL value)
  *
+ * How a value is hashed depends only on its type's length and by-value
+ * property.  Callers that hash many values of the same column resolve those
+ * once into a ChecksumColumnInfo, from the tuple descriptor or the type
+ * cache, and pass it to pg_column_checksum_value() or
+ * pg_slot_column_checksums(); no catalog lookups happen per value.
+ *
  * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
  *
@@ -28,46 +34,617 @@
 
 #include "postgres.h"
 
+#include "access/detoast.h"
+#include "access/heaptoast.h"
 #include "access/htup_details.h"
 #include "access/sysattr.h"
+#include "access/table.h"
+#include "access/tableam.h"
+#include "access/toast_compression.h"
 #include "catalog/pg_type.h"
+#include "executor/tuptable.h"
+#include "miscadmin.h"
+#include "port/pg_bswap.h"
 #include "utils/builtins.h"
+#include "utils/memutils.h"
 #include "utils/rel.h"
-#include "utils/syscache.h"
+#include "utils/typcache.h"
 #include "storage/checksum.h"
 #include "storage/checksum_column.h"
+#include "storage/checksum_scan.h"
 
 /*
- * pg_column_checksum_internal
+ * pg_column_checksum_info_init
+ *    Resolve the type properties needed to hash values of type typid.
+ *
+ * Parameters:
+ *    info:     Filled in by this function
+ *    typid:    OID of the column's data type
+ *    attnum:   Attribute number (1-indexed) mixed into the checksums
+ *
+ * Notes:
+ *    - The properties are taken from the type cache, so repeated calls for
+ *      the same type don't go to the catalogs
+ */
+void
+pg_column_checksum_info_init(ChecksumColumnInfo *info, Oid typid, int attnum)
+{
+    TypeCacheEntry *typentry = lookup_type_cache(typid, 0);
+
+    info->attnum = attnum;
+    info->position = attnum;
+    info->typid = typid;
+    info->typlen = typentry->typlen;
+    info->typbyval = typentry->typbyval;
+}
+
+/*
+ * pg_column_checksum_info_from_desc
+ *    Resolve the type properties needed to hash values of attribute attnum
+ *    of tupleDesc.
+ *
+ * Parameters:
+ *    info:      Filled in by this function
+ *    tupleDesc: Tuple descriptor the values come from
+ *    attnum:    Attribute number (1-indexed) of the column
+ *
+ * Notes:
+ *    - Length and by-value property come from the descriptor's
+ *      CompactAttribute, so no lookup is needed at all
+ */
+void
+pg_column_checksum_info_from_desc(ChecksumColumnInfo *info,
+                                  TupleDesc tupleDesc, int attnum)
+{
+    CompactAttribute *cattr;
+
+    if (attnum <= 0 || attnum > tupleDesc->natts)
+        elog(ERROR, "invalid attribute number %d", attnum);
+
+    cattr = TupleDescCompactAttr(tupleDesc, attnum - 1);
+    if (cattr->attisdropped)
+        elog(ERROR, "cannot checksum dropped attribute %d", attnum);
+
+    info->attnum = attnum;
+    info->position = attnum;
+    info->typid = TupleDescAttr(tupleDesc, attnum - 1)->atttypid;
+    info->typlen = cattr->attlen;
+    info->typbyval = cattr->attbyval;
+}
+
+/*
+ * pg_column_checksum_content_info
+ *    Resolve the type properties of all columns of tupleDesc for a
+ *    content-only row checksum.
+ *
+ * Parameters:
+ *    tupleDesc: Tuple descriptor of the table
+ *    ncols:     Receives the number of columns returned
+ *
+ * Returns:
+ *    palloc'd array with one entry per column that has not been dropped,
+ *    in attribute number order
+ *
+ * Notes:
+ *    - The columns are numbered 1..ncols, skipping dropped ones, and it is
+ *      that number rather than the attribute number that is mixed into the
+ *      checksums.  A copy of the table made by logical replication or a
+ *      dump, which has no dropped columns, hashes the same way.
+ */
+ChecksumColumnInfo *
+pg_column_checksum_content_info(TupleDesc tupleDesc, int *ncols)
+{
+    ChecksumColumnInfo *cols = palloc_array(ChecksumColumnInfo,
+                                            Max(tupleDesc->natts, 1));
+    int         n = 0;
+
+    for (int attnum = 1; attnum <= tupleDesc->natts; attnum++)
+    {
+        if (TupleDescCompactAttr(tupleDesc, attnum - 1)->attisdropped)
+            continue;
+
+        pg_column_checksum_info_from_desc(&cols[n], tupleDesc, attnum);
+        cols[n].position = n + 1;
+        n++;
+    }
+
+    *ncols = n;
+    return cols;
+}
+
+/*
+ * Number of bytes of an out-of-line value that checksum_varlena() fetches
+ * from the TOAST relation at a time.  A multiple of TOAST_MAX_CHUNK_SIZE, so
+ * that each slice covers whole chunks.  Decompressed data is also hashed in
+ * pieces of this size.
+ */
+#define CHECKSUM_TOAST_SLICE_SIZE   (64 * TOAST_MAX_CHUNK_SIZE)
+
+/*
+ * Largest distance a back-reference can reach into the data already
+ * decompressed, for pglz (a 12-bit offset) and LZ4 (a 16-bit offset)
+ */
+#define CHECKSUM_PGLZ_HISTORY   4095
+#define CHECKSUM_LZ4_HISTORY    65535
+
+/*
+ * Compressed data being decompressed by checksum_decompress().  The bytes
+ * are either all in memory (a compressed inline value) or fetched from the
+ * TOAST relation one slice at a time.
+ */
+typedef struct ChecksumCompressedReader
+{
+    const unsigned char *ptr;   /* next byte to decompress */
+    const unsigned char *end;   /* end of the bytes available */
+    Relation    toastrel;       /* TOAST relation, or NULL if all in memory */
+    Oid         valueid;        /* TOAST value to fetch */
+    int32       extsize;        /* stored size of the value */
+    int32       fetched;        /* bytes of it fetched so far */
+    struct varlena *slice;      /* buffer holding the last slice fetched */
+} ChecksumCompressedReader;
+
+/*
+ * Decompressed data on its way into the checksum.  buf holds the last
+ * history bytes already hashed, which back-references may copy from,
+ * followed by up to CHECKSUM_TOAST_SLICE_SIZE bytes not hashed yet.
+ */
+typedef struct ChecksumDecompressWindow
+{
+    pg_logical_checksum_context ctx;
+    unsigned char *buf;
+    int32       history;        /* bytes kept for back-references */
+    int32       size;           /* allocated size of buf */
+    int32       pos;            /* bytes of buf in use */
+    int32       total;          /* bytes decompressed so far */
+    int32       rawsize;        /* decompressed size of the value */
+} ChecksumDecompressWindow;
+
+pg_noreturn static void
+checksum_compressed_corrupted(void)
+{
+    ereport(ERROR,
+            (errcode(ERRCODE_DATA_CORRUPTED),
+             errmsg_internal("compressed data is corrupted")));
+}
+
+/*
+ * checksum_reader_fill
+ *    Make more compressed bytes available, fetching the next slice of the
+ *    value from the TOAST relation.  Returns false at the end of the data.
+ */
+static bool
+checksum_reader_fill(ChecksumCompressedReader *reader)
+{
+    int32       length;
+
+    if (reader->toastrel == NULL || reader->fetched >= reader->extsize)
+        return false;
+
+    CHECK_FOR_INTERRUPTS();
+
+    length = Min(CHECKSUM_TOAST_SLICE_SIZE,
+                 reader->extsize - reader->fetched);
+    table_relation_fetch_toast_slice(reader->toastrel, reader->valueid,
+                                     reader->extsize, reader->fetched, length,
+                                     reader->slice);
+    reader->ptr = (unsigned char *) VARDATA(reader->slice);
+    reader->end = reader->ptr + length;
+
+    /* The stored value starts with va_tcinfo, which isn't compressed data */
+    if (reader->fetched == 0)
+        reader->ptr += sizeof(int32);
+    reader->fetched += length;
+
+    return reader->ptr < reader->end || checksum_reader_fill(reader);
+}
+
+static inline bool
+checksum_reader_eof(ChecksumCompressedReader *reader)
+{
+    return reader->ptr >= reader->end && !checksum_reader_fill(reader);
+}
+
+static inline unsigned char
+checksum_reader_byte(ChecksumCompressedReader *reader)
+{
+    if (checksum_reader_eof(reader))
+        checksum_compressed_corrupted();
+    return *reader->ptr++;
+}
+
+/*
+ * checksum_window_flush
+ *    Hash the decompressed bytes that no back-reference can reach any more,
+ *    keeping the last history bytes at the start of the window.
+ */
+static void
+checksum_window_flush(ChecksumDecompressWindow *window)
+{
+    int32       keep = Min(window->pos, window->history);
+
+    pg_logical_checksum_update(&window->ctx, (char *) window->buf,
+                               window->pos - keep);
+    memmove(window->buf, window->buf + window->pos - keep, keep);
+    window->pos = keep;
+}
+
+static inline void
+checksum_window_byte(ChecksumDecompressWindow *window, unsigned char c)
+{
+    if (window->pos == window->size)
+        checksum_window_flush(window);
+    window->buf[window->pos++] = c;
+    window->total++;
+}
+
+/*
+ * checksum_window_literal
+ *    Append len bytes from the compressed data to the decompressed data.
+ */
+static void
+checksum_window_literal(ChecksumDecompressWindow *window,
+                        ChecksumCompressedReader *reader, int32 len)
+{
+    if (len > window->rawsize - window->total)
+        checksum_compressed_corrupted();
+
+    while (len > 0)
+    {
+        int32       n;
+
+        if (window->pos == window->size)
+            checksum_window_flush(window);
+        if (checksum_reader_eof(reader))
+            checksum_compressed_corrupted();
+
+        n = Min(len, window->size - window->pos);
+        n = Min(n, reader->end - reader->ptr);
+        memcpy(window->buf + window->pos, reader->ptr, n);
+        reader->ptr += n;
+        window->pos += n;
+        window->total += n;
+        len -= n;
+    }
+}
+
+/*
+ * checksum_window_match
+ *    Append len bytes copied from off bytes back in the decompressed data.
+ *    The source and destination may overlap, repeating the last off bytes.
+ */
+static void
+checksum_window_match(ChecksumDecompressWindow *window, int32 off, int32 len)
+{
+    if (off <= 0 || off > Min(window->total, window->history))
+        checksum_compressed_corrupted();
+
+    while (len > 0)
+    {
+        unsigned char *dp;
+        int32       n;
+
+        if (window->pos == window->size)
+            checksum_window_flush(window);
+
+        n = Min(len, window->size - window->pos);
+        dp = window->buf + window->pos;
+        for (int32 i = 0; i < n; i++)
+            dp[i] = dp[i - off];
+        window->pos += n;
+        window->total += n;
+        len -= n;
+    }
+}
+
+/*
+ * checksum_decompress_pglz
+ *    Decompress pglz data into the window, with the same checks as
+ *    pglz_decompress() makes when asked to check that the data is complete.
+ */
+static void
+checksum_decompress_pglz(ChecksumDecompressWindow *window,
+                         ChecksumCompressedReader *reader)
+{
+    while (window->total < window->rawsize && !checksum_reader_eof(reader))
+    {
+        unsigned char ctrl = checksum_reader_byte(reader);
+
+        for (int ctrlc = 0; ctrlc < 8; ctrlc++, ctrl >>= 1)
+        {
+            if (window->total >= window->rawsize ||
+                checksum_reader_eof(reader))
+                break;
+
+            if (ctrl & 1)
+            {
+                /*
+                 * A tag: 4 bits of length - 3, 12 bits of offset, and an
+                 * extra length byte if the length bits are all set
+                 */
+                unsigned char b0 = checksum_reader_byte(reader);
+                unsigned char b1 = checksum_reader_byte(reader);
+                int32       len = (b0 & 0x0f) + 3;
+                int32       off = ((b0 & 0xf0) << 4) | b1;
+
+                if (len == 18)
+                    len += checksum_reader_byte(reader);
+
+                /* As pglz_decompress(), stop at the end of the output */
+                len = Min(len, window->rawsize - window->total);
+                checksum_window_match(window, off, len);
+            }
+            else
+                checksum_window_byte(window, checksum_reader_byte(reader));
+        }
+    }
+}
+
+/*
+ * checksum_lz4_length
+ *    Read the extension bytes of an LZ4 literal or match length.
+ */
+static int32
+checksum_lz4_length(ChecksumCompressedReader *reader, int32 len)
+{
+    unsigned char b;
+
+    do
+    {
+        b = checksum_reader_byte(reader);
+        if (len > PG_INT32_MAX - 255)
+            checksum_compressed_corrupted();
+        len += b;
+    } while (b == 255);
+
+    return len;
+}
+
+/*
+ * checksum_decompress_lz4
+ *    Decompress an LZ4 block into the window, with the same checks as
+ *    LZ4_decompress_safe() makes.  Implemented here rather than with
+ *    liblz4's streaming decoder, so that it works without a build
+ *    dependency and uses the same window as pglz.
+ */
+static void
+checksum_decompress_lz4(ChecksumDecompressWindow *window,
+                        ChecksumCompressedReader *reader)
+{
+    for (;;)
+    {
+        unsigned char token = checksum_reader_byte(reader);
+        int32       len = token >> 4;
+        int32       off;
+
+        /* Literals */
+        if (len == 15)
+            len = checksum_lz4_length(reader, len);
+        checksum_window_literal(window, reader, len);
+
+        /* The last sequence of a block has no match */
+        if (checksum_reader_eof(reader))
+            break;
+
+        /* Match, at least 4 bytes long */
+        off = checksum_reader_byte(reader);
+        off |= checksum_reader_byte(reader) << 8;
+        len = token & 0x0f;
+        if (len == 15)
+            len = checksum_lz4_length(reader, len);
+        len += 4;
+        if (len > window->rawsize - window->total)
+            checksum_compressed_corrupted();
+        checksum_window_match(window, off, len);
+    }
+}
+
+/*
+ * checksum_decompress
+ *    Compute pg_checksum_data() of the detoasted form of a compressed
+ *    value, decompressing it incrementally.
+ *
+ * Parameters:
+ *    attr:       Compressed inline value, or pointer to a compressed
+ *                out-of-line value
+ *    init_value: Initial value of the checksum
+ *
+ * Notes:
+ *    - Only the last CHECKSUM_PGLZ_HISTORY or CHECKSUM_LZ4_HISTORY bytes of
+ *      decompressed data are kept, as that is as far back as the next bytes
+ *      can refer to
+ *    - Corrupt compressed data raises the same error as detoasting it
+ */
+static uint32
+checksum_decompress(struct varlena *attr, uint32 init_value)
+{
+    ChecksumCompressedReader reader = {0};
+    ChecksumDecompressWindow window;
+    ToastCompressionId cmid;
+    varattrib_4b header;
+
+    if (VARATT_IS_EXTERNAL_ONDISK(attr))
+    {
+        struct varatt_external toast_pointer;
+
+        VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+        cmid = VARATT_EXTERNAL_GET_COMPRESS_METHOD(toast_pointer);
+        window.rawsize = toast_pointer.va_rawsize - VARHDRSZ;
+
+        reader.toastrel = table_open(toast_pointer.va_toastrelid,
+                                     AccessShareLock);
+        reader.valueid = toast_pointer.va_valueid;
+        reader.extsize = VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer);
+        reader.slice = palloc(CHECKSUM_TOAST_SLICE_SIZE + VARHDRSZ);
+    }
+    else
+    {
+        cmid = VARDATA_COMPRESSED_GET_COMPRESS_METHOD(attr);
+        window.rawsize = VARDATA_COMPRESSED_GET_EXTSIZE(attr);
+
+        reader.ptr = (unsigned char *) attr + VARHDRSZ_COMPRESSED;
+        reader.end = (unsigned char *) attr + VARSIZE(attr);
+    }
+
+    switch (cmid)
+    {
+        case TOAST_PGLZ_COMPRESSION_ID:
+            window.history = CHECKSUM_PGLZ_HISTORY;
+            break;
+        case TOAST_LZ4_COMPRESSION_ID:
+            window.history = CHECKSUM_LZ4_HISTORY;
+            break;
+        default:
+            elog(ERROR, "invalid compression method id %d", cmid);
+    }
+
+    window.size = window.history + CHECKSUM_TOAST_SLICE_SIZE;
+    window.buf = palloc(window.size);
+    window.pos = 0;
+    window.total = 0;
+
+    SET_VARSIZE(&header, window.rawsize + VARHDRSZ);
+    pg_logical_checksum_init(&window.ctx, init_value);
+    pg_logical_checksum_update(&window.ctx, (char *) &header, VARHDRSZ);
+
+    if (cmid == TOAST_PGLZ_COMPRESSION_ID)
+        checksum_decompress_pglz(&window, &reader);
+    else
+        checksum_decompress_lz4(&window, &reader);
+
+    /* All of the compressed data must have produced exactly rawsize bytes */
+    if (window.total != window.rawsize || !checksum_reader_eof(&reader))
+        checksum_compressed_corrupted();
+
+    pg_logical_checksum_update(&window.ctx, (char *) window.buf, window.pos);
+
+    if (reader.toastrel != NULL)
+    {
+        table_close(reader.toastrel, AccessShareLock);
+        pfree(reader.slice);
+    }
+    pfree(window.buf);
+
+    return pg_logical_checksum_final(&window.ctx);
+}
+
+/*
+ * checksum_varlena
+ *    Compute pg_checksum_data() of the detoasted form of a varlena value,
+ *    i.e. of a 4-byte header followed by its uncompressed data.
+ *
+ * Notes:
+ *    - Plain inline values are hashed in place
+ *    - Short-header values are hashed as the header they would have when
+ *      detoasted, followed by their data in place, without a copy
+ *    - Uncompressed out-of-line values are fetched and hashed one slice of
+ *      CHECKSUM_TOAST_SLICE_SIZE bytes at a time
+ *    - Compressed values, inline or out of line, are decompressed
+ *      incrementally by checksum_decompress(), reading the compressed data
+ *      a slice at a time
+ *    - In-memory (indirect or expanded) values are detoasted first
+ *
+ * The memory used is therefore bounded by CHECKSUM_TOAST_SLICE_SIZE plus the
+ * compression method's history for any value stored on disk, however large.
+ */
+static uint32
+checksum_varlena(Datum value, uint32 init_value)
+{
+    struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+    struct varlena *detoasted;
+    pg_logical_checksum_context ctx;
+    varattrib_4b header;
+    uint32      checksum;
+
+    /* A plain inline value is already in its detoasted form */
+    if (VARATT_IS_4B_U(attr))
+        return pg_checksum_data((char *) attr, VARSIZE(attr), init_value);
+
+    if (VARATT_IS_4B_C(attr))
+        return checksum_decompress(attr, init_value);
+
+    if (VARATT_IS_EXTERNAL_ONDISK(attr))
+    {
+        struct varatt_external toast_pointer;
+        int32       size;
+
+        VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+        if (VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer))
+            return checksum_decompress(attr, init_value);
+
+        size = VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer);
+
+        SET_VARSIZE(&header, size + VARHDRSZ);
+        pg_logical_checksum_init(&ctx, init_value);
+        pg_logical_checksum_update(&ctx, (char *) &header, VARHDRSZ);
+
+        for (int32 offset = 0; offset < size;
+             offset += CHECKSUM_TOAST_SLICE_SIZE)
+        {
+            struct varlena *slice;
+
+            CHECK_FOR_INTERRUPTS();
+
+            slice = detoast_attr_slice(attr, offset,
+                                       Min(CHECKSUM_TOAST_SLICE_SIZE,
+                                           size - offset));
+            pg_logical_checksum_update(&ctx, VARDATA(slice),
+                                       VARSIZE(slice) - VARHDRSZ);
+            pfree(slice);
+        }
+
+        return pg_logical_checksum_final(&ctx);
+    }
+    else if (VARATT_IS_SHORT(attr) && !VARATT_IS_EXTERNAL(attr))
+    {
+        SET_VARSIZE(&header, VARSIZE_SHORT(attr) - VARHDRSZ_SHORT + VARHDRSZ);
+        pg_logical_checksum_init(&ctx, init_value);
+        pg_logical_checksum_update(&ctx, (char *) &header, VARHDRSZ);
+        pg_logical_checksum_update(&ctx, VARDATA_SHORT(attr),
+                                   VARSIZE_SHORT(attr) - VARHDRSZ_SHORT);
+
+        return pg_logical_checksum_final(&ctx);
+    }
+
+    /* An in-memory value; detoasting it may involve decompression */
+    detoasted = PG_DETOAST_DATUM(value);
+    checksum = pg_checksum_data((char *) detoasted, VARSIZE(detoasted),
+                                init_value);
+    if (detoasted != attr)
+        pfree(detoasted);
+
+    return checksum;
+}
+
+/*
+ * pg_column_checksum_value
  *    Compute a 32-bit checksum for a single column value.
  *
  * This function calculates a checksum for an individual column value,
- * taking into account the data type and storage characteristics. NULL
+ * taking into account the storage characteristics of its type. NULL
  * values return the special CHECKSUM_NULL value (0xFFFFFFFF).
  *
  * Parameters:
+ *    info:     Type properties of the column, see
+ *              pg_column_checksum_info_init()
  *    value:    The column value as a Datum
  *    isnull:   Whether the value is NULL
- *    typid:    OID of the column's data type
- *    typmod:   Type modifier (for varlena types)
- *    attnum:   Attribute number (1-indexed) for uniqueness
  *
  * Returns:
  *    32-bit checksum, or CHECKSUM_NULL (0xFFFFFFFF) for NULL values
  *
  * Notes:
  *    - For pass-by-value types, the actual value bytes are checksummed
- *    - For varlena types, the toast pointer is dereferenced first
+ *    - For varlena types, the detoasted value is checksummed; large
+ *      out-of-line values are streamed and compressed ones decompressed
+ *      incrementally, see checksum_varlena()
  *    - For cstring types, the null-terminated string is checksummed
- *    - The attribute number is incorporated to differentiate columns
+ *    - The column's position is incorporated to differentiate columns
  *    - We guarantee non-NULL values never return CHECKSUM_NULL
  */
 uint32
-pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
-                            int32 typmod, int attnum)
+pg_column_checksum_value(const ChecksumColumnInfo *info, Datum value,
+                         bool isnull)
 {
-    Form_pg_type typeForm;
-    HeapTuple   typeTuple;
     char       *data;
     int         len;
     uint32      checksum;
@@ -77,20 +654,13 @@ pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
         return CHECKSUM_NULL;
 
     /*
-     * Look up type information to determine how to handle this value.
      * PostgreSQL supports multiple storage strategies:
      *    - typbyval: Pass-by-value types (int4, float8, etc.)
      *    - typlen = -1: Variable-length types (text, bytea, arrays)
      *    - typlen = -2: C string types
      *    - typlen > 0: Fixed-length pass-by-reference types
      */
-    typeTuple = SearchSysCache1(TYPEOID, ObjectIdGetDatum(typid));
-    if (!HeapTupleIsValid(typeTuple))
-        elog(ERROR, "cache lookup failed for type %u", typid);
-    
-    typeForm = (Form_pg_type) GETSTRUCT(typeTuple);
-
-    if (typeForm->typbyval && typeForm->typlen > 0)
+    if (info->typbyval && info->typlen > 0)
     {
         /*
          * Fixed-length pass-by-value type (e.g., int4, float8).
@@ -98,31 +668,21 @@ pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
          * the bytes of the Datum itself.
          */
         data = (char *) &value;
-        len = typeForm->typlen;
-        checksum = pg_checksum_data(data, len, attnum);
+        len = info->typlen;
+        checksum = pg_checksum_data(data, len, info->position);
     }
-    else if (typeForm->typlen == -1)
+    else if (info->typlen == -1)
     {
         /*
          * Variable-length type (varlena). These types have a header
-         * that includes length information. We must detoast if the
-         * value has been toasted (compressed or out-of-line).
+         * that includes length information. We hash the value as if
+         * it had been detoasted (decompressed, fetched from out of
+         * line and given a 4-byte header), but avoid materializing it
+         * where we can.
          */
-        struct varlena *varlena;
-        
-        /* Detoast if necessary - this may involve decompression */
-        varlena = PG_DETOAST_DATUM(value);
-        
-        data = (char *) varlena;
-        len = VARSIZE_ANY(varlena);  /* Get actual length including header */
-        
-        checksum = pg_checksum_data(data, len, attnum);
-        
-        /* Free the detoasted copy if we created one */
-        if (varlena != (struct varlena *) DatumGetPointer(value))
-            pfree(varlena);
+        checksum = checksum_varlena(value, info->position);
     }
-    else if (typeForm->typlen == -2)
+    else if (info->typlen == -2)
     {
         /*
          * C string type. These are null-terminated strings stored
@@ -130,7 +690,7 @@ pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
          */
         data = DatumGetCString(value);
         len = strlen(data);
-        checksum = pg_checksum_data(data, len, attnum);
+        checksum = pg_checksum_data(data, len, info->position);
     }
     else
     {
@@ -139,16 +699,14 @@ pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
          * These are stored as pointers to fixed-size buffers.
          */
         data = DatumGetPointer(value);
-        len = typeForm->typlen;
+        len = info->typlen;
         
         if (data == NULL)
             elog(ERROR, "invalid pointer for fixed-length reference type");
             
-        checksum = pg_checksum_data(data, len, attnum);
+        checksum = pg_checksum_data(data, len, info->position);
     }
 
-    ReleaseSysCache(typeTuple);
-    
     /*
      * IMPORTANT: Guarantee that non-NULL values never return CHECKSUM_NULL.
      * This prevents collisions between NULL and non-NULL values that might
@@ -157,18 +715,321 @@ pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
      */
     if (checksum == CHECKSUM_NULL)
     {
-        checksum = (CHECKSUM_NULL ^ attnum ^ typid) & 0xFFFFFFFE;
+        checksum = (CHECKSUM_NULL ^ info->position ^ info->typid) & 0xFFFFFFFE;
     }
     
     return checksum;
 }
 
+/*
+ * pg_column_checksum_internal
+ *    Compute a 32-bit checksum for a single column value of type typid.
+ *
+ * Parameters:
+ *    value:    The column value as a Datum
+ *    isnull:   Whether the value is NULL
+ *    typid:    OID of the column's data type
+ *    typmod:   Type modifier (currently unused)
+ *    attnum:   Attribute number (1-indexed) for uniqueness
+ *
+ * Returns:
+ *    Same as pg_column_checksum_value()
+ *
+ * Notes:
+ *    - Resolves the type through the type cache on every call; callers
+ *      hashing many values should build a ChecksumColumnInfo once instead
+ */
+uint32
+pg_column_checksum_internal(Datum value, bool isnull, Oid typid,
+                            int32 typmod, int attnum)
+{
+    ChecksumColumnInfo info;
+
+    if (isnull)
+        return CHECKSUM_NULL;
+
+    pg_column_checksum_info_init(&info, typid, attnum);
+
+    return pg_column_checksum_value(&info, value, false);
+}
+
+/*
+ * pg_slot_column_checksums
+ *    Compute the checksums of several columns of a tuple slot.
+ *
+ * Parameters:
+ *    slot:      Slot holding the tuple
+ *    cols:      Type properties of the ncols columns to hash, built with
+ *               pg_column_checksum_info_from_desc() on the slot's descriptor
+ *    ncols:     Number of columns
+ *    checksums: Receives the ncols checksums, in the order of cols
+ *
+ * Notes:
+ *    - The slot is deformed once, up to the highest requested attribute,
+ *      and the values are hashed straight from tts_values/tts_isnull
+ */
+void
+pg_slot_column_checksums(TupleTableSlot *slot, const ChecksumColumnInfo *cols,
+                         int ncols, uint32 *checksums)
+{
+    int         maxattnum = 0;
+
+    for (int i = 0; i < ncols; i++)
+    {
+        if (cols[i].attnum <= 0 ||
+            cols[i].attnum > slot->tts_tupleDescriptor->natts)
+            elog(ERROR, "invalid attribute number %d", cols[i].attnum);
+        maxattnum = Max(maxattnum, cols[i].attnum);
+    }
+
+    slot_getsomeattrs(slot, maxattnum);
+
+    for (int i = 0; i < ncols; i++)
+    {
+        int         off = cols[i].attnum - 1;
+
+        checksums[i] = pg_column_checksum_value(&cols[i],
+                                                slot->tts_values[off],
+                                                slot->tts_isnull[off]);
+    }
+}
+
+/*
+ * pg_slot_columns_checksum
+ *    Compute a 64-bit checksum over several columns of a tuple slot.
+ *
+ * Parameters:
+ *    slot:      Slot holding the tuple
+ *    cols:      Type properties of the ncols columns, as for
+ *               pg_slot_column_checksums()
+ *    ncols:     Number of columns
+ *    buf:       Scratch space for ncols checksums
+ *
+ * Returns:
+ *    64-bit hash of the column checksums, in the order of cols
+ *
+ * Notes:
+ *    - The column checksums are hashed in network byte order, so the result
+ *      doesn't depend on the platform
+ *    - Unlike XOR-ing them, hashing the column checksums keeps two NULL
+ *      columns (which both checksum to CHECKSUM_NULL) from cancelling out
+ */
+uint64
+pg_slot_columns_checksum(TupleTableSlot *slot, const ChecksumColumnInfo *cols,
+                         int ncols, uint32 *buf)
+{
+    pg_slot_column_checksums(slot, cols, ncols, buf);
+
+    for (int i = 0; i < ncols; i++)
+        buf[i] = pg_hton32(buf[i]);
+
+    return pg_checksum_data64((const char *) buf, ncols * sizeof(uint32), 0);
+}
+
+/*
+ * State of a column checksum scan, passed to checksum_columns_page() and
+ * checksum_columns_release()
+ */
+typedef struct ChecksumColumnsState
+{
+    Oid         relid;
+    TupleTableSlot *slot;
+    const ChecksumColumnInfo *cols;
+    int         ncols;
+    uint32     *buf;
+    checksum_row_callback callback;
+    void       *arg;
+    MemoryContext pagecxt;      /* holds the tuples copied from one page */
+    int         ntuples;        /* number of entries in tuples */
+    HeapTuple   tuples[MaxHeapTuplesPerPage];
+} ChecksumColumnsState;
+
+/*
+ * checksum_columns_page
+ *    Copy the visible tuples of one heap page.
+ *
+ * Hashing the columns may detoast them, and the row callback may write to a
+ * tuplestore, neither of which should be done with the page share-locked, so
+ * that is left to checksum_columns_release().
+ */
+static void
+checksum_columns_page(Page page, BlockNumber blkno,
+                      const OffsetNumber *offsets, int noffsets, void *arg)
+{
+    ChecksumColumnsState *state = (ChecksumColumnsState *) arg;
+    MemoryContext oldcxt = MemoryContextSwitchTo(state->pagecxt);
+
+    for (int i = 0; i < noffsets; i++)
+    {
+        ItemId      itemId = PageGetItemId(page, offsets[i]);
+        HeapTupleData tuple;
+
+        tuple.t_data = (HeapTupleHeader) PageGetItem(page, itemId);
+        tuple.t_len = ItemIdGetLength(itemId);
+        tuple.t_tableOid = state->relid;
+        ItemPointerSet(&tuple.t_self, blkno, offsets[i]);
+
+        state->tuples[i] = heap_copytuple(&tuple);
+    }
+    state->ntuples = noffsets;
+
+    MemoryContextSwitchTo(oldcxt);
+}
+
+/*
+ * checksum_columns_release
+ *    Compute the row checksums of the tuples copied by
+ *    checksum_columns_page(), once the page has been released.
+ */
+static void
+checksum_columns_release(void *arg)
+{
+    ChecksumColumnsState *state = (ChecksumColumnsState *) arg;
+    MemoryContext oldcxt = MemoryContextSwitchTo(state->pagecxt);
+
+    for (int i = 0; i < state->ntuples; i++)
+    {
+        HeapTuple   tuple = state->tuples[i];
+        uint64      checksum;
+
+        ExecStoreHeapTuple(tuple, state->slot, false);
+        checksum = pg_slot_columns_checksum(state->slot, state->cols,
+                                            state->ncols, state->buf);
+        ExecClearTuple(state->slot);
+
+        state->callback(&tuple->t_self, checksum, state->arg);
+    }
+    state->ntuples = 0;
+
+    MemoryContextSwitchTo(oldcxt);
+
+    /* Also frees whatever detoasting the values left behind */
+    MemoryContextReset(state->pagecxt);
+}
+
+/*
+ * checksum_columns_scan
+ *    Call callback with the checksum of columns cols for every tuple of rel
+ *    visible to snapshot.
+ */
+static void
+checksum_columns_scan(Relation rel, Snapshot snapshot,
+                      const ChecksumColumnInfo *cols, int ncols,
+                      checksum_row_callback callback, void *arg)
+{
+    ChecksumColumnsState *state;
+
+    state = palloc_object(ChecksumColumnsState);
+    state->relid = RelationGetRelid(rel);
+    state->slot = MakeSingleTupleTableSlot(RelationGetDescr(rel),
+                                           &TTSOpsHeapTuple);
+    state->cols = cols;
+    state->ncols = ncols;
+    state->buf = palloc_array(uint32, Max(ncols, 1));
+    state->callback = callback;
+    state->arg = arg;
+    state->pagecxt = AllocSetContextCreate(CurrentMemoryContext,
+                                           "checksum columns page",
+                                           ALLOCSET_DEFAULT_SIZES);
+    state->ntuples = 0;
+
+    pg_checksum_heap_scan_range_ext(rel, snapshot, 0, InvalidBlockNumber,
+                                    checksum_columns_page,
+                                    checksum_columns_release, state);
+
+    ExecDropSingleTupleTableSlot(state->slot);
+    MemoryContextDelete(state->pagecxt);
+    pfree(state->buf);
+    pfree(state);
+}
+
+/*
+ * pg_checksum_columns_scan
+ *    Compute the checksum of a set of columns for every tuple of a table.
+ *
+ * Parameters:
+ *    rel:       Heap relation, opened and locked by the caller
+ *    snapshot:  Snapshot that decides which tuples are visible
+ *    attnums:   Attribute numbers (1-indexed) of the nattnums columns to
+ *               hash; a column may be listed more than once
+ *    nattnums:  Number of columns, at least one
+ *    callback:  Called with the TID and row checksum of every visible tuple
+ *    arg:       Passed through to callback
+ *
+ * Notes:
+ *    - The table is read in a single pass with pg_checksum_heap_scan()
+ *    - The type properties of the columns are resolved once, and every
+ *      tuple is deformed once, up to the highest requested attribute
+ *    - The row checksum is pg_slot_columns_checksum() of the columns, so it
+ *      depends only on the column values, not on the tuple's location
+ *    - The visible tuples of each page are copied, and only hashed and
+ *      passed to callback once the page has been released, so neither
+ *      detoasting nor callback runs with a buffer lock held
+ */
+void
+pg_checksum_columns_scan(Relation rel, Snapshot snapshot,
+                         const AttrNumber *attnums, int nattnums,
+                         checksum_row_callback callback, void *arg)
+{
+    TupleDesc   tupleDesc = RelationGetDescr(rel);
+    ChecksumColumnInfo *cols;
+
+    Assert(nattnums > 0);
+
+    cols = palloc_array(ChecksumColumnInfo, nattnums);
+    for (int i = 0; i < nattnums; i++)
+        pg_column_checksum_info_from_desc(&cols[i], tupleDesc, attnums[i]);
+
+    checksum_columns_scan(rel, snapshot, cols, nattnums, callback, arg);
+
+    pfree(cols);
+}
+
+/*
+ * pg_checksum_content_scan
+ *    Compute a content-only checksum of every tuple of a table.
+ *
+ * Parameters:
+ *    rel:       Heap relation, opened and locked by the caller
+ *    snapshot:  Snapshot that decides which tuples are visible
+ *    callback:  Called with the TID and row checksum of every visible tuple
+ *    arg:       Passed through to callback
+ *
+ * Notes:
+ *    - Unlike pg_tuple_checksum(), the row checksum covers neither the
+ *      tuple's location nor its header (xmin, xmax, infomask), only the
+ *      values of all columns that have not been dropped, hashed as by
+ *      pg_checksum_columns_scan() over pg_column_checksum_content_info()
+ *    - Values are hashed in canonical form: out-of-line and compressed
+ *      values are detoasted and short varlena headers expanded, so how a
+ *      value happens to be stored doesn't matter
+ *    - Large values are hashed a slice at a time, and compressed ones are
+ *      decompressed as they are hashed, so no value is ever held in memory
+ *      as a whole
+ *    - The checksum of a row is therefore the same after VACUUM FULL,
+ *      CLUSTER or a rewrite, and on a logical replica or restored dump of
+ *      the table, as long as the column types match
+ */
+void
+pg_checksum_content_scan(Relation rel, Snapshot snapshot,
+                         checksum_row_callback callback, void *arg)
+{
+    ChecksumColumnInfo *cols;
+    int         ncols;
+
+    cols = pg_column_checksum_content_info(RelationGetDescr(rel), &ncols);
+
+    checksum_columns_scan(rel, snapshot, cols, ncols, callback, arg);
+
+    pfree(cols);
+}
+
 /*
  * pg_tuple_column_checksum
  *    Compute checksum for a specific column in a heap tuple.
  *
  * This function extracts a column value from a heap tuple and computes
- * its checksum using pg_column_checksum_internal(). It handles the
+ * its checksum using pg_column_checksum_value(). It handles the
  * tuple descriptor lookup and value extraction.
  *
  * Parameters:
@@ -190,14 +1051,11 @@ pg_tuple_column_checksum(HeapTupleHeader tuple, int attnum,
 {
     bool        isnull;
     Datum       value;
-    Form_pg_attribute attr;
-    Oid         typid;
-    int32       typmod;
+    ChecksumColumnInfo info;
     HeapTupleData heapTuple;
 
-    /* Validate attribute number range */
-    if (attnum <= 0 || attnum > tupleDesc->natts)
-        elog(ERROR, "invalid attribute number %d", attnum);
+    /* Validates the attribute number */
+    pg_column_checksum_info_from_desc(&info, tupleDesc, attnum);
 
     /*
      * Create a temporary HeapTuple structure for heap_getattr.
@@ -210,12 +1068,7 @@ pg_tuple_column_checksum(HeapTupleHeader tuple, int attnum,
     heapTuple.t_self = *((ItemPointer) &tuple->t_ctid);
 
     /* Extract the attribute value */
-    attr = TupleDescAttr(tupleDesc, attnum - 1);
     value = heap_getattr(&heapTuple, attnum, tupleDesc, &isnull);
-    
-    typid = attr->atttypid;
-    typmod = attr->atttypmod;
 
-    /* Delegate to the internal column checksum function */
-    return pg_column_checksum_internal(value, isnull, typid, typmod, attnum);
-}
\ No newline at end of file
+    return pg_column_checksum_value(&info, value, isnull);
+}
@@ -11,12 +11,23 @@
  *    - Validating replication and migration processes
  *
  * The implementation scans all relations in the database, computing
- * checksums for each tuple/index entry and combining them using XOR.
+ * checksums for each tuple/index entry and combining them using XOR or a
+ * multiset sum (see ChecksumAggregate).
  * This approach provides several benefits:
  *    - Efficient: Processes data in bulk using sequential scans
  *    - Scalable: Handles large databases with minimal memory overhead
  *    - Flexible: Can include/exclude system catalogs and toast tables
  *
+ * The work is divided into items: whole relations, or block ranges of
+ * large ones.  Items are handed out largest first to the leader and up to
+ * max_parallel_maintenance_workers parallel workers, which share the
+ * leader's snapshot.  Since the per-tuple values are combined by a
+ * commutative operation, the result doesn't depend on how many workers took
+ * part or which of them processed which item.
+ *
+ * Each item also records its own checksum, counts and timing, from which a
+ * per-relation manifest can be assembled at the end without another pass.
+ *
  * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
  *
@@ -30,24 +41,71 @@
 
 #include "access/heapam.h"
 #include "access/genam.h"
+#include "access/parallel.h"
 #include "access/tableam.h"
 #include "access/transam.h"
 #include "catalog/index.h"
 #include "catalog/pg_class.h"
 #include "catalog/pg_namespace.h"
+#include "catalog/namespace.h"
 #include "commands/dbcommands.h"
+#include "executor/instrument.h"
+#include "portability/instr_time.h"
 #include "miscadmin.h"
 #include "nodes/memnodes.h"
+#include "pgstat.h"
 #include "storage/bufmgr.h"
 #include "storage/checksum_database.h"
 #include "storage/checksum_tuple.h"
 #include "storage/checksum_index.h"
+#include "storage/checksum_progress.h"
+#include "storage/checksum_scan.h"
+#include "storage/spin.h"
+#include "tcop/tcopprot.h"
 #include "utils/fmgroids.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/snapmgr.h"
 #include "utils/memutils.h"
 
+/*
+ * Relations estimated to be larger than this many blocks are split into
+ * block ranges of this size, so that one huge table doesn't end up being
+ * scanned by a single participant.
+ */
+#define DATABASE_CHECKSUM_SPLIT_BLOCKS 16384
+
+/* Magic numbers for parallel state sharing */
+#define PARALLEL_KEY_DATABASE_CHECKSUM  UINT64CONST(0xC5C0000000000011)
+#define PARALLEL_KEY_QUERY_TEXT         UINT64CONST(0xC5C0000000000012)
+#define PARALLEL_KEY_WAL_USAGE          UINT64CONST(0xC5C0000000000013)
+#define PARALLEL_KEY_BUFFER_USAGE       UINT64CONST(0xC5C0000000000014)
+
+/*
+ * DatabaseChecksumItem
+ *    One unit of work: blocks startblk up to endblk (exclusive) of a
+ *    relation.  endblk is InvalidBlockNumber for the range that extends to
+ *    the end of the relation, whatever its size is when it is processed.
+ *
+ * The result fields are written only by the participant that processed the
+ * item, and read by the leader once all participants are done.
+ */
+typedef struct DatabaseChecksumItem
+{
+    Oid         relid;
+    char        relkind;
+    BlockNumber startblk;
+    BlockNumber endblk;
+    BlockNumber est_blocks;     /* estimated size, for scheduling */
+
+    /* Results */
+    bool        done;           /* false if the relation was dropped */
+    uint64      checksum;
+    uint64      n_tuples;
+    uint64      n_pages;
+    double      elapsed_ms;
+} DatabaseChecksumItem;
+
 /*
  * DatabaseChecksumState
  *    State maintained during database checksum computation.
@@ -65,207 +123,548 @@ typedef struct DatabaseChecksumState
     char        current_relkind;   /* Relation kind (r = table, i = index, etc.) */
     bool        include_toast;     /* Whether to include toast tables */
     bool        include_system;    /* Whether to include system catalogs */
+    ChecksumAggregate aggregate;   /* How to combine the per-item values */
 } DatabaseChecksumState;
 
+/*
+ * DatabaseChecksumShared
+ *    Shared state of a parallel database checksum computation.
+ */
+typedef struct DatabaseChecksumShared
+{
+    /* Immutable state, set up by the leader */
+    ChecksumAggregate aggregate;
+    uint64      queryid;
+    bool        report_progress;    /* forward progress to the leader? */
+    int         nitems;
+
+    /* Index of the next item to hand out */
+    pg_atomic_uint32 next_item;
+
+    /* Combined results of the participants that are done */
+    slock_t     mutex;
+    uint64      checksum;
+    uint64      n_tuples;
+    uint64      n_pages;
+
+    /* Work items, largest first */
+    DatabaseChecksumItem items[FLEXIBLE_ARRAY_MEMBER];
+} DatabaseChecksumShared;
+
+/*
+ * Combine two partial database checksums.
+ */
+static inline uint64
+database_checksum_combine(ChecksumAggregate aggregate, uint64 a, uint64 b)
+{
+    if (aggregate == CHECKSUM_AGGREGATE_MULTISET)
+        return pg_checksum_multiset_add64(a, b);
+    return a ^ b;
+}
+
+/*
+ * Combine the checksum of one tuple or index entry of relation relid into
+ * the database checksum.  The relation OID is part of the value so that
+ * different relations contribute differently even if they have identical
+ * tuples.
+ */
+static inline void
+database_checksum_add(DatabaseChecksumState *state, uint32 item_checksum,
+                      Oid relid)
+{
+    uint64      value = ((uint64) item_checksum << 32) | (uint64) relid;
+
+    if (state->aggregate == CHECKSUM_AGGREGATE_MULTISET)
+        state->checksum =
+            pg_checksum_multiset_add64(state->checksum,
+                                       pg_checksum_multiset_element(value));
+    else
+        state->checksum ^= value;
+    state->n_tuples++;
+}
+
+/*
+ * process_index_entry_for_checksum
+ *    Incorporate the checksum of one index entry into the database checksum;
+ *    a checksum_index_entry_callback for pg_index_checksum_scan_range().
+ */
+static void
+process_index_entry_for_checksum(uint32 entry_checksum, void *arg)
+{
+    DatabaseChecksumState *state = (DatabaseChecksumState *) arg;
+
+    database_checksum_add(state, entry_checksum, state->current_relid);
+}
+
 /*
  * process_index_for_checksum
  *    Process an index relation by reading its pages directly.
  *
  * Indexes are processed differently from heap relations because:
  *    - They contain IndexTuples rather than HeapTuples
- *    - They may have different storage characteristics
+ *    - Only their leaf entries carry data; the rest is structure
  *    - They require direct page access for efficiency
  *
- * This function reads each page of the index, extracts all valid
- * index tuples, computes their checksums, and XORs them into the
- * database checksum.
+ * pg_index_checksum_scan_range() reads the pages of the index through a
+ * read stream and reports the checksum of each leaf entry, which is
+ * combined into the database checksum.
  *
  * Parameters:
  *    idxRel:   Index relation to process
+ *    startblk: First block to process
+ *    endblk:   Block to stop at (exclusive), or InvalidBlockNumber
  *    state:    Database checksum state (updated in place)
  */
 static void
-process_index_for_checksum(Relation idxRel, DatabaseChecksumState *state)
+process_index_for_checksum(Relation idxRel, BlockNumber startblk,
+                           BlockNumber endblk, DatabaseChecksumState *state)
 {
-    BlockNumber nblocks;
-    TupleDesc   tupdesc;
-    BufferAccessStrategy bstrategy;
-
-    /* Get the index's tuple descriptor for checksum computation */
-    tupdesc = RelationGetDescr(idxRel);
-    
-    /* Determine how many blocks we need to process */
-    nblocks = RelationGetNumberOfBlocks(idxRel);
-    
-    /*
-     * Use a bulk read buffer strategy for efficient sequential scanning.
-     * This reduces lock contention and improves I/O performance.
-     */
-    bstrategy = GetAccessStrategy(BAS_BULKREAD);
+    state->n_pages += pg_index_checksum_scan_range(idxRel, startblk, endblk,
+                                                   process_index_entry_for_checksum,
+                                                   state);
+}
 
-    /* Process each block in the index */
-    for (BlockNumber blkno = 0; blkno < nblocks; blkno++)
+/*
+ * process_heap_page_for_checksum
+ *    Incorporate the visible tuples of one heap page into the database
+ *    checksum; a checksum_page_callback for pg_checksum_heap_scan().
+ */
+static void
+process_heap_page_for_checksum(Page page, BlockNumber blkno,
+                               const OffsetNumber *offsets, int noffsets,
+                               void *arg)
+{
+    DatabaseChecksumState *state = (DatabaseChecksumState *) arg;
+
+    for (int i = 0; i < noffsets; i++)
     {
-        Buffer      buffer;
-        Page        page;
-        OffsetNumber maxoff;
-        
-        /* Read the buffer using our bulk read strategy */
-        buffer = ReadBufferExtended(idxRel, MAIN_FORKNUM, blkno,
-                                    RBM_NORMAL, bstrategy);
-        LockBuffer(buffer, BUFFER_LOCK_SHARE);
-        
-        page = BufferGetPage(buffer);
-        
-        /* Skip uninitialized (new) pages */
-        if (PageIsNew(page))
-        {
-            UnlockReleaseBuffer(buffer);
-            continue;
-        }
-        
-        /* Process all index tuples on this page */
-        maxoff = PageGetMaxOffsetNumber(page);
-        
-        for (OffsetNumber offnum = FirstOffsetNumber;
-             offnum <= maxoff;
-             offnum = OffsetNumberNext(offnum))
-        {
-            ItemId      itemId;
-            IndexTuple  itup;
-            
-            itemId = PageGetItemId(page, offnum);
-            
-            /* Skip unused or dead index entries */
-            if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
-                continue;
-                
-            itup = (IndexTuple) PageGetItem(page, itemId);
-            
-            if (itup)
-            {
-                uint32 idx_checksum;
-                
-                /* Compute checksum for this index tuple */
-                idx_checksum = pg_index_tuple_checksum(itup, tupdesc, offnum);
-                
-                /*
-                 * Incorporate the checksum into the database checksum.
-                 * We combine the tuple checksum with the relation OID
-                 * to ensure different relations contribute differently
-                 * even if they have identical tuples.
-                 */
-                state->checksum ^= ((uint64)idx_checksum << 32) | 
-                                   (uint64)idxRel->rd_id;
-                state->n_tuples++;
-            }
-        }
-        
-        UnlockReleaseBuffer(buffer);
-        state->n_pages++;
-        
-        /* Check for interrupts periodically to allow query cancellation */
-        if ((blkno & 63) == 0)
-            CHECK_FOR_INTERRUPTS();
+        /* Compute checksum for this tuple (excluding header) */
+        uint32      tuple_checksum = pg_tuple_checksum(page, offsets[i],
+                                                       blkno, false);
+
+        /* Incorporate tuple checksum into database checksum */
+        database_checksum_add(state, tuple_checksum, state->current_relid);
+    }
+}
+
+/*
+ * process_relation_range
+ *    Combine the tuples or index entries of blocks startblk up to endblk
+ *    (exclusive) of an open relation into the database checksum.
+ *
+ * state->current_relid must be set to the relation's OID.
+ */
+static void
+process_relation_range(Relation rel, BlockNumber startblk,
+                       BlockNumber endblk, DatabaseChecksumState *state)
+{
+    if (rel->rd_rel->relkind != RELKIND_INDEX)
+    {
+        /*
+         * Process heap relation a page at a time, hashing all tuples visible
+         * to the active snapshot while the page is locked.  Every block read
+         * counts as a page, like for indexes, whether or not it had visible
+         * tuples.
+         */
+        state->n_pages += pg_checksum_heap_scan_range(rel, GetActiveSnapshot(),
+                                                      startblk, endblk,
+                                                      process_heap_page_for_checksum,
+                                                      state);
+    }
+    else
+    {
+        /* Process index by reading pages directly */
+        process_index_for_checksum(rel, startblk, endblk, state);
     }
-    
-    FreeAccessStrategy(bstrategy);
 }
 
 /*
  * process_relation_for_checksum
- *    Process a single relation (table or index) for checksum computation.
+ *    Process one work item: a relation (table or index), or a block range
+ *    of one.
  *
  * This function handles both heap relations and indexes, delegating
  * to the appropriate processing function based on the relation type.
  *
  * Parameters:
- *    relid:   OID of the relation to process
+ *    item:    Relation and block range to process
  *    state:   Database checksum state (updated in place)
+ *
+ * Returns:
+ *    false if the relation no longer exists, true otherwise
  */
-static void
-process_relation_for_checksum(Oid relid, DatabaseChecksumState *state)
+static bool
+process_relation_for_checksum(const DatabaseChecksumItem *item,
+                              DatabaseChecksumState *state)
 {
     Relation    rel;
-    TableScanDesc scan;
-    HeapTuple   tuple;
-    Snapshot    snapshot;
     bool        is_index;
 
-    /* Open the relation with minimal locking (AccessShareLock) */
-    rel = relation_open(relid, AccessShareLock);
-    
     /*
-     * Filter relations we don't want to process:
-     *   - Only regular tables, indexes, materialized views, sequences, and toast
-     *   - Skip other relation kinds (views, foreign tables, etc.)
+     * Open the relation with minimal locking (AccessShareLock).  It may have
+     * been dropped since we listed it; then there's nothing left to read.
      */
-    if (rel->rd_rel->relkind != RELKIND_RELATION &&
-        rel->rd_rel->relkind != RELKIND_INDEX &&
-        rel->rd_rel->relkind != RELKIND_MATVIEW &&
-        rel->rd_rel->relkind != RELKIND_SEQUENCE &&
-        rel->rd_rel->relkind != RELKIND_TOASTVALUE)
-    {
-        relation_close(rel, AccessShareLock);
-        return;
-    }
+    rel = try_relation_open(item->relid, AccessShareLock);
+    if (rel == NULL)
+        return false;
 
     /* Update state for progress reporting */
-    state->current_relid = relid;
+    state->current_relid = item->relid;
     state->current_relkind = rel->rd_rel->relkind;
 
     is_index = (rel->rd_rel->relkind == RELKIND_INDEX);
 
-    /* Use a consistent snapshot for the entire scan */
-    snapshot = GetActiveSnapshot();
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_CURRENT_RELID, item->relid);
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_PHASE,
+                                is_index ? PROGRESS_CHECKSUM_PHASE_SCAN_INDEX :
+                                PROGRESS_CHECKSUM_PHASE_SCAN_TABLE);
+
+    process_relation_range(rel, item->startblk, item->endblk, state);
+
+    relation_close(rel, AccessShareLock);
+
+    return true;
+}
+
+/*
+ * pg_relation_checksum_range
+ *    Compute what blocks startblk up to endblk (exclusive) of a relation
+ *    contribute to the database checksum.
+ *
+ * Parameters:
+ *    rel:        Open table, index, materialized view or TOAST table
+ *    startblk:   First block to process
+ *    endblk:     Block to stop at (exclusive), or InvalidBlockNumber for the
+ *                end of the relation
+ *    aggregate:  How to combine tuple and index entry checksums
+ *    n_tuples:   Receives the number of tuples or index entries hashed
+ *
+ * Returns:
+ *    The checksum of the range.  The checksums of consecutive ranges
+ *    covering the whole relation combine, by XOR or multiset sum, to the
+ *    relation's checksum as reported by pg_database_checksum_manifest()
+ *
+ * Notes:
+ *    - Tuples are checked for visibility against the active snapshot
+ */
+uint64
+pg_relation_checksum_range(Relation rel, BlockNumber startblk,
+                           BlockNumber endblk, ChecksumAggregate aggregate,
+                           uint64 *n_tuples)
+{
+    DatabaseChecksumState state;
+
+    memset(&state, 0, sizeof(DatabaseChecksumState));
+    state.aggregate = aggregate;
+    state.current_relid = RelationGetRelid(rel);
+    state.current_relkind = rel->rd_rel->relkind;
+
+    process_relation_range(rel, startblk, endblk, &state);
+
+    *n_tuples = state.n_tuples;
+    return state.checksum;
+}
+
+/*
+ * Sort work items by decreasing estimated size.  Ties are broken by
+ * relation and block range so that the order is fully deterministic.
+ */
+static int
+database_checksum_item_cmp(const void *a, const void *b)
+{
+    const DatabaseChecksumItem *ia = (const DatabaseChecksumItem *) a;
+    const DatabaseChecksumItem *ib = (const DatabaseChecksumItem *) b;
+
+    if (ia->est_blocks != ib->est_blocks)
+        return (ia->est_blocks > ib->est_blocks) ? -1 : 1;
+    if (ia->relid != ib->relid)
+        return (ia->relid < ib->relid) ? -1 : 1;
+    if (ia->startblk != ib->startblk)
+        return (ia->startblk < ib->startblk) ? -1 : 1;
+    return 0;
+}
 
-    if (!is_index)
+/*
+ * collect_database_checksum_items
+ *    Scan pg_class for the relations to checksum, and turn them into work
+ *    items, largest first.
+ *
+ * Relation sizes are estimated from pg_class.relpages, which avoids opening
+ * every relation here.  The estimate only affects scheduling: the last
+ * range of a split relation always extends to its actual end.
+ */
+static DatabaseChecksumItem *
+collect_database_checksum_items(bool include_system, bool include_toast,
+                                int *nitems)
+{
+    DatabaseChecksumItem *items;
+    int         maxitems = 1024;
+    int         n = 0;
+    Relation    pg_class_rel;
+    TableScanDesc scan;
+    HeapTuple   classTuple;
+
+    items = palloc_array(DatabaseChecksumItem, maxitems);
+
+    /* Scan pg_class to find all relations in the database */
+    pg_class_rel = table_open(RelationRelationId, AccessShareLock);
+    scan = table_beginscan(pg_class_rel, GetActiveSnapshot(), 0, NULL);
+
+    while ((classTuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
     {
+        Form_pg_class classForm = (Form_pg_class) GETSTRUCT(classTuple);
+        Oid         relid = classForm->oid;
+        Oid         relnamespace = classForm->relnamespace;
+        char        relkind = classForm->relkind;
+        char        relpersistence = classForm->relpersistence;
+        BlockNumber est_blocks = (BlockNumber) Max(classForm->relpages, 0);
+        BlockNumber startblk = 0;
+
         /*
-         * Process heap relation using a table scan.
-         * This approach is efficient for sequential access and respects MVCC.
+         * Filter relations we don't want to process:
+         *   - Only regular tables, indexes, materialized views, sequences, and toast
+         *   - Skip other relation kinds (views, foreign tables, etc.)
          */
-        scan = table_beginscan(rel, snapshot, 0, NULL);
-        
-        while ((tuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
+        if (relkind != RELKIND_RELATION &&
+            relkind != RELKIND_INDEX &&
+            relkind != RELKIND_MATVIEW &&
+            relkind != RELKIND_SEQUENCE &&
+            relkind != RELKIND_TOASTVALUE)
+            continue;
+
+        /*
+         * Apply inclusion filters:
+         *   - Skip system catalogs if include_system is false
+         *   - Skip toast tables if include_toast is false
+         *   - Always skip unlogged and temporary relations (they're not
+         *     crash-safe, and temporary ones can't be read by other backends)
+         */
+        if (!include_system && 
+            (relnamespace == PG_CATALOG_NAMESPACE ||
+             relnamespace == PG_TOAST_NAMESPACE))
+            continue;
+
+        if (!include_toast && relkind == RELKIND_TOASTVALUE)
+            continue;
+
+        if (relpersistence == RELPERSISTENCE_UNLOGGED ||
+            relpersistence == RELPERSISTENCE_TEMP)
+            continue;
+
+        /* Split large relations into ranges; the last one is open-ended */
+        do
         {
-            Buffer      buffer;
-            Page        page;
-            uint32      tuple_checksum;
-            BlockNumber blkno;
-            
-            /* Read the page containing this tuple */
-            buffer = ReadBuffer(rel, 
-                               ItemPointerGetBlockNumber(&tuple->t_self));
-            LockBuffer(buffer, BUFFER_LOCK_SHARE);
-            
-            page = BufferGetPage(buffer);
-            blkno = BufferGetBlockNumber(buffer);
-
-            /* Compute checksum for this tuple (excluding header) */
-            tuple_checksum = pg_tuple_checksum(page,
-                ItemPointerGetOffsetNumber(&tuple->t_self), blkno, false);
-            
-            /*
-             * Incorporate tuple checksum into database checksum.
-             * Combine with relation OID to differentiate between relations.
-             */
-            state->checksum ^= ((uint64)tuple_checksum << 32) | 
-                               (uint64)relid;
-            state->n_tuples++;
-            
-            UnlockReleaseBuffer(buffer);
-        }
-        
-        table_endscan(scan);
+            BlockNumber remaining = est_blocks - startblk;
+
+            if (n >= maxitems)
+            {
+                maxitems *= 2;
+                items = repalloc_array(items, DatabaseChecksumItem, maxitems);
+            }
+
+            memset(&items[n], 0, sizeof(DatabaseChecksumItem));
+            items[n].relid = relid;
+            items[n].relkind = relkind;
+            items[n].startblk = startblk;
+            if (remaining > 2 * DATABASE_CHECKSUM_SPLIT_BLOCKS)
+            {
+                items[n].endblk = startblk + DATABASE_CHECKSUM_SPLIT_BLOCKS;
+                items[n].est_blocks = DATABASE_CHECKSUM_SPLIT_BLOCKS;
+            }
+            else
+            {
+                items[n].endblk = InvalidBlockNumber;
+                items[n].est_blocks = remaining;
+            }
+            startblk = items[n].endblk;
+            n++;
+        } while (startblk != InvalidBlockNumber);
     }
-    else
+
+    table_endscan(scan);
+    table_close(pg_class_rel, AccessShareLock);
+
+    qsort(items, n, sizeof(DatabaseChecksumItem), database_checksum_item_cmp);
+
+    *nitems = n;
+    return items;
+}
+
+/*
+ * database_checksum_process_items
+ *    Process work items handed out by the shared counter until there are
+ *    none left, and add this participant's result to the shared one.
+ */
+static void
+database_checksum_process_items(DatabaseChecksumShared *shared,
+                                DatabaseChecksumState *state,
+                                checksum_progress_callback progress_callback,
+                                void *callback_arg)
+{
+    for (;;)
     {
-        /* Process index by reading pages directly */
-        process_index_for_checksum(rel, state);
+        uint32      i = pg_atomic_fetch_add_u32(&shared->next_item, 1);
+        DatabaseChecksumItem *item;
+        uint64      checksum = state->checksum;
+        uint64      n_tuples = state->n_tuples;
+        uint64      n_pages = state->n_pages;
+        instr_time  start_time;
+        instr_time  duration;
+
+        if (i >= shared->nitems)
+            break;
+        item = &shared->items[i];
+
+        /* Accumulate the item's own checksum, then fold it into ours */
+        INSTR_TIME_SET_CURRENT(start_time);
+        state->checksum = 0;
+        item->done = process_relation_for_checksum(item, state);
+        INSTR_TIME_SET_CURRENT(duration);
+        INSTR_TIME_SUBTRACT(duration, start_time);
+
+        item->checksum = state->checksum;
+        item->n_tuples = state->n_tuples - n_tuples;
+        item->n_pages = state->n_pages - n_pages;
+        item->elapsed_ms = INSTR_TIME_GET_MILLISEC(duration);
+        state->checksum = database_checksum_combine(state->aggregate,
+                                                    checksum, item->checksum);
+
+        /* A relation is done once the range reaching its end is */
+        if (item->endblk == InvalidBlockNumber)
+            pg_checksum_progress_incr(PROGRESS_CHECKSUM_RELATIONS_DONE, 1);
+
+        /* Call progress callback if provided */
+        if (progress_callback)
+            progress_callback(state, callback_arg);
+
+        CHECK_FOR_INTERRUPTS();
     }
 
-    relation_close(rel, AccessShareLock);
+    SpinLockAcquire(&shared->mutex);
+    shared->checksum = database_checksum_combine(shared->aggregate,
+                                                 shared->checksum,
+                                                 state->checksum);
+    shared->n_tuples += state->n_tuples;
+    shared->n_pages += state->n_pages;
+    SpinLockRelease(&shared->mutex);
+}
+
+/*
+ * Sort work items by relation and block range.
+ */
+static int
+database_checksum_item_relid_cmp(const void *a, const void *b)
+{
+    const DatabaseChecksumItem *ia = (const DatabaseChecksumItem *) a;
+    const DatabaseChecksumItem *ib = (const DatabaseChecksumItem *) b;
+
+    if (ia->relid != ib->relid)
+        return (ia->relid < ib->relid) ? -1 : 1;
+    if (ia->startblk != ib->startblk)
+        return (ia->startblk < ib->startblk) ? -1 : 1;
+    return 0;
+}
+
+/*
+ * database_checksum_manifest
+ *    Merge the results of the processed work items into one entry per
+ *    relation, ordered by relation OID.
+ *
+ * The elapsed time of a relation split into several items is the sum of
+ * the items' times, i.e. the time spent on it by all participants.
+ * Relations dropped while the checksum was being computed are left out.
+ * The result is allocated in context.
+ */
+static DatabaseChecksumRelation *
+database_checksum_manifest(DatabaseChecksumShared *shared,
+                           MemoryContext context, int *nrelations)
+{
+    DatabaseChecksumItem *items;
+    DatabaseChecksumRelation *relations;
+    int         n = 0;
+
+    items = palloc_array(DatabaseChecksumItem, shared->nitems);
+    memcpy(items, shared->items, sizeof(DatabaseChecksumItem) * shared->nitems);
+    qsort(items, shared->nitems, sizeof(DatabaseChecksumItem),
+          database_checksum_item_relid_cmp);
+
+    relations = MemoryContextAlloc(context,
+                                   sizeof(DatabaseChecksumRelation) *
+                                   Max(shared->nitems, 1));
+
+    for (int i = 0; i < shared->nitems; i++)
+    {
+        DatabaseChecksumItem *item = &items[i];
+        DatabaseChecksumRelation *relation;
+
+        if (!item->done)
+            continue;
+
+        if (n > 0 && relations[n - 1].relid == item->relid)
+            relation = &relations[n - 1];
+        else
+        {
+            relation = &relations[n++];
+            relation->relid = item->relid;
+            relation->relkind = item->relkind;
+            relation->n_tuples = 0;
+            relation->n_pages = 0;
+            relation->checksum = 0;
+            relation->elapsed_ms = 0;
+        }
+
+        relation->n_tuples += item->n_tuples;
+        relation->n_pages += item->n_pages;
+        relation->checksum = database_checksum_combine(shared->aggregate,
+                                                       relation->checksum,
+                                                       item->checksum);
+        relation->elapsed_ms += item->elapsed_ms;
+    }
+
+    pfree(items);
+
+    *nrelations = n;
+    return relations;
+}
+
+/*
+ * database_checksum_parallel_main
+ *    Entry point of a parallel database checksum worker.
+ */
+void
+database_checksum_parallel_main(dsm_segment *seg, shm_toc *toc)
+{
+    DatabaseChecksumShared *shared;
+    DatabaseChecksumState state;
+    WalUsage   *walusage;
+    BufferUsage *bufferusage;
+
+    /* Set debug_query_string for individual workers first */
+    debug_query_string = shm_toc_lookup(toc, PARALLEL_KEY_QUERY_TEXT, true);
+
+    /* Report the query string from leader */
+    pgstat_report_activity(STATE_RUNNING, debug_query_string);
+
+    shared = shm_toc_lookup(toc, PARALLEL_KEY_DATABASE_CHECKSUM, false);
+
+    /* Track query ID */
+    pgstat_report_query_id(shared->queryid, false);
+
+    pg_checksum_progress_begin_worker(shared->report_progress);
+
+    memset(&state, 0, sizeof(DatabaseChecksumState));
+    state.aggregate = shared->aggregate;
+
+    /* Prepare to track buffer usage during parallel execution */
+    InstrStartParallelQuery();
+
+    database_checksum_process_items(shared, &state, NULL, NULL);
+
+    /* Report WAL/buffer usage during parallel execution */
+    bufferusage = shm_toc_lookup(toc, PARALLEL_KEY_BUFFER_USAGE, false);
+    walusage = shm_toc_lookup(toc, PARALLEL_KEY_WAL_USAGE, false);
+    InstrEndParallelQuery(&bufferusage[ParallelWorkerNumber],
+                          &walusage[ParallelWorkerNumber]);
 }
 
 /*
@@ -274,14 +673,19 @@ process_relation_for_checksum(Oid relid, DatabaseChecksumState *state)
  *
  * This is the main entry point for database-level checksum computation.
  * It scans pg_class to find all relations in the database, filters them
- * based on inclusion criteria, and processes each one.
+ * based on inclusion criteria, and processes each one, possibly with the
+ * help of parallel workers.
  *
  * Parameters:
  *    dboid:              OID of database to checksum (must be current database)
  *    include_system:     Whether to include system catalogs
  *    include_toast:      Whether to include toast tables
+ *    aggregate:          How to combine tuple and index entry checksums
  *    progress_callback:  Optional callback for progress reporting
  *    callback_arg:       User data passed to progress callback
+ *    relations:          If not NULL, receives a palloc'd array with the
+ *                        results of the individual relations
+ *    nrelations:         Receives the length of *relations
  *
  * Returns:
  *    64-bit checksum representing the entire database state
@@ -291,26 +695,50 @@ process_relation_for_checksum(Oid relid, DatabaseChecksumState *state)
  *    - Runs in a dedicated memory context to control memory usage
  *    - Respects snapshot isolation for consistent results
  *    - Periodically checks for interrupts to allow cancellation
+ *    - Uses up to max_parallel_maintenance_workers workers; the result is
+ *      the same for any number of them
+ *    - progress_callback is only called for the work items processed by
+ *      this backend
+ *    - Progress of all participants is reported in
+ *      pg_stat_progress_checksum; the block total is estimated from
+ *      pg_class.relpages
+ *    - The relation checksums combine to the database checksum: their XOR,
+ *      or their sum for the multiset aggregate
  */
 uint64
 pg_database_checksum_internal(Oid dboid,
                               bool include_system,
                               bool include_toast,
+                              ChecksumAggregate aggregate,
                               checksum_progress_callback progress_callback,
-                              void *callback_arg)
+                              void *callback_arg,
+                              DatabaseChecksumRelation **relations,
+                              int *nrelations)
 {
     DatabaseChecksumState state;
-    Relation    pg_class_rel;
-    TableScanDesc scan;
-    HeapTuple   classTuple;
-    Snapshot    snapshot;
+    DatabaseChecksumItem *items;
+    DatabaseChecksumShared *shared;
+    ParallelContext *pcxt = NULL;
+    WalUsage   *walusage = NULL;
+    BufferUsage *bufferusage = NULL;
+    Size        sharedsize;
+    int         nitems;
+    int         nworkers;
+    uint64      checksum;
+    bool        progress;
+    int64       relations_total = 0;
+    int64       blocks_total = 0;
     MemoryContext oldcontext;
     MemoryContext checksum_context;
+    instr_time  start;
+
+    INSTR_TIME_SET_CURRENT(start);
 
     /* Initialize state structure */
     memset(&state, 0, sizeof(DatabaseChecksumState));
     state.include_system = include_system;
     state.include_toast = include_toast;
+    state.aggregate = aggregate;
 
     /*
      * Create a dedicated memory context for the checksum operation.
@@ -332,54 +760,138 @@ pg_database_checksum_internal(Oid dboid,
                 (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
                  errmsg("cross-database checksum not supported from this context")));
 
-    /* Use a consistent snapshot for the entire operation */
-    snapshot = GetActiveSnapshot();
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_DATABASE,
+                                          InvalidOid);
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_PHASE,
+                                PROGRESS_CHECKSUM_PHASE_COLLECT_RELATIONS);
 
-    /* Scan pg_class to find all relations in the database */
-    pg_class_rel = table_open(RelationRelationId, AccessShareLock);
-    scan = table_beginscan(pg_class_rel, snapshot, 0, NULL);
+    items = collect_database_checksum_items(include_system, include_toast,
+                                            &nitems);
 
-    while ((classTuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
+    for (int i = 0; i < nitems; i++)
     {
-        Form_pg_class classForm = (Form_pg_class) GETSTRUCT(classTuple);
-        Oid         relid = classForm->oid;
-        Oid         relnamespace = classForm->relnamespace;
-        char        relkind = classForm->relkind;
-        char        relpersistence = classForm->relpersistence;
+        if (items[i].endblk == InvalidBlockNumber)
+            relations_total++;
+        blocks_total += items[i].est_blocks;
+    }
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_RELATIONS_TOTAL,
+                                relations_total);
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_BLOCKS_TOTAL, blocks_total);
 
-        /*
-         * Apply inclusion filters:
-         *   - Skip system catalogs if include_system is false
-         *   - Skip toast tables if include_toast is false
-         *   - Always skip unlogged relations (they're not crash-safe)
-         */
-        if (!include_system && 
-            (relnamespace == PG_CATALOG_NAMESPACE ||
-             relnamespace == PG_TOAST_NAMESPACE))
-            continue;
+    /* One worker per item at most; we take part ourselves, too */
+    nworkers = 0;
+    if (!IsInParallelMode())
+        nworkers = Min(max_parallel_maintenance_workers, nitems - 1);
 
-        if (!include_toast && relkind == RELKIND_TOASTVALUE)
-            continue;
+    sharedsize = add_size(offsetof(DatabaseChecksumShared, items),
+                          mul_size(sizeof(DatabaseChecksumItem), nitems));
 
-        if (relpersistence == RELPERSISTENCE_UNLOGGED)
-            continue;
+    if (nworkers > 0)
+    {
+        int         querylen = 0;
 
-        /* Process this relation */
-        process_relation_for_checksum(relid, &state);
+        EnterParallelMode();
+        pcxt = CreateParallelContext("postgres",
+                                     "database_checksum_parallel_main",
+                                     nworkers);
 
-        /* Call progress callback if provided */
-        if (progress_callback)
-            progress_callback(&state, callback_arg);
+        shm_toc_estimate_chunk(&pcxt->estimator, sharedsize);
+        shm_toc_estimate_keys(&pcxt->estimator, 1);
+        shm_toc_estimate_chunk(&pcxt->estimator,
+                               mul_size(sizeof(WalUsage), pcxt->nworkers));
+        shm_toc_estimate_keys(&pcxt->estimator, 1);
+        shm_toc_estimate_chunk(&pcxt->estimator,
+                               mul_size(sizeof(BufferUsage), pcxt->nworkers));
+        shm_toc_estimate_keys(&pcxt->estimator, 1);
+        if (debug_query_string)
+        {
+            querylen = strlen(debug_query_string);
+            shm_toc_estimate_chunk(&pcxt->estimator, querylen + 1);
+            shm_toc_estimate_keys(&pcxt->estimator, 1);
+        }
 
-        CHECK_FOR_INTERRUPTS();
+        InitializeParallelDSM(pcxt);
+
+        /* If no DSM segment was available, back out (do serial scan) */
+        if (pcxt->seg == NULL)
+        {
+            DestroyParallelContext(pcxt);
+            ExitParallelMode();
+            pcxt = NULL;
+        }
+        else
+        {
+            shared = shm_toc_allocate(pcxt->toc, sharedsize);
+            shm_toc_insert(pcxt->toc, PARALLEL_KEY_DATABASE_CHECKSUM, shared);
+
+            if (debug_query_string)
+            {
+                char       *sharedquery;
+
+                sharedquery = (char *) shm_toc_allocate(pcxt->toc, querylen + 1);
+                memcpy(sharedquery, debug_query_string, querylen + 1);
+                shm_toc_insert(pcxt->toc, PARALLEL_KEY_QUERY_TEXT, sharedquery);
+            }
+
+            walusage = shm_toc_allocate(pcxt->toc,
+                                        mul_size(sizeof(WalUsage), pcxt->nworkers));
+            shm_toc_insert(pcxt->toc, PARALLEL_KEY_WAL_USAGE, walusage);
+            bufferusage = shm_toc_allocate(pcxt->toc,
+                                           mul_size(sizeof(BufferUsage), pcxt->nworkers));
+            shm_toc_insert(pcxt->toc, PARALLEL_KEY_BUFFER_USAGE, bufferusage);
+        }
     }
 
-    /* Clean up */
-    table_endscan(scan);
-    table_close(pg_class_rel, AccessShareLock);
+    /* Without workers, we hand out the items to ourselves */
+    if (pcxt == NULL)
+        shared = palloc(sharedsize);
+
+    shared->aggregate = aggregate;
+    shared->queryid = pgstat_get_my_query_id();
+    shared->report_progress = pg_checksum_progress_reporting();
+    shared->nitems = nitems;
+    pg_atomic_init_u32(&shared->next_item, 0);
+    SpinLockInit(&shared->mutex);
+    shared->checksum = 0;
+    shared->n_tuples = 0;
+    shared->n_pages = 0;
+    memcpy(shared->items, items, sizeof(DatabaseChecksumItem) * nitems);
+
+    if (pcxt != NULL)
+        LaunchParallelWorkers(pcxt);
+
+    /* Process items ourselves until there are none left */
+    database_checksum_process_items(shared, &state, progress_callback,
+                                    callback_arg);
+
+    if (pcxt != NULL)
+    {
+        pg_checksum_progress_update(PROGRESS_CHECKSUM_PHASE,
+                                    PROGRESS_CHECKSUM_PHASE_WAIT_WORKERS);
+        WaitForParallelWorkersToFinish(pcxt);
+
+        for (int i = 0; i < pcxt->nworkers_launched; i++)
+            InstrAccumParallelQuery(&bufferusage[i], &walusage[i]);
+    }
+
+    checksum = shared->checksum;
+
+    if (relations != NULL)
+        *relations = database_checksum_manifest(shared, oldcontext, nrelations);
+
+    if (pcxt != NULL)
+    {
+        DestroyParallelContext(pcxt);
+        ExitParallelMode();
+    }
+
+    if (progress)
+        pgstat_progress_end_command();
+
+    pgstat_report_checksum_run(InvalidOid, start, (int64) checksum, false);
 
     MemoryContextSwitchTo(oldcontext);
     MemoryContextDelete(checksum_context);
 
-    return state.checksum;
-}
\ No newline at end of file
+    return checksum;
+}
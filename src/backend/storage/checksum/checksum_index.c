@@ -4,15 +4,26 @@
  *    Index-level checksum implementation
  *
  * This module provides functions for computing checksums at the index level,
- * including both individual index tuples and entire indexes. Index checksums
- * help detect corruption in index structures and ensure index consistency
- * with table data. They are particularly important for:
+ * including both individual index entries and entire indexes. Index
+ * checksums help detect corruption in index structures and ensure index
+ * consistency with table data. They are particularly important for:
  *    - Verifying B-tree integrity after crash recovery
  *    - Detecting index corruption that could lead to wrong query results
  *    - Validating index builds and rebuilds
  *
- * The implementation handles different index types (B-tree, hash, etc.)
- * and incorporates index-specific metadata like heap TIDs for B-trees.
+ * An index checksum covers the logical content of the index only: the
+ * entries of its leaf level, each bound to the heap TID it points to.
+ * Metapages, internal pages and other structural pages are skipped, and the
+ * position of an entry on its page plays no part, so that the checksum of
+ * an index survives page splits, deduplication and REINDEX.  Every access
+ * method lays out its leaf level differently, so each of B-tree, hash, GIN,
+ * GiST and BRIN has its own page walker; other access methods fall back to
+ * hashing every item of every page.
+ *
+ * For B-tree, hash, GIN and GiST indexes, the same entry checksums can also
+ * be computed from the table, by forming the entries the index should hold
+ * for each heap tuple.  Comparing the two sides checks that an index matches
+ * its table in one pass over each, without sorting or a Bloom filter.
  *
  * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
  * Portions Copyright (c) 1994, Regents of the University of California
@@ -25,132 +36,1022 @@
 
 #include "postgres.h"
 
-#include "access/genam.h"
-#include "access/htup_details.h"
+#include "access/brin_page.h"
+#include "access/brin_tuple.h"
+#include "access/gin_private.h"
+#include "access/gist_private.h"
+#include "access/hash.h"
+#include "access/heapam.h"
 #include "access/itup.h"
 #include "access/nbtree.h"
-#include "access/relscan.h"
+#include "access/tableam.h"
+#include "access/visibilitymap.h"
 #include "catalog/index.h"
+#include "catalog/pg_am_d.h"
+#include "commands/defrem.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "storage/bufmgr.h"
 #include "storage/bufpage.h"
 #include "storage/checksum.h"
-#include "storage/checksum_index.h"
 #include "storage/checksum_column.h"
+#include "storage/checksum_index.h"
+#include "storage/checksum_progress.h"
+#include "storage/checksum_scan.h"
+#include "storage/procarray.h"
+#include "utils/memutils.h"
 #include "utils/rel.h"
 
+/*
+ * A GIN posting tree found on an entry leaf page.  Its items are read after
+ * the scan, once no page of the entry tree is locked anymore.
+ */
+typedef struct GinPostingTreeRef
+{
+    BlockNumber root;           /* root block of the posting tree */
+    pg_logical_checksum_context key;    /* key of the entry, already hashed */
+} GinPostingTreeRef;
+
+/* State of an index checksum scan */
+typedef struct IndexChecksumWalker
+{
+    Relation    index;
+    checksum_index_entry_callback callback;
+    void       *arg;
+    TidStore   *exclude_tids;   /* entries pointing here are left out */
+    BlockNumber npages;         /* pages read so far */
+    ChecksumProgressCounter progress;   /* entries and bytes not reported */
+
+    /* Hash: bucket mapping, as of the start of the scan */
+    uint32      maxbucket;
+    uint32      highmask;
+    uint32      lowmask;
+
+    /* GIN: posting trees to visit after the scan */
+    List       *posting_trees;
+} IndexChecksumWalker;
+
+/* State of the table side of pg_index_heap_checksum_scan_range() */
+typedef struct IndexHeapChecksumState
+{
+    checksum_index_entry_callback callback;
+    void       *arg;
+    MemoryContext tmpcxt;       /* reset after each heap tuple */
+    BlockNumber next_block;     /* first block not counted as done */
+    ChecksumProgressCounter progress;
+    int64       ntuples;        /* entries formed so far */
+    int64       nbytes;         /* their total size */
+    GinState   *ginstate;       /* GIN only */
+    GISTSTATE  *giststate;      /* GiST only */
+} IndexHeapChecksumState;
+
+/* Zeroes to pad GIN keys with, see gin_checksum_entry_key() */
+static const char index_key_padding[MAXIMUM_ALIGNOF] = {0};
+
+/*
+ * index_checksum_key_init
+ *    Start the checksum of an index entry with its key.
+ *
+ * The key of an index tuple is everything after the IndexTupleData header,
+ * up to keyend: the null bitmap, if any, and the key attributes.  The header
+ * itself is left out, since it holds the tuple length, flags and (for most
+ * access methods) the heap TID, which depend on how the entry is stored.
+ */
+static inline void
+index_checksum_key_init(pg_logical_checksum_context *ctx, IndexTuple itup,
+                        Size keyend)
+{
+    pg_logical_checksum_init(ctx, 0);
+    pg_logical_checksum_update(ctx, (char *) itup + sizeof(IndexTupleData),
+                               keyend - sizeof(IndexTupleData));
+}
+
+/*
+ * index_checksum_entry
+ *    Finish the checksum of an index entry whose key has been hashed into
+ *    key, binding it to the heap TID htid, and report it to the walker's
+ *    callback.  key is left untouched, so that it can be reused for every
+ *    heap TID of a posting list.  Entries pointing to one of the walker's
+ *    exclude_tids are not reported.
+ */
+static inline void
+index_checksum_entry(IndexChecksumWalker *walker,
+                     const pg_logical_checksum_context *key,
+                     ItemPointer htid)
+{
+    pg_logical_checksum_context ctx = *key;
+    uint32      checksum;
+
+    if (htid != NULL && walker->exclude_tids != NULL &&
+        TidStoreIsMember(walker->exclude_tids, htid))
+        return;
+
+    if (htid != NULL)
+        pg_logical_checksum_update(&ctx, (char *) htid,
+                                   sizeof(ItemPointerData));
+    checksum = pg_logical_checksum_final(&ctx);
+
+    /* Index entry checksums never equal CHECKSUM_NULL */
+    if (checksum == CHECKSUM_NULL)
+        checksum &= 0xFFFFFFFE;
+
+    walker->callback(checksum, walker->arg);
+    walker->progress.tuples++;
+}
+
+/*
+ * btree_checksum_page
+ *    Hash the entries of a B-tree leaf page.
+ *
+ * The metapage, internal pages, deleted and half-dead pages and high keys
+ * are skipped.  A posting list tuple is the same as one plain tuple for
+ * each of its heap TIDs, as both have the same key bytes.
+ */
+static void
+btree_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    BTPageOpaque opaque = BTPageGetOpaque(page);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    if (P_ISMETA(opaque) || !P_ISLEAF(opaque) || P_IGNORE(opaque))
+        return;
+
+    for (OffsetNumber offnum = P_FIRSTDATAKEY(opaque);
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        IndexTuple  itup;
+        pg_logical_checksum_context key;
+
+        /* Skip unused or dead index entries */
+        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+            continue;
+
+        itup = (IndexTuple) PageGetItem(page, itemId);
+        walker->progress.bytes += ItemIdGetLength(itemId);
+
+        if (BTreeTupleIsPosting(itup))
+        {
+            int         nposting = BTreeTupleGetNPosting(itup);
+
+            index_checksum_key_init(&key, itup,
+                                    BTreeTupleGetPostingOffset(itup));
+            for (int i = 0; i < nposting; i++)
+                index_checksum_entry(walker, &key,
+                                     BTreeTupleGetPostingN(itup, i));
+        }
+        else
+        {
+            index_checksum_key_init(&key, itup, IndexTupleSize(itup));
+            index_checksum_entry(walker, &key, &itup->t_tid);
+        }
+    }
+}
+
+/*
+ * hash_checksum_page
+ *    Hash the entries of a hash bucket or overflow page.
+ *
+ * The metapage, bitmap pages and unused overflow pages are skipped.  So are
+ * entries that belong to another bucket: after a bucket split, the entries
+ * moved to the new bucket stay behind in the old one until it is cleaned
+ * up, and would otherwise be counted twice.
+ */
+static void
+hash_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    HashPageOpaque opaque = HashPageGetOpaque(page);
+    uint16      pagetype = opaque->hasho_flag & LH_PAGE_TYPE;
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    if (pagetype != LH_BUCKET_PAGE && pagetype != LH_OVERFLOW_PAGE)
+        return;
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        IndexTuple  itup;
+        Bucket      bucket;
+        pg_logical_checksum_context key;
+
+        /* Skip unused or dead index entries */
+        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+            continue;
+
+        itup = (IndexTuple) PageGetItem(page, itemId);
+
+        bucket = _hash_hashkey2bucket(_hash_get_indextuple_hashkey(itup),
+                                      walker->maxbucket,
+                                      walker->highmask,
+                                      walker->lowmask);
+        if (bucket != opaque->hasho_bucket)
+            continue;
+        walker->progress.bytes += ItemIdGetLength(itemId);
+
+        index_checksum_key_init(&key, itup, IndexTupleSize(itup));
+        index_checksum_entry(walker, &key, &itup->t_tid);
+    }
+}
+
+/*
+ * gin_checksum_entry_key
+ *    Hash the key of a GIN entry tuple.
+ *
+ * GinFormTuple() stores the posting list of an entry right after its key,
+ * at a SHORTALIGNed offset, whereas an entry that points to a posting tree,
+ * or sits in the pending list, ends with zero padding up to a MAXALIGNed
+ * length instead.  The key of the former is padded with zeroes here, so
+ * that all three hash alike.
+ */
+static void
+gin_checksum_entry_key(pg_logical_checksum_context *key, IndexTuple itup)
+{
+    Size        keyend;
+
+    if (GinIsPostingTree(itup))
+        keyend = IndexTupleSize(itup);
+    else
+        keyend = GinGetPostingOffset(itup);
+
+    index_checksum_key_init(key, itup, keyend);
+    if (keyend != MAXALIGN(keyend))
+        pg_logical_checksum_update(key, index_key_padding,
+                                   MAXALIGN(keyend) - keyend);
+}
+
+/*
+ * gin_checksum_page
+ *    Hash the entries of a GIN entry leaf page or pending list page.
+ *
+ * The metapage, deleted pages and internal pages of the entry tree are
+ * skipped, and so are all posting tree pages: a posting tree is visited as
+ * a whole by gin_checksum_posting_tree(), after the scan, so that each of its
+ * items is hashed with the key of its entry.  An item stored in an entry's
+ * posting list, in its posting tree or in the pending list has the same
+ * checksum.
+ */
+static void
+gin_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    GinPageOpaque opaque = GinPageGetOpaque(page);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    bool        pending = GinPageIsList(page);
+
+    if ((opaque->flags & (GIN_META | GIN_DELETED | GIN_DATA)) != 0)
+        return;
+    if (!pending && !GinPageIsLeaf(page))
+        return;
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        IndexTuple  itup;
+        pg_logical_checksum_context key;
+
+        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+            continue;
+
+        itup = (IndexTuple) PageGetItem(page, itemId);
+        walker->progress.bytes += ItemIdGetLength(itemId);
+
+        /* A pending list tuple holds one key and one heap TID */
+        if (pending)
+        {
+            index_checksum_key_init(&key, itup, IndexTupleSize(itup));
+            index_checksum_entry(walker, &key, &itup->t_tid);
+            continue;
+        }
+
+        gin_checksum_entry_key(&key, itup);
+
+        if (GinIsPostingTree(itup))
+        {
+            GinPostingTreeRef *ref = palloc(sizeof(GinPostingTreeRef));
+
+            ref->root = GinGetPostingTree(itup);
+            ref->key = key;
+            walker->posting_trees = lappend(walker->posting_trees, ref);
+        }
+        else
+        {
+            int         nitems = GinGetNPosting(itup);
+            ItemPointer items;
+
+            if (nitems == 0)
+                continue;
+
+            /* As in ginReadTuple() */
+            if (GinItupIsCompressed(itup))
+            {
+                int         ndecoded;
+
+                items = ginPostingListDecode((GinPostingList *) GinGetPosting(itup),
+                                             &ndecoded);
+                if (nitems != ndecoded)
+                    elog(ERROR, "number of items mismatch in GIN entry tuple, %d in tuple header, %d decoded",
+                         nitems, ndecoded);
+            }
+            else
+                items = (ItemPointer) GinGetPosting(itup);
+
+            for (int i = 0; i < nitems; i++)
+                index_checksum_entry(walker, &key, &items[i]);
+
+            if (GinItupIsCompressed(itup))
+                pfree(items);
+        }
+    }
+}
+
+/*
+ * gin_checksum_posting_tree
+ *    Hash the items of a GIN posting tree with the key of its entry.
+ *
+ * Descends from the root to the leftmost leaf and then follows the right
+ * links of the leaf level, holding one page locked at a time.
+ */
+static void
+gin_checksum_posting_tree(IndexChecksumWalker *walker, GinPostingTreeRef *ref)
+{
+    BlockNumber blkno = ref->root;
+    Buffer      buffer;
+    Page        page;
+
+    for (;;)
+    {
+        buffer = ReadBuffer(walker->index, blkno);
+        LockBuffer(buffer, GIN_SHARE);
+        page = BufferGetPage(buffer);
+        walker->npages++;
+
+        if (GinPageIsLeaf(page))
+            break;
+
+        blkno = PostingItemGetBlockNumber(GinDataPageGetPostingItem(page, FirstOffsetNumber));
+        UnlockReleaseBuffer(buffer);
+    }
+
+    for (;;)
+    {
+        CHECK_FOR_INTERRUPTS();
+
+        if (!GinPageIsDeleted(page))
+        {
+            ItemPointerData advancePast;
+            ItemPointer items;
+            int         nitems;
+
+            ItemPointerSetInvalid(&advancePast);
+            items = GinDataLeafPageGetItems(page, &nitems, advancePast);
+            for (int i = 0; i < nitems; i++)
+                index_checksum_entry(walker, &ref->key, &items[i]);
+            walker->progress.bytes += nitems * sizeof(ItemPointerData);
+            if (items != NULL)
+                pfree(items);
+        }
+
+        blkno = GinPageGetOpaque(page)->rightlink;
+        UnlockReleaseBuffer(buffer);
+        if (blkno == InvalidBlockNumber)
+            break;
+
+        buffer = ReadBuffer(walker->index, blkno);
+        LockBuffer(buffer, GIN_SHARE);
+        page = BufferGetPage(buffer);
+        walker->npages++;
+    }
+}
+
+/*
+ * gist_checksum_page
+ *    Hash the entries of a GiST leaf page; internal and deleted pages are
+ *    skipped.
+ */
+static void
+gist_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    if (!GistPageIsLeaf(page) || GistPageIsDeleted(page))
+        return;
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        IndexTuple  itup;
+        pg_logical_checksum_context key;
+
+        /* Skip unused or dead index entries */
+        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+            continue;
+
+        itup = (IndexTuple) PageGetItem(page, itemId);
+        walker->progress.bytes += ItemIdGetLength(itemId);
+        index_checksum_key_init(&key, itup, IndexTupleSize(itup));
+        index_checksum_entry(walker, &key, &itup->t_tid);
+    }
+}
+
+/*
+ * brin_checksum_page
+ *    Hash the range summaries on a BRIN regular page.
+ *
+ * The metapage and range map pages are skipped, and so are placeholder
+ * tuples of ranges being summarized.  A summary is hashed whole, including
+ * the first block of its range, and has no heap TID.
+ */
+static void
+brin_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    if (!BRIN_IS_REGULAR_PAGE(page))
+        return;
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        BrinTuple  *btup;
+        pg_logical_checksum_context key;
+
+        if (!ItemIdIsUsed(itemId))
+            continue;
+
+        btup = (BrinTuple *) PageGetItem(page, itemId);
+        if (BrinTupleIsPlaceholder(btup))
+            continue;
+        walker->progress.bytes += ItemIdGetLength(itemId);
+
+        pg_logical_checksum_init(&key, 0);
+        pg_logical_checksum_update(&key, (char *) btup,
+                                   ItemIdGetLength(itemId));
+        index_checksum_entry(walker, &key, NULL);
+    }
+}
+
+/*
+ * generic_checksum_page
+ *    Hash every item of a page of an index whose access method has no walker
+ *    of its own.
+ *
+ * Nothing is known about the page layout, so structural pages are included
+ * and each item is hashed with its offset number, as identical items may
+ * occur.  Such checksums change when the index is rebuilt.
+ */
+static void
+generic_checksum_page(IndexChecksumWalker *walker, Page page)
+{
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        pg_logical_checksum_context key;
+
+        /* Skip unused or dead index entries */
+        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+            continue;
+
+        walker->progress.bytes += ItemIdGetLength(itemId);
+        pg_logical_checksum_init(&key, offnum);
+        pg_logical_checksum_update(&key, (char *) PageGetItem(page, itemId),
+                                   ItemIdGetLength(itemId));
+        index_checksum_entry(walker, &key, NULL);
+    }
+}
+
+/*
+ * index_checksum_flush
+ *    Report the entries and bytes hashed since the last flush, both as
+ *    progress and to the cumulative statistics.
+ */
+static void
+index_checksum_flush(IndexChecksumWalker *walker)
+{
+    pgstat_count_checksum_scan(walker->index, walker->progress.tuples,
+                               walker->progress.bytes);
+    pg_checksum_progress_flush(&walker->progress);
+}
+
+/*
+ * index_checksum_page
+ *    Dispatch one index page to the walker of the index's access method;
+ *    a checksum_index_page_callback for pg_checksum_index_scan_range().
+ */
+static void
+index_checksum_page(Page page, BlockNumber blkno, void *arg)
+{
+    IndexChecksumWalker *walker = (IndexChecksumWalker *) arg;
+
+    walker->npages++;
+
+    switch (walker->index->rd_rel->relam)
+    {
+        case BTREE_AM_OID:
+            btree_checksum_page(walker, page);
+            break;
+        case HASH_AM_OID:
+            hash_checksum_page(walker, page);
+            break;
+        case GIN_AM_OID:
+            gin_checksum_page(walker, page);
+            break;
+        case GIST_AM_OID:
+            gist_checksum_page(walker, page);
+            break;
+        case BRIN_AM_OID:
+            brin_checksum_page(walker, page);
+            break;
+        default:
+            generic_checksum_page(walker, page);
+            break;
+    }
+
+    /* Blocks are counted by pg_checksum_index_scan_range() */
+    if (walker->npages % CHECKSUM_PROGRESS_INTERVAL == 0)
+        index_checksum_flush(walker);
+}
+
 /*
  * pg_index_tuple_checksum
- *    Compute checksum for an individual index tuple.
+ *    Compute checksum for an individual index entry.
  *
- * This function calculates a 32-bit checksum for an index tuple, taking into
- * account index-specific metadata. For B-tree indexes, the heap TID
- * is included in the checksum to maintain the index-to-heap relationship.
+ * This function calculates a 32-bit checksum for an index tuple that holds
+ * one key and one heap TID, such as a plain B-tree, hash or GiST leaf tuple.
+ * The key and the heap TID are hashed; the rest of the tuple header is not.
  *
  * Parameters:
- *    itup:          Index tuple to checksum
- *    indexTupDesc:  Tuple descriptor for the index
- *    attno:         Offset number within the index page (for uniqueness)
+ *    itup:  Index tuple to checksum
  *
  * Returns:
- *    32-bit checksum for the index tuple
- *
- * Notes:
- *    - For B-tree indexes, the heap TID (ItemPointer) is included
- *      to bind index entries to their corresponding heap tuples
- *    - The offset number ensures tuples at different positions have
- *      different checksums even if their data is identical
- *    - Index tuple size must be valid (verified by IndexTupleSize)
+ *    32-bit checksum for the index entry, never CHECKSUM_NULL.  It is the
+ *    checksum pg_index_checksum_scan_range() reports for the entry.
  */
 uint32
-pg_index_tuple_checksum(IndexTuple itup, TupleDesc indexTupDesc,
-                        OffsetNumber attno)
+pg_index_tuple_checksum(IndexTuple itup)
 {
-    uint32      len;
+    pg_logical_checksum_context ctx;
     uint32      checksum;
 
-    /* Get the index tuple size (includes header and data) */
-    len = IndexTupleSize(itup);
-    
-    /* Basic checksum of the tuple data using offset as initial value */
-    checksum = pg_checksum_data((char *) itup, len, attno);
+    index_checksum_key_init(&ctx, itup, IndexTupleSize(itup));
+    pg_logical_checksum_update(&ctx, (char *) &itup->t_tid,
+                               sizeof(ItemPointerData));
+    checksum = pg_logical_checksum_final(&ctx);
 
-    /*
-     * For B-tree indexes, include the heap TID in the checksum.
-     * This binds the index entry to its corresponding heap tuple,
-     * which is crucial for detecting inconsistencies between
-     * indexes and their underlying tables.
-     */
-    if (indexTupDesc->tdtypeid == BTREE_AM_OID)
+    if (checksum == CHECKSUM_NULL)
+        checksum &= 0xFFFFFFFE;
+
+    return checksum;
+}
+
+/*
+ * pg_index_checksum_scan_range
+ *    Call callback with the checksum of every logical entry of an index
+ *    found among blocks startblk up to (but not including) endblk.
+ *
+ * Parameters:
+ *    index:     Index relation, opened and locked by the caller
+ *    startblk:  First block to visit
+ *    endblk:    Block to stop at; InvalidBlockNumber to visit all remaining
+ *               blocks
+ *    callback:  Called once per entry
+ *    arg:       Passed through to callback
+ *
+ * Returns:
+ *    Number of pages read
+ *
+ * Notes:
+ *    - Entries are reported in no particular order, so callers should
+ *      combine them commutatively
+ *    - Scanning disjoint block ranges that together cover the index reports
+ *      every entry exactly once; the items of a GIN posting tree are
+ *      reported by the scan whose range holds the entry that points to it
+ */
+BlockNumber
+pg_index_checksum_scan_range(Relation index, BlockNumber startblk,
+                             BlockNumber endblk,
+                             checksum_index_entry_callback callback,
+                             void *arg)
+{
+    return pg_index_checksum_scan_range_ext(index, startblk, endblk, NULL,
+                                            callback, arg);
+}
+
+/*
+ * pg_index_checksum_scan_range_ext
+ *    Like pg_index_checksum_scan_range(), but leave out the entries that
+ *    point to any of exclude_tids, if not NULL.
+ *
+ * Notes:
+ *    - BRIN range summaries and the entries of access methods without a
+ *      walker of their own have no heap TID, and are never left out
+ */
+BlockNumber
+pg_index_checksum_scan_range_ext(Relation index, BlockNumber startblk,
+                                 BlockNumber endblk, TidStore *exclude_tids,
+                                 checksum_index_entry_callback callback,
+                                 void *arg)
+{
+    IndexChecksumWalker walker;
+    ListCell   *lc;
+
+    walker.index = index;
+    walker.callback = callback;
+    walker.arg = arg;
+    walker.exclude_tids = exclude_tids;
+    walker.npages = 0;
+    memset(&walker.progress, 0, sizeof(ChecksumProgressCounter));
+    walker.posting_trees = NIL;
+
+    if (index->rd_rel->relam == HASH_AM_OID)
     {
-        ItemPointer heapTid = &itup->t_tid;
-        checksum ^= ItemPointerGetBlockNumber(heapTid);
-        checksum ^= ItemPointerGetOffsetNumber(heapTid) << 16;
+        Buffer      metabuf;
+        HashMetaPage metap;
+
+        metabuf = _hash_getbuf(index, HASH_METAPAGE, HASH_READ, LH_META_PAGE);
+        metap = HashPageGetMeta(BufferGetPage(metabuf));
+        walker.maxbucket = metap->hashm_maxbucket;
+        walker.highmask = metap->hashm_highmask;
+        walker.lowmask = metap->hashm_lowmask;
+        _hash_relbuf(index, metabuf);
     }
 
+    pg_checksum_index_scan_range(index, startblk, endblk,
+                                 index_checksum_page, &walker);
+
+    foreach(lc, walker.posting_trees)
+        gin_checksum_posting_tree(&walker, (GinPostingTreeRef *) lfirst(lc));
+    list_free_deep(walker.posting_trees);
+
+    index_checksum_flush(&walker);
+
+    return walker.npages;
+}
+
+/*
+ * index_heap_checksum_entry
+ *    Report the checksum of an index entry formed from a heap tuple.
+ */
+static inline void
+index_heap_checksum_entry(IndexHeapChecksumState *state, IndexTuple itup,
+                          ItemPointer tid)
+{
+    itup->t_tid = *tid;
+    state->callback(pg_index_tuple_checksum(itup), state->arg);
+    state->progress.tuples++;
+    state->progress.bytes += IndexTupleSize(itup);
+    state->ntuples++;
+    state->nbytes += IndexTupleSize(itup);
+}
+
+/*
+ * index_heap_checksum_tuple
+ *    Form the entries an index should hold for one heap tuple, the way its
+ *    access method does on insertion, and report their checksums; an
+ *    IndexBuildCallback for table_index_build_range_scan().
+ */
+static void
+index_heap_checksum_tuple(Relation index, ItemPointer tid, Datum *values,
+                          bool *isnull, bool tupleIsAlive, void *arg)
+{
+    IndexHeapChecksumState *state = (IndexHeapChecksumState *) arg;
+    BlockNumber blkno = ItemPointerGetBlockNumber(tid);
+    MemoryContext oldcontext;
+
     /*
-     * IMPORTANT: Guarantee that index checksums never equal CHECKSUM_NULL.
-     * This prevents collisions with NULL column values in heap tuples.
+     * The table is scanned in block order, so the blocks before this tuple's
+     * are done.  HOT chains may lead back to a block already passed.
      */
-    if (checksum == CHECKSUM_NULL)
+    if (blkno >= state->next_block)
     {
-        checksum = (CHECKSUM_NULL ^ attno ^ len) & 0xFFFFFFFE;
+        pg_checksum_progress_count(&state->progress,
+                                   blkno - state->next_block, 0, 0);
+        state->next_block = blkno;
     }
-    
-    return checksum;
+
+    oldcontext = MemoryContextSwitchTo(state->tmpcxt);
+
+    switch (index->rd_rel->relam)
+    {
+        case BTREE_AM_OID:
+            index_heap_checksum_entry(state,
+                                      index_form_tuple(RelationGetDescr(index),
+                                                       values, isnull),
+                                      tid);
+            break;
+        case HASH_AM_OID:
+            {
+                Datum       index_values[INDEX_MAX_KEYS];
+                bool        index_isnull[INDEX_MAX_KEYS];
+
+                /* As in hashbuildCallback(): NULLs are not indexed */
+                if (_hash_convert_tuple(index, values, isnull,
+                                        index_values, index_isnull))
+                    index_heap_checksum_entry(state,
+                                              index_form_tuple(RelationGetDescr(index),
+                                                               index_values,
+                                                               index_isnull),
+                                              tid);
+            }
+            break;
+        case GIN_AM_OID:
+            for (int i = 0; i < state->ginstate->origTupdesc->natts; i++)
+            {
+                Datum      *entries;
+                GinNullCategory *categories;
+                int32       nentries;
+
+                entries = ginExtractEntries(state->ginstate, i + 1,
+                                            values[i], isnull[i],
+                                            &nentries, &categories);
+
+                /* Formed like a pending list tuple, see gin_checksum_page() */
+                for (int j = 0; j < nentries; j++)
+                    index_heap_checksum_entry(state,
+                                              GinFormTuple(state->ginstate,
+                                                           i + 1, entries[j],
+                                                           categories[j],
+                                                           NULL, 0, 0, true),
+                                              tid);
+            }
+            break;
+        case GIST_AM_OID:
+            index_heap_checksum_entry(state,
+                                      gistFormTuple(state->giststate, index,
+                                                    values, isnull, true),
+                                      tid);
+            break;
+    }
+
+    MemoryContextSwitchTo(oldcontext);
+    MemoryContextReset(state->tmpcxt);
 }
 
 /*
- * pg_index_page_checksum
- *    Compute checksum for all index tuples on a page.
+ * pg_index_heap_checksum_scan_range
+ *    Call callback with the checksum of every entry that an index should
+ *    hold for the tuples of its table among blocks startblk up to (but not
+ *    including) endblk.
  *
- * This function aggregates checksums of all valid index tuples on a page
- * using XOR. This provides a page-level integrity check for indexes
- * that can detect:
- *    - Missing or extra index entries on a page
- *    - Corruption of index tuple ordering
- *    - Partial page writes
+ * The table is read by table_index_build_range_scan(), which evaluates the
+ * index expressions and predicate and picks the tuples an index build would
+ * include, pointing to the root of their HOT chain.  Each entry is formed
+ * the way the access method forms it and reported with the checksum that
+ * pg_index_checksum_scan_range() reports for it in the index, so that an
+ * index matches its table if the multisets of checksums of both sides are
+ * equal.
  *
  * Parameters:
- *    page:          Index page
- *    indexTupDesc:  Tuple descriptor for the index
+ *    heap:      Table of the index, opened and locked by the caller
+ *    index:     B-tree, hash, GIN or GiST index, opened and locked by the
+ *               caller
+ *    startblk:  First block of the table to visit
+ *    endblk:    Block to stop at; InvalidBlockNumber to visit all remaining
+ *               blocks
+ *    callback:  Called once per entry
+ *    arg:       Passed through to callback
+ *
+ * Notes:
+ *    - Index entries pointing to dead tuples that VACUUM has not removed
+ *      yet have no counterpart here, see pg_index_heap_dead_tids();
+ *      killed (LP_DEAD) entries are skipped on the index side
+ *    - The caller should hold at least ShareLock on the table, as an index
+ *      build does, so that neither side changes during the comparison
+ *    - Keys are compared as stored, so a key that was compressed with a
+ *      different method in the table than in the index differs
+ */
+void
+pg_index_heap_checksum_scan_range(Relation heap, Relation index,
+                                  BlockNumber startblk, BlockNumber endblk,
+                                  checksum_index_entry_callback callback,
+                                  void *arg)
+{
+    IndexHeapChecksumState state;
+    IndexInfo  *indexInfo;
+    BlockNumber nblocks;
+
+    state.callback = callback;
+    state.arg = arg;
+    state.next_block = startblk;
+    memset(&state.progress, 0, sizeof(ChecksumProgressCounter));
+    state.ntuples = 0;
+    state.nbytes = 0;
+    state.ginstate = NULL;
+    state.giststate = NULL;
+
+    switch (index->rd_rel->relam)
+    {
+        case BTREE_AM_OID:
+        case HASH_AM_OID:
+            break;
+        case GIN_AM_OID:
+            state.ginstate = palloc(sizeof(GinState));
+            initGinState(state.ginstate, index);
+            break;
+        case GIST_AM_OID:
+            state.giststate = initGISTstate(index);
+            break;
+        default:
+            ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                     errmsg("cannot verify index \"%s\" against its table",
+                            RelationGetRelationName(index)),
+                     errdetail("Index access method \"%s\" is not supported.",
+                               get_am_name(index->rd_rel->relam))));
+    }
+
+    state.tmpcxt = AllocSetContextCreate(CurrentMemoryContext,
+                                         "index checksum heap entries",
+                                         ALLOCSET_DEFAULT_SIZES);
+
+    indexInfo = BuildIndexInfo(index);
+
+    table_index_build_range_scan(heap, index, indexInfo,
+                                 false, false, false,
+                                 startblk,
+                                 endblk == InvalidBlockNumber ?
+                                 InvalidBlockNumber : endblk - startblk,
+                                 index_heap_checksum_tuple, &state, NULL);
+
+    /* Count the rest of the range as done, too */
+    nblocks = Min(endblk, RelationGetNumberOfBlocks(heap));
+    if (nblocks > state.next_block)
+        state.progress.blocks += nblocks - state.next_block;
+    pg_checksum_progress_flush(&state.progress);
+
+    /* The entries are counted against the index they were formed for */
+    pgstat_count_checksum_scan(index, state.ntuples, state.nbytes);
+
+    MemoryContextDelete(state.tmpcxt);
+    if (state.giststate != NULL)
+        freeGISTstate(state.giststate);
+    if (state.ginstate != NULL)
+        pfree(state.ginstate);
+}
+
+/*
+ * heap_chain_dead
+ *    Check whether every member of the HOT chain that starts at offset off
+ *    is HEAPTUPLE_DEAD, so that table_index_build_range_scan() reports no
+ *    entry for the chain's root although its indexes may still hold some.
+ *
+ * A chain that leads to a tuple that isn't dead is reported, at the root's
+ * TID, by an index build.
+ */
+static bool
+heap_chain_dead(Relation heap, Buffer buffer, OffsetNumber off,
+                TransactionId oldest_xmin)
+{
+    Page        page = BufferGetPage(buffer);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+
+    /* A chain can't be longer than the page, whatever t_ctid says */
+    for (int i = 0; i < maxoff; i++)
+    {
+        ItemId      itemid;
+        HeapTupleData tuple;
+
+        if (off < FirstOffsetNumber || off > maxoff)
+            break;
+        itemid = PageGetItemId(page, off);
+        if (!ItemIdIsNormal(itemid))
+            break;
+
+        tuple.t_data = (HeapTupleHeader) PageGetItem(page, itemid);
+        tuple.t_len = ItemIdGetLength(itemid);
+        tuple.t_tableOid = RelationGetRelid(heap);
+        ItemPointerSet(&tuple.t_self, BufferGetBlockNumber(buffer), off);
+
+        if (HeapTupleSatisfiesVacuum(&tuple, oldest_xmin,
+                                     buffer) != HEAPTUPLE_DEAD)
+            return false;
+        if (!HeapTupleHeaderIsHotUpdated(tuple.t_data))
+            break;
+
+        off = ItemPointerGetOffsetNumber(&tuple.t_data->t_ctid);
+    }
+
+    return true;
+}
+
+/*
+ * pg_index_heap_dead_tids
+ *    Collect the TIDs among blocks startblk up to (but not including)
+ *    endblk that the indexes of a table may still hold entries for, although
+ *    pg_index_heap_checksum_scan_range() reports none.
+ *
+ * Those are the TIDs of tuples that are dead to everyone but whose entries
+ * stay in the index until VACUUM removes them.  Leaving the entries that
+ * point to them out of the index side, by passing the result to
+ * pg_index_checksum_scan_range_ext(), makes a healthy index match its table
+ * again, while any other difference remains.
+ *
+ * Parameters:
+ *    heap:      Table, opened and locked by the caller, at least in
+ *               ShareLock mode so that VACUUM can't run concurrently
+ *    startblk:  First block to visit
+ *    endblk:    Block to stop at; InvalidBlockNumber to visit all remaining
+ *               blocks
+ *    dead_tids: Receives the TIDs
+ *    max_bytes: Memory dead_tids may use
  *
  * Returns:
- *    32-bit composite checksum for the entire page
+ *    Number of TIDs collected, or -1 if they would take more than max_bytes
  *
  * Notes:
- *    - Only valid (used and not dead) index tuples are included
- *    - The XOR operation is commutative, making the checksum
- *      order-independent but sensitive to the set of tuples
- *    - This complements but doesn't replace page-level checksums
+ *    - Call it after scanning the table: a tuple that becomes dead later
+ *      has been reported by the scan
+ *    - Dead line pointers, and roots of HOT chains (or tuples that are not
+ *      heap-only) whose members are all dead, are collected
+ *    - All-visible pages are skipped, as they have neither
  */
-uint32
-pg_index_page_checksum(Page page, TupleDesc indexTupDesc)
+int64
+pg_index_heap_dead_tids(Relation heap, BlockNumber startblk,
+                        BlockNumber endblk, TidStore *dead_tids,
+                        size_t max_bytes)
 {
-    OffsetNumber maxoff;
-    OffsetNumber offnum;
-    uint32      page_checksum = 0;
+    TransactionId oldest_xmin = GetOldestNonRemovableTransactionId(heap);
+    BufferAccessStrategy bstrategy;
+    Buffer      vmbuffer = InvalidBuffer;
+    BlockNumber nblocks;
+    OffsetNumber offsets[MaxHeapTuplesPerPage];
+    int64       ndead = 0;
 
-    /* Get the maximum offset number on this page */
-    maxoff = PageGetMaxOffsetNumber(page);
-    
-    /* Process all index tuples on the page */
-    for (offnum = FirstOffsetNumber;
-         offnum <= maxoff;
-         offnum = OffsetNumberNext(offnum))
+    nblocks = Min(endblk, RelationGetNumberOfBlocks(heap));
+    bstrategy = GetAccessStrategy(BAS_BULKREAD);
+
+    for (BlockNumber blkno = startblk; blkno < nblocks; blkno++)
     {
-        ItemId      itemId;
-        IndexTuple  itup;
-        
-        itemId = PageGetItemId(page, offnum);
-        
-        /* Skip unused or dead index tuples */
-        if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
+        Buffer      buffer;
+        Page        page;
+        OffsetNumber maxoff;
+        int         noffsets = 0;
+
+        CHECK_FOR_INTERRUPTS();
+
+        if (VM_ALL_VISIBLE(heap, blkno, &vmbuffer))
             continue;
-            
-        itup = (IndexTuple) PageGetItem(page, itemId);
-        
-        /* XOR the tuple checksum into the page checksum */
-        page_checksum ^= pg_index_tuple_checksum(itup, indexTupDesc, offnum);
+
+        buffer = ReadBufferExtended(heap, MAIN_FORKNUM, blkno, RBM_NORMAL,
+                                    bstrategy);
+        LockBuffer(buffer, BUFFER_LOCK_SHARE);
+        page = BufferGetPage(buffer);
+        maxoff = PageGetMaxOffsetNumber(page);
+
+        for (OffsetNumber off = FirstOffsetNumber;
+             off <= maxoff;
+             off = OffsetNumberNext(off))
+        {
+            ItemId      itemid = PageGetItemId(page, off);
+
+            if (ItemIdIsDead(itemid))
+                offsets[noffsets++] = off;
+            else if (ItemIdIsRedirected(itemid))
+            {
+                if (heap_chain_dead(heap, buffer, ItemIdGetRedirect(itemid),
+                                    oldest_xmin))
+                    offsets[noffsets++] = off;
+            }
+            else if (ItemIdIsNormal(itemid))
+            {
+                HeapTupleHeader htup = (HeapTupleHeader) PageGetItem(page, itemid);
+
+                /* Heap-only tuples have no index entries of their own */
+                if (!HeapTupleHeaderIsHeapOnly(htup) &&
+                    heap_chain_dead(heap, buffer, off, oldest_xmin))
+                    offsets[noffsets++] = off;
+            }
+        }
+
+        UnlockReleaseBuffer(buffer);
+
+        if (noffsets > 0)
+        {
+            TidStoreSetBlockOffsets(dead_tids, blkno, offsets, noffsets);
+            ndead += noffsets;
+
+            if (TidStoreMemoryUsage(dead_tids) > max_bytes)
+            {
+                ndead = -1;
+                break;
+            }
+        }
     }
-    
-    return page_checksum;
-}
\ No newline at end of file
+
+    if (BufferIsValid(vmbuffer))
+        ReleaseBuffer(vmbuffer);
+    FreeAccessStrategy(bstrategy);
+
+    return ndead;
+}
@@ -0,0 +1,1166 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_logical.c
+ *    Incrementally maintained logical table checksums
+ *
+ * pg_checksum_table() and friends read the whole table, so verifying a
+ * large table over and over is expensive.  For tables with the
+ * logical_checksum storage parameter set, this module instead maintains a
+ * running checksum as rows are inserted, updated and deleted, so that
+ * reading it costs O(1).
+ *
+ * The logical checksum of a table is the multiset sum, modulo 2^64, of the
+ * pg_tuple_logical_checksum64() of its rows, plus the number of rows.  Row
+ * checksums don't depend on the location or MVCC header of the row, and a
+ * sum can be decremented, so every change to the table translates into a
+ * delta: an insert adds the checksum of the new row, a delete subtracts
+ * that of the old row, and an update does both.
+ *
+ * The heap AM reports changes to pg_logical_checksum_insert() and
+ * pg_logical_checksum_delete().  They accumulate in backend-local deltas per
+ * relation and (sub)transaction level, which are merged into the parent on
+ * subtransaction commit and discarded on abort.  At top-level commit, the
+ * deltas are WAL-logged in a XLOG_LOGICAL_CHECKSUM_DELTA record just before
+ * the commit record, and added to the checksums kept in a shared hash table
+ * right after it.  Statements that replace the contents of a table wholesale
+ * (enabling the option, TRUNCATE, table rewrites) log a reset to a new value
+ * instead of a delta, and dropping the table or the option logs a drop.
+ *
+ * The shared hash table is written to a file in pg_logical at every
+ * checkpoint, along with the WAL position up to which it includes committed
+ * transactions.  Committing transactions hold LogicalChecksumCommitLock
+ * in shared mode from logging their deltas until they have applied them, and
+ * the checkpoint takes it exclusively, so that position neatly separates
+ * the transactions whose deltas are in the file from those whose aren't.
+ * At startup the file is read back, and recovery replays the deltas of the
+ * transactions that committed after that position, when it replays their
+ * commit records.
+ *
+ * Only permanent heap tables are supported.  Prepared transactions are not:
+ * their deltas would have to be carried over to COMMIT PREPARED.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_logical.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <unistd.h>
+
+#include "access/relation.h"
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "access/xloginsert.h"
+#include "miscadmin.h"
+#include "port/pg_crc32c.h"
+#include "replication/reorderbuffer.h"
+#include "storage/checksum.h"
+#include "storage/checksum_logical.h"
+#include "storage/checksum_logical_xlog.h"
+#include "storage/checksum_scan.h"
+#include "storage/checksum_tuple.h"
+#include "storage/fd.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+#define LOGICAL_CHECKSUM_CHECKPOINT_FILENAME \
+    PG_LOGICAL_DIR "/logical_checksum_checkpoint"
+#define LOGICAL_CHECKSUM_CHECKPOINT_TMPFILE \
+    LOGICAL_CHECKSUM_CHECKPOINT_FILENAME ".tmp"
+#define LOGICAL_CHECKSUM_MAGIC 0x4C43534D
+
+/* GUC variable */
+int         max_logical_checksum_relations = 1000;
+
+/* Key of the shared hash table */
+typedef struct LogicalChecksumKey
+{
+    Oid         dbid;
+    Oid         relid;
+} LogicalChecksumKey;
+
+/* Entry of the shared hash table, also the on-disk format */
+typedef struct LogicalChecksumEntry
+{
+    LogicalChecksumKey key;
+    int64       ntuples;
+    uint64      checksum;
+} LogicalChecksumEntry;
+
+/* Header of the checkpoint file, followed by the entries and a CRC32C */
+typedef struct LogicalChecksumFileHeader
+{
+    uint32      magic;
+    uint32      nentries;
+    XLogRecPtr  saved_lsn;      /* commits up to here are included */
+} LogicalChecksumFileHeader;
+
+/* Shared state besides the hash table, protected by LogicalChecksumLock */
+typedef struct LogicalChecksumCtlData
+{
+    /* Position up to which the checkpoint file read at startup is valid */
+    XLogRecPtr  restored_lsn;
+    /* End of the last commit record whose deltas were applied in recovery */
+    XLogRecPtr  applied_lsn;
+    /* Hash table entries reserved by transactions that haven't ended yet */
+    int         nreserved;
+} LogicalChecksumCtlData;
+
+static LogicalChecksumCtlData *LogicalChecksumCtl = NULL;
+static HTAB *LogicalChecksumHash = NULL;
+
+/*
+ * Change to the checksum of one relation made by the current transaction at
+ * one nesting level.  The flags are those of xl_logical_checksum_item.
+ */
+typedef struct LogicalChecksumDelta
+{
+    Oid         relid;          /* hash key */
+    uint8       flags;
+    int64       ntuples;
+    uint64      checksum;
+} LogicalChecksumDelta;
+
+/* Deltas of one (sub)transaction nesting level */
+typedef struct LogicalChecksumXactLevel
+{
+    int         nest_level;
+    struct LogicalChecksumXactLevel *prev;
+    HTAB       *deltas;
+} LogicalChecksumXactLevel;
+
+/* Innermost level with deltas, or NULL */
+static LogicalChecksumXactLevel *pendingDeltas = NULL;
+
+/* Most recently used delta, to skip the hash lookup for bulk changes */
+static LogicalChecksumDelta *lastDelta = NULL;
+
+/* Deltas logged by the committing transaction, to be applied */
+static xl_logical_checksum_delta *committingDeltas = NULL;
+
+/*
+ * Hash table entries reserved by the current transaction, and the tables
+ * they are for.  See pg_logical_checksum_enable().
+ */
+static int  nReservedEntries = 0;
+static List *reservedRelids = NIL;
+
+/* Deltas of the transactions being replayed, keyed by xid */
+typedef struct LogicalChecksumRedoEntry
+{
+    TransactionId xid;          /* hash key */
+    xl_logical_checksum_delta *deltas;
+} LogicalChecksumRedoEntry;
+
+static MemoryContext redo_context = NULL;
+static HTAB *redo_deltas = NULL;
+
+/*
+ * LogicalChecksumShmemSize
+ *    Size of the shared state.
+ */
+Size
+LogicalChecksumShmemSize(void)
+{
+    Size        size;
+
+    if (max_logical_checksum_relations == 0)
+        return 0;
+
+    size = MAXALIGN(sizeof(LogicalChecksumCtlData));
+    size = add_size(size, hash_estimate_size(max_logical_checksum_relations,
+                                             sizeof(LogicalChecksumEntry)));
+    return size;
+}
+
+/*
+ * LogicalChecksumShmemInit
+ *    Create or attach to the shared state.
+ */
+void
+LogicalChecksumShmemInit(void)
+{
+    HASHCTL     info;
+    bool        found;
+
+    if (max_logical_checksum_relations == 0)
+        return;
+
+    LogicalChecksumCtl = (LogicalChecksumCtlData *)
+        ShmemInitStruct("Logical Checksum Data",
+                        sizeof(LogicalChecksumCtlData), &found);
+    if (!found)
+    {
+        LogicalChecksumCtl->restored_lsn = InvalidXLogRecPtr;
+        LogicalChecksumCtl->applied_lsn = InvalidXLogRecPtr;
+        LogicalChecksumCtl->nreserved = 0;
+    }
+
+    info.keysize = sizeof(LogicalChecksumKey);
+    info.entrysize = sizeof(LogicalChecksumEntry);
+    LogicalChecksumHash = ShmemInitHash("Logical Checksum Hash",
+                                        max_logical_checksum_relations,
+                                        max_logical_checksum_relations,
+                                        &info,
+                                        HASH_ELEM | HASH_BLOBS |
+                                        HASH_FIXED_SIZE);
+}
+
+/*
+ * logical_checksum_delta
+ *    Find or create the delta of relid at the current nesting level.
+ */
+static LogicalChecksumDelta *
+logical_checksum_delta(Oid relid)
+{
+    int         nest_level = GetCurrentTransactionNestLevel();
+    LogicalChecksumDelta *delta;
+    bool        found;
+
+    if (lastDelta != NULL && lastDelta->relid == relid &&
+        pendingDeltas->nest_level == nest_level)
+        return lastDelta;
+
+    if (pendingDeltas == NULL || pendingDeltas->nest_level < nest_level)
+    {
+        LogicalChecksumXactLevel *level;
+        HASHCTL     ctl;
+
+        level = MemoryContextAlloc(TopTransactionContext,
+                                   sizeof(LogicalChecksumXactLevel));
+        level->nest_level = nest_level;
+        level->prev = pendingDeltas;
+
+        ctl.keysize = sizeof(Oid);
+        ctl.entrysize = sizeof(LogicalChecksumDelta);
+        ctl.hcxt = TopTransactionContext;
+        level->deltas = hash_create("Logical Checksum Deltas", 16, &ctl,
+                                    HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+        pendingDeltas = level;
+    }
+
+    delta = hash_search(pendingDeltas->deltas, &relid, HASH_ENTER, &found);
+    if (!found)
+    {
+        delta->flags = 0;
+        delta->ntuples = 0;
+        delta->checksum = 0;
+    }
+
+    lastDelta = delta;
+    return delta;
+}
+
+/*
+ * logical_checksum_combine
+ *    Fold the later change src into dst.
+ */
+static void
+logical_checksum_combine(LogicalChecksumDelta *dst,
+                         const LogicalChecksumDelta *src)
+{
+    if (src->flags & (XLLC_RESET | XLLC_DROP))
+    {
+        dst->flags = src->flags;
+        dst->ntuples = src->ntuples;
+        dst->checksum = src->checksum;
+    }
+    else
+    {
+        dst->ntuples += src->ntuples;
+        dst->checksum = pg_checksum_multiset_add64(dst->checksum,
+                                                   src->checksum);
+    }
+}
+
+/*
+ * pg_logical_checksum_insert
+ *    Account for the insertion of tuple, in the form it is stored in, into
+ *    rel.
+ */
+void
+pg_logical_checksum_insert(Relation rel, HeapTuple tuple)
+{
+    LogicalChecksumDelta *delta;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    delta = logical_checksum_delta(RelationGetRelid(rel));
+    delta->ntuples++;
+    delta->checksum =
+        pg_checksum_multiset_add64(delta->checksum,
+                                   pg_tuple_logical_checksum64(tuple->t_data,
+                                                               tuple->t_len));
+}
+
+/*
+ * pg_logical_checksum_delete
+ *    Account for the deletion of tuple from rel.
+ */
+void
+pg_logical_checksum_delete(Relation rel, HeapTuple tuple)
+{
+    LogicalChecksumDelta *delta;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    delta = logical_checksum_delta(RelationGetRelid(rel));
+    delta->ntuples--;
+    delta->checksum =
+        pg_checksum_multiset_remove64(delta->checksum,
+                                      pg_tuple_logical_checksum64(tuple->t_data,
+                                                                  tuple->t_len));
+}
+
+/*
+ * logical_checksum_reset
+ *    Replace the checksum of relid by value when the current transaction
+ *    commits.
+ */
+static void
+logical_checksum_reset(Oid relid, LogicalChecksum value)
+{
+    LogicalChecksumDelta *delta = logical_checksum_delta(relid);
+
+    delta->flags = XLLC_RESET;
+    delta->ntuples = value.ntuples;
+    delta->checksum = value.checksum;
+}
+
+/*
+ * pg_logical_checksum_truncate
+ *    Account for the truncation of rel.
+ */
+void
+pg_logical_checksum_truncate(Relation rel)
+{
+    LogicalChecksum empty = {0};
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    logical_checksum_reset(RelationGetRelid(rel), empty);
+}
+
+/* Scan callback of pg_table_logical_checksum_internal() */
+static void
+logical_checksum_page(Page page, BlockNumber blkno,
+                      const OffsetNumber *offsets, int noffsets, void *arg)
+{
+    LogicalChecksum *result = (LogicalChecksum *) arg;
+
+    for (int i = 0; i < noffsets; i++)
+    {
+        ItemId      lp = PageGetItemId(page, offsets[i]);
+        HeapTupleHeader tuple = (HeapTupleHeader) PageGetItem(page, lp);
+
+        result->checksum =
+            pg_checksum_multiset_add64(result->checksum,
+                                       pg_tuple_logical_checksum64(tuple,
+                                                                   ItemIdGetLength(lp)));
+    }
+    result->ntuples += noffsets;
+}
+
+/*
+ * pg_table_logical_checksum_internal
+ *    Compute the logical checksum of rel from scratch.
+ *
+ * Parameters:
+ *    rel:       Heap relation, opened and locked by the caller
+ *    snapshot:  Snapshot that decides which rows are visible
+ *
+ * Returns:
+ *    The logical checksum of the rows visible to snapshot, which is what
+ *    pg_logical_checksum_get() returns for a table with the logical_checksum
+ *    storage parameter once all changes are committed
+ */
+LogicalChecksum
+pg_table_logical_checksum_internal(Relation rel, Snapshot snapshot)
+{
+    LogicalChecksum result = {0};
+
+    pg_checksum_heap_scan(rel, snapshot, logical_checksum_page, &result);
+
+    return result;
+}
+
+/*
+ * pg_logical_checksum_enable
+ *    Start maintaining the logical checksum of rel, or resynchronize it.
+ *
+ * The caller must hold AccessExclusiveLock on rel, so that no one else can
+ * change it while its checksum is computed.  The checksum is computed from
+ * the rows visible to a fresh snapshot, which includes the changes made by
+ * the current transaction so far.
+ *
+ * The shared hash table entry is only created when the transaction commits,
+ * in a critical section that can't fail.  So if rel isn't tracked yet, an
+ * entry is reserved for it here, and the reservation is given back when the
+ * transaction ends; concurrent enables can't overcommit the table.
+ */
+void
+pg_logical_checksum_enable(Relation rel)
+{
+    LogicalChecksumKey key;
+    Snapshot    snapshot;
+    LogicalChecksum value;
+    bool        reserved = false;
+
+    if (LogicalChecksumHash == NULL)
+        ereport(ERROR,
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                 errmsg("logical checksums are disabled"),
+                 errhint("Set \"max_logical_checksum_relations\" to a nonzero value and restart the server.")));
+
+    if (rel->rd_rel->relpersistence != RELPERSISTENCE_PERMANENT)
+        ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                 errmsg("cannot maintain the logical checksum of temporary or unlogged table \"%s\"",
+                        RelationGetRelationName(rel))));
+
+    key.dbid = MyDatabaseId;
+    key.relid = RelationGetRelid(rel);
+
+    LWLockAcquire(LogicalChecksumLock, LW_EXCLUSIVE);
+    if (hash_search(LogicalChecksumHash, &key, HASH_FIND, NULL) == NULL &&
+        !list_member_oid(reservedRelids, key.relid))
+    {
+        if (hash_get_num_entries(LogicalChecksumHash) +
+            LogicalChecksumCtl->nreserved >= max_logical_checksum_relations)
+        {
+            LWLockRelease(LogicalChecksumLock);
+            ereport(ERROR,
+                    (errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+                     errmsg("could not maintain the logical checksum of table \"%s\"",
+                            RelationGetRelationName(rel)),
+                     errdetail("Logical checksums are already maintained or being enabled for %d tables.",
+                               max_logical_checksum_relations),
+                     errhint("Increase \"max_logical_checksum_relations\".")));
+        }
+        LogicalChecksumCtl->nreserved++;
+        nReservedEntries++;
+        reserved = true;
+    }
+    LWLockRelease(LogicalChecksumLock);
+
+    if (reserved)
+    {
+        MemoryContext oldcontext = MemoryContextSwitchTo(TopTransactionContext);
+
+        reservedRelids = lappend_oid(reservedRelids, key.relid);
+        MemoryContextSwitchTo(oldcontext);
+    }
+
+    snapshot = RegisterSnapshot(GetLatestSnapshot());
+    value = pg_table_logical_checksum_internal(rel, snapshot);
+    UnregisterSnapshot(snapshot);
+
+    logical_checksum_reset(RelationGetRelid(rel), value);
+}
+
+/*
+ * pg_logical_checksum_disable
+ *    Stop maintaining the logical checksum of relid when the current
+ *    transaction commits.
+ */
+void
+pg_logical_checksum_disable(Oid relid)
+{
+    LogicalChecksumDelta *delta;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    delta = logical_checksum_delta(relid);
+    delta->flags = XLLC_DROP;
+    delta->ntuples = 0;
+    delta->checksum = 0;
+}
+
+/*
+ * pg_logical_checksum_rewrite
+ *    Account for a rewrite of relid, which the caller holds
+ *    AccessExclusiveLock on.
+ *
+ * Rewrites don't go through heap_insert(), and may also change the stored
+ * form of the rows (e.g. ALTER COLUMN TYPE), so the checksum is simply
+ * recomputed.  A rewrite can also make a table unlogged, in which case its
+ * checksum is no longer maintained.
+ */
+void
+pg_logical_checksum_rewrite(Oid relid)
+{
+    Relation    rel;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    rel = relation_open(relid, NoLock);
+    if (RelationHasLogicalChecksum(rel))
+        pg_logical_checksum_enable(rel);
+    else
+        pg_logical_checksum_disable(relid);
+    relation_close(rel, NoLock);
+}
+
+/*
+ * pg_logical_checksum_drop_database
+ *    Forget the logical checksums of the tables of a dropped database.
+ *
+ * Dropping a database is not transactional, so neither is this.
+ */
+void
+pg_logical_checksum_drop_database(Oid dbid)
+{
+    HASH_SEQ_STATUS status;
+    LogicalChecksumEntry *entry;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    LWLockAcquire(LogicalChecksumLock, LW_EXCLUSIVE);
+    hash_seq_init(&status, LogicalChecksumHash);
+    while ((entry = hash_seq_search(&status)) != NULL)
+    {
+        if (entry->key.dbid == dbid)
+            hash_search(LogicalChecksumHash, &entry->key, HASH_REMOVE, NULL);
+    }
+    LWLockRelease(LogicalChecksumLock);
+}
+
+/*
+ * pg_logical_checksum_get
+ *    Look up the maintained logical checksum of relid in the current
+ *    database.
+ *
+ * Returns false if it is not maintained.  The result reflects all committed
+ * transactions, but not the uncommitted changes of the current one.
+ */
+bool
+pg_logical_checksum_get(Oid relid, LogicalChecksum *result)
+{
+    LogicalChecksumKey key;
+    LogicalChecksumEntry *entry;
+
+    if (LogicalChecksumHash == NULL)
+        return false;
+
+    key.dbid = MyDatabaseId;
+    key.relid = relid;
+
+    LWLockAcquire(LogicalChecksumLock, LW_SHARED);
+    entry = hash_search(LogicalChecksumHash, &key, HASH_FIND, NULL);
+    if (entry != NULL)
+    {
+        result->ntuples = entry->ntuples;
+        result->checksum = entry->checksum;
+    }
+    LWLockRelease(LogicalChecksumLock);
+
+    return entry != NULL;
+}
+
+/*
+ * logical_checksum_apply
+ *    Apply the deltas of a committed transaction to the shared hash table.
+ *
+ * The caller holds LogicalChecksumLock exclusively.  This runs in a critical
+ * section after the commit record has been written, so it must not fail.
+ * A reset of a table that is not tracked yet needs a new entry; in normal
+ * operation pg_logical_checksum_enable() has reserved one.  In recovery,
+ * the hash table can still be full if max_logical_checksum_relations is
+ * lower than on the primary.  The checksum of that table is then lost,
+ * which is reported with a WARNING, since failing here would stop the
+ * commit or recovery.
+ */
+static void
+logical_checksum_apply(xl_logical_checksum_delta *xlrec)
+{
+    for (int i = 0; i < xlrec->nitems; i++)
+    {
+        xl_logical_checksum_item *item = &xlrec->items[i];
+        LogicalChecksumKey key;
+        LogicalChecksumEntry *entry;
+
+        key.dbid = xlrec->dbid;
+        key.relid = item->relid;
+
+        if (item->flags & XLLC_DROP)
+        {
+            hash_search(LogicalChecksumHash, &key, HASH_REMOVE, NULL);
+            continue;
+        }
+
+        if (item->flags & XLLC_RESET)
+        {
+            entry = hash_search(LogicalChecksumHash, &key, HASH_ENTER_NULL,
+                                NULL);
+            if (entry == NULL)
+            {
+                ereport(WARNING,
+                        (errcode(ERRCODE_CONFIGURATION_LIMIT_EXCEEDED),
+                         errmsg("could not maintain the logical checksum of relation %u in database %u",
+                                item->relid, xlrec->dbid),
+                         errdetail("Logical checksums are already maintained for %d tables.",
+                                   max_logical_checksum_relations),
+                         errhint("Increase \"max_logical_checksum_relations\", and set the \"logical_checksum\" storage parameter of the table again.")));
+                continue;
+            }
+            entry->ntuples = item->ntuples;
+            entry->checksum = item->checksum;
+            continue;
+        }
+
+        entry = hash_search(LogicalChecksumHash, &key, HASH_FIND, NULL);
+        if (entry != NULL)
+        {
+            entry->ntuples += item->ntuples;
+            entry->checksum = pg_checksum_multiset_add64(entry->checksum,
+                                                         item->checksum);
+        }
+    }
+}
+
+/*
+ * LogicalChecksumLogDeltas
+ *    WAL-log the deltas of the committing transaction.
+ *
+ * Called by RecordTransactionCommit() just before it writes the commit
+ * record.  If there is anything to log, LogicalChecksumCommitLock is
+ * acquired here and released by LogicalChecksumApplyDeltas(), so that no
+ * checkpoint can happen in between.
+ */
+void
+LogicalChecksumLogDeltas(void)
+{
+    HASH_SEQ_STATUS status;
+    LogicalChecksumDelta *delta;
+    xl_logical_checksum_delta *xlrec;
+    long        ndeltas;
+
+    Assert(committingDeltas == NULL);
+
+    if (pendingDeltas == NULL)
+        return;
+
+    /* All subtransactions have been merged into the top level by now */
+    Assert(pendingDeltas->nest_level == 1 && pendingDeltas->prev == NULL);
+
+    ndeltas = hash_get_num_entries(pendingDeltas->deltas);
+    if (ndeltas == 0)
+        return;
+
+    /* zero, to avoid logging uninitialized padding bytes */
+    xlrec = MemoryContextAllocZero(TopTransactionContext,
+                                   SizeOfLogicalChecksumDelta +
+                                   ndeltas * sizeof(xl_logical_checksum_item));
+    xlrec->dbid = MyDatabaseId;
+    xlrec->nitems = 0;
+
+    LWLockAcquire(LogicalChecksumCommitLock, LW_SHARED);
+
+    /*
+     * Leave out the changes to tables whose checksum is not maintained, e.g.
+     * the transient tables rewrites build.  They can't start being maintained
+     * concurrently, since that requires AccessExclusiveLock on the table.
+     */
+    LWLockAcquire(LogicalChecksumLock, LW_SHARED);
+    hash_seq_init(&status, pendingDeltas->deltas);
+    while ((delta = hash_seq_search(&status)) != NULL)
+    {
+        xl_logical_checksum_item *item;
+        LogicalChecksumKey key;
+
+        key.dbid = MyDatabaseId;
+        key.relid = delta->relid;
+
+        if (!(delta->flags & XLLC_RESET) &&
+            hash_search(LogicalChecksumHash, &key, HASH_FIND, NULL) == NULL)
+            continue;
+
+        item = &xlrec->items[xlrec->nitems++];
+        item->relid = delta->relid;
+        item->flags = delta->flags;
+        item->ntuples = delta->ntuples;
+        item->checksum = delta->checksum;
+    }
+    LWLockRelease(LogicalChecksumLock);
+
+    if (xlrec->nitems == 0)
+    {
+        LWLockRelease(LogicalChecksumCommitLock);
+        return;
+    }
+
+    XLogBeginInsert();
+    XLogRegisterData(xlrec, SizeOfLogicalChecksumDelta +
+                     xlrec->nitems * sizeof(xl_logical_checksum_item));
+    (void) XLogInsert(RM_LOGICAL_CHECKSUM_ID, XLOG_LOGICAL_CHECKSUM_DELTA);
+
+    committingDeltas = xlrec;
+}
+
+/*
+ * LogicalChecksumApplyDeltas
+ *    Apply the deltas logged by LogicalChecksumLogDeltas(), once the commit
+ *    record ending at commit_end has been written.
+ *
+ * Called in a critical section.
+ */
+void
+LogicalChecksumApplyDeltas(XLogRecPtr commit_end)
+{
+    if (committingDeltas == NULL)
+        return;
+
+    LWLockAcquire(LogicalChecksumLock, LW_EXCLUSIVE);
+    logical_checksum_apply(committingDeltas);
+    LWLockRelease(LogicalChecksumLock);
+    LWLockRelease(LogicalChecksumCommitLock);
+
+    committingDeltas = NULL;
+}
+
+/*
+ * AtEOXact_LogicalChecksum
+ *    Forget the deltas of the ending transaction.
+ *
+ * On commit they have been applied by LogicalChecksumApplyDeltas() already;
+ * on abort they are simply discarded.  The memory goes away with
+ * TopTransactionContext, and an error in between logging and applying the
+ * deltas releases LogicalChecksumCommitLock along with all other LWLocks.
+ *
+ * Hash table entries reserved by pg_logical_checksum_enable() are given
+ * back either way: on commit they have been filled in by now.
+ */
+void
+AtEOXact_LogicalChecksum(bool isCommit)
+{
+    if (nReservedEntries > 0)
+    {
+        LWLockAcquire(LogicalChecksumLock, LW_EXCLUSIVE);
+        LogicalChecksumCtl->nreserved -= nReservedEntries;
+        Assert(LogicalChecksumCtl->nreserved >= 0);
+        LWLockRelease(LogicalChecksumLock);
+    }
+
+    pendingDeltas = NULL;
+    lastDelta = NULL;
+    committingDeltas = NULL;
+    nReservedEntries = 0;
+    reservedRelids = NIL;
+}
+
+/*
+ * AtEOSubXact_LogicalChecksum
+ *    Merge the deltas of a committing subtransaction into its parent, or
+ *    discard those of an aborting one.
+ */
+void
+AtEOSubXact_LogicalChecksum(bool isCommit, int nestDepth)
+{
+    LogicalChecksumXactLevel *level = pendingDeltas;
+
+    if (level == NULL || level->nest_level < nestDepth)
+        return;
+
+    Assert(level->nest_level == nestDepth);
+    pendingDeltas = level->prev;
+    lastDelta = NULL;
+
+    if (!isCommit)
+    {
+        hash_destroy(level->deltas);
+        pfree(level);
+        return;
+    }
+
+    if (pendingDeltas == NULL || pendingDeltas->nest_level < nestDepth - 1)
+    {
+        /* The parent has no deltas of its own; hand this level over */
+        level->nest_level = nestDepth - 1;
+        pendingDeltas = level;
+    }
+    else
+    {
+        HASH_SEQ_STATUS status;
+        LogicalChecksumDelta *delta;
+
+        hash_seq_init(&status, level->deltas);
+        while ((delta = hash_seq_search(&status)) != NULL)
+        {
+            LogicalChecksumDelta *parent;
+            bool        found;
+
+            parent = hash_search(pendingDeltas->deltas, &delta->relid,
+                                 HASH_ENTER, &found);
+            if (!found)
+            {
+                parent->flags = 0;
+                parent->ntuples = 0;
+                parent->checksum = 0;
+            }
+            logical_checksum_combine(parent, delta);
+        }
+        hash_destroy(level->deltas);
+        pfree(level);
+    }
+}
+
+/*
+ * AtPrepare_LogicalChecksum
+ *    Reject PREPARE TRANSACTION if the transaction changed a table whose
+ *    logical checksum is maintained.
+ */
+void
+AtPrepare_LogicalChecksum(void)
+{
+    if (pendingDeltas != NULL &&
+        hash_get_num_entries(pendingDeltas->deltas) > 0)
+        ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                 errmsg("cannot PREPARE a transaction that has modified a table with a logical checksum")));
+}
+
+/*
+ * write_checkpoint_file
+ *    Write data to the checkpoint file, PANICing on failure.
+ */
+static void
+write_checkpoint_file(int fd, const char *path, const void *data, size_t len,
+                      pg_crc32c *crc)
+{
+    errno = 0;
+    if (write(fd, data, len) != len)
+    {
+        /* if write didn't set errno, assume problem is no disk space */
+        if (errno == 0)
+            errno = ENOSPC;
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not write to file \"%s\": %m", path)));
+    }
+    if (crc != NULL)
+        COMP_CRC32C(*crc, data, len);
+}
+
+/*
+ * CheckPointLogicalChecksums
+ *    Save the shared hash table to disk.
+ *
+ * We store checkpoints in the following format:
+ * +--------+----------------------+-----+--------+
+ * | header | LogicalChecksumEntry | ... | CRC32C | EOF
+ * +--------+----------------------+-----+--------+
+ *
+ * The header holds the WAL position up to which committed transactions are
+ * included, which is made durable before the file is written.
+ */
+void
+CheckPointLogicalChecksums(void)
+{
+    const char *tmppath = LOGICAL_CHECKSUM_CHECKPOINT_TMPFILE;
+    const char *path = LOGICAL_CHECKSUM_CHECKPOINT_FILENAME;
+    LogicalChecksumFileHeader header;
+    LogicalChecksumEntry *entries;
+    LogicalChecksumEntry *entry;
+    HASH_SEQ_STATUS status;
+    int         tmpfd;
+    pg_crc32c   crc;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    entries = palloc_array(LogicalChecksumEntry,
+                           max_logical_checksum_relations);
+    memset(&header, 0, sizeof(header));
+    header.magic = LOGICAL_CHECKSUM_MAGIC;
+
+    /*
+     * Wait for the transactions that logged deltas but haven't applied them
+     * yet.  Transactions that log deltas after we release the lock write
+     * their commit record after saved_lsn, so recovery will replay them.
+     * In recovery, the startup process is the only one applying deltas, and
+     * keeps track of where it is.
+     */
+    LWLockAcquire(LogicalChecksumCommitLock, LW_EXCLUSIVE);
+    LWLockAcquire(LogicalChecksumLock, LW_SHARED);
+
+    hash_seq_init(&status, LogicalChecksumHash);
+    while ((entry = hash_seq_search(&status)) != NULL)
+    {
+        /* zero, to avoid uninitialized padding bytes */
+        memset(&entries[header.nentries], 0, sizeof(LogicalChecksumEntry));
+        entries[header.nentries].key = entry->key;
+        entries[header.nentries].ntuples = entry->ntuples;
+        entries[header.nentries].checksum = entry->checksum;
+        header.nentries++;
+    }
+
+    if (RecoveryInProgress())
+        header.saved_lsn = LogicalChecksumCtl->applied_lsn;
+    else
+        header.saved_lsn = GetXLogInsertRecPtr();
+
+    LWLockRelease(LogicalChecksumLock);
+    LWLockRelease(LogicalChecksumCommitLock);
+
+    /* make sure we only write out commits that are persistent */
+    XLogFlush(header.saved_lsn);
+
+    INIT_CRC32C(crc);
+
+    /* make sure no old temp file is remaining */
+    if (unlink(tmppath) < 0 && errno != ENOENT)
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not remove file \"%s\": %m", tmppath)));
+
+    tmpfd = OpenTransientFile(tmppath, O_CREAT | O_EXCL | O_WRONLY | PG_BINARY);
+    if (tmpfd < 0)
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not create file \"%s\": %m", tmppath)));
+
+    write_checkpoint_file(tmpfd, tmppath, &header, sizeof(header), &crc);
+    if (header.nentries > 0)
+        write_checkpoint_file(tmpfd, tmppath, entries,
+                              header.nentries * sizeof(LogicalChecksumEntry),
+                              &crc);
+    FIN_CRC32C(crc);
+    write_checkpoint_file(tmpfd, tmppath, &crc, sizeof(crc), NULL);
+
+    if (CloseTransientFile(tmpfd) != 0)
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not close file \"%s\": %m", tmppath)));
+
+    /* fsync, rename to permanent file, fsync file and directory */
+    durable_rename(tmppath, path, PANIC);
+
+    pfree(entries);
+}
+
+/*
+ * read_checkpoint_file
+ *    Read exactly len bytes from the checkpoint file, PANICing on failure.
+ */
+static void
+read_checkpoint_file(int fd, const char *path, void *data, size_t len)
+{
+    int         readBytes = read(fd, data, len);
+
+    if (readBytes != len)
+    {
+        if (readBytes < 0)
+            ereport(PANIC,
+                    (errcode_for_file_access(),
+                     errmsg("could not read file \"%s\": %m", path)));
+        else
+            ereport(PANIC,
+                    (errcode(ERRCODE_DATA_CORRUPTED),
+                     errmsg("could not read file \"%s\": read %d of %zu",
+                            path, readBytes, len)));
+    }
+}
+
+/*
+ * StartupLogicalChecksums
+ *    Restore the shared hash table saved by the last checkpoint.
+ *
+ * Recovery then replays the deltas of the transactions that committed
+ * after it was saved.
+ */
+void
+StartupLogicalChecksums(void)
+{
+    const char *path = LOGICAL_CHECKSUM_CHECKPOINT_FILENAME;
+    LogicalChecksumFileHeader header;
+    pg_crc32c   file_crc;
+    pg_crc32c   crc;
+    int         fd;
+    int         nlost = 0;
+
+    if (LogicalChecksumHash == NULL)
+        return;
+
+    fd = OpenTransientFile(path, O_RDONLY | PG_BINARY);
+
+    /* might have had max_logical_checksum_relations == 0 last run */
+    if (fd < 0 && errno == ENOENT)
+        return;
+    else if (fd < 0)
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not open file \"%s\": %m", path)));
+
+    INIT_CRC32C(crc);
+
+    read_checkpoint_file(fd, path, &header, sizeof(header));
+    COMP_CRC32C(crc, &header, sizeof(header));
+
+    if (header.magic != LOGICAL_CHECKSUM_MAGIC)
+        ereport(PANIC,
+                (errcode(ERRCODE_DATA_CORRUPTED),
+                 errmsg("logical checksum checkpoint has wrong magic %u instead of %u",
+                        header.magic, LOGICAL_CHECKSUM_MAGIC)));
+
+    /* we can skip locking here, no other access is possible */
+    for (uint32 i = 0; i < header.nentries; i++)
+    {
+        LogicalChecksumEntry disk_entry;
+        LogicalChecksumEntry *entry;
+
+        read_checkpoint_file(fd, path, &disk_entry, sizeof(disk_entry));
+        COMP_CRC32C(crc, &disk_entry, sizeof(disk_entry));
+
+        entry = hash_search(LogicalChecksumHash, &disk_entry.key,
+                            HASH_ENTER_NULL, NULL);
+        if (entry == NULL)
+        {
+            nlost++;
+            continue;
+        }
+        entry->ntuples = disk_entry.ntuples;
+        entry->checksum = disk_entry.checksum;
+    }
+
+    read_checkpoint_file(fd, path, &file_crc, sizeof(file_crc));
+    FIN_CRC32C(crc);
+    if (file_crc != crc)
+        ereport(PANIC,
+                (errcode(ERRCODE_DATA_CORRUPTED),
+                 errmsg("logical checksum checkpoint has wrong checksum %u, expected %u",
+                        crc, file_crc)));
+
+    if (CloseTransientFile(fd) != 0)
+        ereport(PANIC,
+                (errcode_for_file_access(),
+                 errmsg("could not close file \"%s\": %m", path)));
+
+    if (nlost > 0)
+        ereport(WARNING,
+                (errmsg("could not restore the logical checksums of %d tables",
+                        nlost),
+                 errhint("Increase \"max_logical_checksum_relations\", and set the \"logical_checksum\" storage parameter of the affected tables again.")));
+
+    LogicalChecksumCtl->restored_lsn = header.saved_lsn;
+    LogicalChecksumCtl->applied_lsn = header.saved_lsn;
+}
+
+/*
+ * logical_checksum_redo
+ *    Remember the deltas of a transaction until its commit or abort record
+ *    is replayed.
+ */
+void
+logical_checksum_redo(XLogReaderState *record)
+{
+    uint8       info = XLogRecGetInfo(record) & ~XLR_INFO_MASK;
+    xl_logical_checksum_delta *xlrec;
+    LogicalChecksumRedoEntry *entry;
+    TransactionId xid = XLogRecGetXid(record);
+    bool        found;
+
+    if (info != XLOG_LOGICAL_CHECKSUM_DELTA)
+        elog(PANIC, "logical_checksum_redo: unknown op code %u", info);
+
+    if (redo_deltas == NULL)
+        return;
+
+    xlrec = (xl_logical_checksum_delta *) XLogRecGetData(record);
+
+    entry = hash_search(redo_deltas, &xid, HASH_ENTER, &found);
+    if (found)
+        pfree(entry->deltas);
+    entry->deltas = MemoryContextAlloc(redo_context, XLogRecGetDataLen(record));
+    memcpy(entry->deltas, xlrec, XLogRecGetDataLen(record));
+}
+
+/*
+ * LogicalChecksumRedoCommit
+ *    Apply the deltas of xid, whose commit record ending at commit_end is
+ *    being replayed.
+ *
+ * Transactions that committed before the checkpoint file read at startup
+ * was saved are already included in it.
+ */
+void
+LogicalChecksumRedoCommit(TransactionId xid, XLogRecPtr commit_end)
+{
+    LogicalChecksumRedoEntry *entry;
+
+    if (redo_deltas == NULL || LogicalChecksumHash == NULL)
+        return;
+
+    entry = hash_search(redo_deltas, &xid, HASH_FIND, NULL);
+    if (entry == NULL)
+        return;
+
+    if (commit_end > LogicalChecksumCtl->restored_lsn)
+    {
+        LWLockAcquire(LogicalChecksumLock, LW_EXCLUSIVE);
+        logical_checksum_apply(entry->deltas);
+        LogicalChecksumCtl->applied_lsn = commit_end;
+        LWLockRelease(LogicalChecksumLock);
+    }
+
+    pfree(entry->deltas);
+    hash_search(redo_deltas, &xid, HASH_REMOVE, NULL);
+}
+
+/*
+ * LogicalChecksumRedoAbort
+ *    Forget the deltas of xid, whose abort record is being replayed.
+ */
+void
+LogicalChecksumRedoAbort(TransactionId xid)
+{
+    LogicalChecksumRedoEntry *entry;
+
+    if (redo_deltas == NULL)
+        return;
+
+    entry = hash_search(redo_deltas, &xid, HASH_FIND, NULL);
+    if (entry == NULL)
+        return;
+
+    pfree(entry->deltas);
+    hash_search(redo_deltas, &xid, HASH_REMOVE, NULL);
+}
+
+void
+logical_checksum_xlog_startup(void)
+{
+    HASHCTL     ctl;
+
+    redo_context = AllocSetContextCreate(TopMemoryContext,
+                                         "Logical checksum redo",
+                                         ALLOCSET_DEFAULT_SIZES);
+
+    ctl.keysize = sizeof(TransactionId);
+    ctl.entrysize = sizeof(LogicalChecksumRedoEntry);
+    ctl.hcxt = redo_context;
+    redo_deltas = hash_create("Logical checksum redo deltas", 64, &ctl,
+                              HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+}
+
+void
+logical_checksum_xlog_cleanup(void)
+{
+    MemoryContextDelete(redo_context);
+    redo_context = NULL;
+    redo_deltas = NULL;
+}
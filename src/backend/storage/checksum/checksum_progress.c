@@ -0,0 +1,158 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_progress.c
+ *    Progress reporting of checksum computations
+ *
+ * Table, index and database checksum functions report their progress in
+ * pg_stat_progress_checksum, through the generic backend progress
+ * machinery.  The scan helpers count the blocks, tuples and bytes they
+ * hash, and parallel workers forward their counts to the leader.
+ *
+ * Checksum scans also run on behalf of other commands, and checksum
+ * functions may be called from within a command that reports progress of
+ * its own, such as COPY (SELECT ...) TO.  Progress is therefore only
+ * reported while the backend's progress command is the checksum one, and a
+ * checksum function only starts it if no other command is being reported.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_progress.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/parallel.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum_progress.h"
+#include "utils/backend_progress.h"
+#include "utils/backend_status.h"
+#include "utils/rel.h"
+
+/* Whether this parallel worker reports progress to its leader */
+static bool checksum_progress_worker_reporting = false;
+
+/*
+ * pg_checksum_progress_begin
+ *    Start reporting the progress of a checksum function.
+ *
+ * Parameters:
+ *    command:  One of the PROGRESS_CHECKSUM_COMMAND_* values
+ *    relid:    Table or index being checksummed, InvalidOid for a database
+ *
+ * Returns:
+ *    true if reporting started, in which case the caller ends it with
+ *    pgstat_progress_end_command(); false if the backend is already
+ *    reporting the progress of something else
+ */
+bool
+pg_checksum_progress_begin(int command, Oid relid)
+{
+    if (MyBEEntry != NULL &&
+        MyBEEntry->st_progress_command != PROGRESS_COMMAND_INVALID)
+        return false;
+
+    pgstat_progress_start_command(PROGRESS_COMMAND_CHECKSUM, relid);
+    pgstat_progress_update_param(PROGRESS_CHECKSUM_COMMAND, command);
+    return true;
+}
+
+/*
+ * pg_checksum_progress_reporting
+ *    Is this backend reporting the progress of a checksum function?
+ *
+ * The leader of a parallel checksum computation passes the answer on to its
+ * workers, which call pg_checksum_progress_begin_worker() with it.
+ */
+bool
+pg_checksum_progress_reporting(void)
+{
+    if (IsParallelWorker())
+        return checksum_progress_worker_reporting;
+
+    return MyBEEntry != NULL &&
+        MyBEEntry->st_progress_command == PROGRESS_COMMAND_CHECKSUM;
+}
+
+/*
+ * pg_checksum_progress_begin_worker
+ *    Set whether a parallel worker forwards its progress to the leader.
+ */
+void
+pg_checksum_progress_begin_worker(bool report)
+{
+    Assert(IsParallelWorker());
+    checksum_progress_worker_reporting = report;
+}
+
+/*
+ * pg_checksum_progress_start_relation
+ *    Report that the leader starts scanning a relation in the given phase.
+ *
+ * The relation's blocks are added to the total, so that a function scanning
+ * several relations reports the blocks of all of them.
+ */
+void
+pg_checksum_progress_start_relation(Relation rel, int phase)
+{
+    const int   index[] = {
+        PROGRESS_CHECKSUM_PHASE,
+        PROGRESS_CHECKSUM_CURRENT_RELID
+    };
+    int64       val[2];
+
+    if (IsParallelWorker() || !pg_checksum_progress_reporting())
+        return;
+
+    val[0] = phase;
+    val[1] = RelationGetRelid(rel);
+    pgstat_progress_update_multi_param(2, index, val);
+    pgstat_progress_incr_param(PROGRESS_CHECKSUM_BLOCKS_TOTAL,
+                               RelationGetNumberOfBlocks(rel));
+}
+
+/*
+ * pg_checksum_progress_update
+ *    Set a progress parameter, if this backend reports checksum progress.
+ *
+ * Only the leader's own state, such as its phase and current relation, is
+ * set this way; parallel workers don't report it.
+ */
+void
+pg_checksum_progress_update(int index, int64 val)
+{
+    if (!IsParallelWorker() && pg_checksum_progress_reporting())
+        pgstat_progress_update_param(index, val);
+}
+
+/*
+ * pg_checksum_progress_incr
+ *    Add to a progress counter, if this backend reports checksum progress.
+ *
+ * Parallel workers add to their leader's counter.
+ */
+void
+pg_checksum_progress_incr(int index, int64 incr)
+{
+    if (incr != 0 && pg_checksum_progress_reporting())
+        pgstat_progress_parallel_incr_param(index, incr);
+}
+
+/*
+ * pg_checksum_progress_flush
+ *    Report the work counted in counter, and reset it.
+ */
+void
+pg_checksum_progress_flush(ChecksumProgressCounter *counter)
+{
+    pg_checksum_progress_incr(PROGRESS_CHECKSUM_BLOCKS_DONE, counter->blocks);
+    pg_checksum_progress_incr(PROGRESS_CHECKSUM_TUPLES_DONE, counter->tuples);
+    pg_checksum_progress_incr(PROGRESS_CHECKSUM_BYTES_DONE, counter->bytes);
+
+    counter->blocks = 0;
+    counter->tuples = 0;
+    counter->bytes = 0;
+}
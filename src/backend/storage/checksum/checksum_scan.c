@@ -0,0 +1,449 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_scan.c
+ *    Page-at-a-time heap and index scans for logical checksums
+ *
+ * Table and database checksums need every tuple visible to a snapshot, but
+ * they hash the tuple in place on its page rather than looking at the
+ * HeapTuple a regular scan returns.  Driving them from heap_getnext() means
+ * re-reading, pinning and locking the page once per tuple on top of the
+ * scan's own pin.  Instead, this module streams the blocks of the relation
+ * with a read stream, locks each page once, determines the visible tuples
+ * in one pass (the same way heap_prepare_pagescan() does) and hands all of
+ * them to a callback while the lock is still held.  Callers that need to do
+ * more than hash the tuples in place (detoast them, or return them to the
+ * executor) copy what they need in the callback and finish the work in a
+ * second callback, called once the buffer has been released.
+ *
+ * Index checksums hash the entries of every index page.  They are read the
+ * same way, through a read stream, so that the AIO subsystem can keep many
+ * reads in flight instead of the scan waiting for one block at a time.
+ *
+ * The blocks of a heap can also be divided among the participants of a parallel
+ * computation: each participant runs its own read stream over chunks of
+ * blocks claimed from a shared counter.  Since table and database checksums
+ * are commutative folds of per-tuple values, the participants' partial
+ * results can simply be combined at the end.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_scan.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/heapam.h"
+#include "access/tableam.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum_progress.h"
+#include "storage/checksum_scan.h"
+#include "storage/predicate.h"
+#include "storage/read_stream.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+/*
+ * Number of consecutive blocks a participant of a parallel scan claims at a
+ * time.  Large enough to let the read stream combine I/Os and to keep the
+ * shared counter cold, small enough to balance the load at the end.
+ */
+#define CHECKSUM_PARALLEL_CHUNK_BLOCKS 64
+
+/* Read stream callback state of a parallel scan participant */
+typedef struct ChecksumParallelStreamPrivate
+{
+    ChecksumParallelScan pscan;
+    BlockNumber next_block;     /* next block of the current chunk */
+    BlockNumber end_block;      /* end of the current chunk (exclusive) */
+} ChecksumParallelStreamPrivate;
+
+/*
+ * checksum_page_visible_tuples
+ *    Collect the offsets of the tuples on a share-locked heap page that are
+ *    visible to snapshot.
+ *
+ * Returns:
+ *    Number of visible tuples stored in offsets
+ */
+static int
+checksum_page_visible_tuples(Relation rel, Snapshot snapshot, Buffer buffer,
+                             BatchMVCCState *batchmvcc, OffsetNumber *offsets)
+{
+    Page        page = BufferGetPage(buffer);
+    BlockNumber blkno = BufferGetBlockNumber(buffer);
+    OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
+    bool        all_visible;
+    bool        check_serializable;
+    int         ntup = 0;
+    int         nvis = 0;
+
+    /* Pages of a relation being extended may not be initialized yet */
+    if (PageIsNew(page))
+        return 0;
+
+    all_visible = PageIsAllVisible(page) && !snapshot->takenDuringRecovery;
+    check_serializable = CheckForSerializableConflictOutNeeded(rel, snapshot);
+
+    for (OffsetNumber offnum = FirstOffsetNumber;
+         offnum <= maxoff;
+         offnum = OffsetNumberNext(offnum))
+    {
+        ItemId      itemId = PageGetItemId(page, offnum);
+        HeapTuple   tuple;
+
+        if (!ItemIdIsNormal(itemId))
+            continue;
+
+        tuple = &batchmvcc->tuples[ntup++];
+        tuple->t_data = (HeapTupleHeader) PageGetItem(page, itemId);
+        tuple->t_len = ItemIdGetLength(itemId);
+        tuple->t_tableOid = RelationGetRelid(rel);
+        ItemPointerSet(&tuple->t_self, blkno, offnum);
+    }
+
+    if (all_visible)
+    {
+        for (int i = 0; i < ntup; i++)
+        {
+            batchmvcc->visible[i] = true;
+            offsets[i] = ItemPointerGetOffsetNumber(&batchmvcc->tuples[i].t_self);
+        }
+        nvis = ntup;
+    }
+    else if (IsMVCCSnapshot(snapshot))
+        nvis = HeapTupleSatisfiesMVCCBatch(snapshot, buffer, ntup,
+                                           batchmvcc, offsets);
+    else
+    {
+        for (int i = 0; i < ntup; i++)
+        {
+            HeapTuple   tuple = &batchmvcc->tuples[i];
+
+            batchmvcc->visible[i] =
+                HeapTupleSatisfiesVisibility(tuple, snapshot, buffer);
+            if (batchmvcc->visible[i])
+                offsets[nvis++] = ItemPointerGetOffsetNumber(&tuple->t_self);
+        }
+    }
+
+    if (check_serializable)
+    {
+        for (int i = 0; i < ntup; i++)
+            HeapCheckForSerializableConflictOut(batchmvcc->visible[i], rel,
+                                                &batchmvcc->tuples[i],
+                                                buffer, snapshot);
+    }
+
+    return nvis;
+}
+
+/*
+ * checksum_heap_scan_stream
+ *    Hash the pages returned by a read stream callback.
+ *
+ * Returns the number of blocks read, including those without visible tuples.
+ */
+static BlockNumber
+checksum_heap_scan_stream(Relation rel, Snapshot snapshot,
+                          ReadStreamBlockNumberCB stream_cb,
+                          void *stream_private,
+                          checksum_page_callback callback,
+                          checksum_page_release_callback release, void *arg)
+{
+    BufferAccessStrategy bstrategy;
+    ReadStream *stream;
+    BatchMVCCState *batchmvcc;
+    OffsetNumber offsets[MaxHeapTuplesPerPage];
+    Buffer      buffer;
+    bool        report = pg_checksum_progress_reporting();
+    ChecksumProgressCounter progress = {0};
+    int64       ntuples = 0;
+    int64       nbytes = 0;
+    BlockNumber nblocks = 0;
+
+    if (rel->rd_tableam != GetHeapamTableAmRoutine())
+        ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                 errmsg("only heap AM is supported")));
+
+    /* Take the same predicate lock a sequential scan would */
+    PredicateLockRelation(rel, snapshot);
+
+    batchmvcc = palloc_object(BatchMVCCState);
+    bstrategy = GetAccessStrategy(BAS_BULKREAD);
+
+    /*
+     * It is safe to use batchmode as our stream callbacks take no locks.
+     */
+    stream = read_stream_begin_relation(READ_STREAM_SEQUENTIAL |
+                                        READ_STREAM_USE_BATCHING,
+                                        bstrategy,
+                                        rel,
+                                        MAIN_FORKNUM,
+                                        stream_cb,
+                                        stream_private,
+                                        0);
+
+    while ((buffer = read_stream_next_buffer(stream, NULL)) != InvalidBuffer)
+    {
+        Page        page = BufferGetPage(buffer);
+        int         nvis;
+        int64       pagebytes = 0;
+
+        CHECK_FOR_INTERRUPTS();
+
+        LockBuffer(buffer, BUFFER_LOCK_SHARE);
+
+        nvis = checksum_page_visible_tuples(rel, snapshot, buffer,
+                                            batchmvcc, offsets);
+        if (nvis > 0)
+            callback(page, BufferGetBlockNumber(buffer), offsets, nvis, arg);
+
+        for (int i = 0; i < nvis; i++)
+            pagebytes += ItemIdGetLength(PageGetItemId(page, offsets[i]));
+        ntuples += nvis;
+        nbytes += pagebytes;
+        nblocks++;
+
+        if (report)
+            pg_checksum_progress_count(&progress, 1, nvis, pagebytes);
+
+        UnlockReleaseBuffer(buffer);
+
+        if (nvis > 0 && release != NULL)
+            release(arg);
+    }
+
+    if (report)
+        pg_checksum_progress_flush(&progress);
+
+    pgstat_count_checksum_scan(rel, ntuples, nbytes);
+
+    read_stream_end(stream);
+    FreeAccessStrategy(bstrategy);
+    pfree(batchmvcc);
+
+    return nblocks;
+}
+
+/*
+ * pg_checksum_heap_scan
+ *    Call callback for every page of a heap relation, with the tuples
+ *    visible to snapshot.
+ *
+ * Parameters:
+ *    rel:       Heap relation, opened and locked by the caller
+ *    snapshot:  Snapshot that decides which tuples are visible
+ *    callback:  Called once per page, with the page share-locked
+ *    arg:       Passed through to callback
+ *
+ * Notes:
+ *    - Each block is read, pinned and locked exactly once
+ *    - Blocks are read through a bulk-read strategy so that a scan of a
+ *      large relation doesn't flush shared buffers
+ *    - Unlike a regular heap scan, pages are not pruned; a checksum scan
+ *      never modifies the relation beyond setting hint bits
+ *    - Blocks, visible tuples and their bytes are counted in
+ *      pg_stat_progress_checksum, and the tuples and bytes in
+ *      pg_stat_checksums
+ */
+void
+pg_checksum_heap_scan(Relation rel, Snapshot snapshot,
+                      checksum_page_callback callback, void *arg)
+{
+    pg_checksum_heap_scan_range(rel, snapshot, 0, InvalidBlockNumber,
+                                callback, arg);
+}
+
+/*
+ * pg_checksum_heap_scan_range
+ *    Like pg_checksum_heap_scan(), but only visit blocks startblk up to
+ *    (but not including) endblk.
+ *
+ * endblk may be InvalidBlockNumber, or beyond the end of the relation, to
+ * scan up to the end.  Returns the number of blocks read; callback is only
+ * called for those with visible tuples, so it can't count them itself.
+ */
+BlockNumber
+pg_checksum_heap_scan_range(Relation rel, Snapshot snapshot,
+                            BlockNumber startblk, BlockNumber endblk,
+                            checksum_page_callback callback, void *arg)
+{
+    return pg_checksum_heap_scan_range_ext(rel, snapshot, startblk, endblk,
+                                    callback, NULL, arg);
+}
+
+/*
+ * pg_checksum_heap_scan_range_ext
+ *    Like pg_checksum_heap_scan_range(), but also call release (if not NULL)
+ *    after every page that callback was called for has been unlocked and
+ *    released.
+ *
+ * callback should only copy out what it needs from the page, and leave any
+ * expensive or re-entrant work with it to release.
+ */
+BlockNumber
+pg_checksum_heap_scan_range_ext(Relation rel, Snapshot snapshot,
+                                BlockNumber startblk, BlockNumber endblk,
+                                checksum_page_callback callback,
+                                checksum_page_release_callback release,
+                                void *arg)
+{
+    BlockRangeReadStreamPrivate p;
+
+    p.current_blocknum = startblk;
+    p.last_exclusive = Min(endblk, RelationGetNumberOfBlocks(rel));
+
+    return checksum_heap_scan_stream(rel, snapshot, block_range_read_stream_cb,
+                                     &p, callback, release, arg);
+}
+
+/*
+ * pg_checksum_index_scan_range
+ *    Call callback for every initialized page of an index relation among
+ *    blocks startblk up to (but not including) endblk.
+ *
+ * Parameters:
+ *    rel:       Index relation, opened and locked by the caller
+ *    startblk:  First block to visit
+ *    endblk:    Block to stop at; InvalidBlockNumber, or anything beyond
+ *               the end of the relation, to visit all remaining blocks
+ *    callback:  Called once per page, with the page share-locked
+ *    arg:       Passed through to callback
+ *
+ * Notes:
+ *    - Blocks are read through a sequential read stream with a bulk-read
+ *      strategy, so that reads are issued ahead of the scan (and, with
+ *      io_method=worker or io_uring, asynchronously) without flushing
+ *      shared buffers
+ *    - New (all-zero) pages are skipped
+ *    - Blocks read are counted in pg_stat_progress_checksum; the callback
+ *      counts the tuples and bytes it hashes itself
+ */
+void
+pg_checksum_index_scan_range(Relation rel, BlockNumber startblk,
+                             BlockNumber endblk,
+                             checksum_index_page_callback callback,
+                             void *arg)
+{
+    BlockRangeReadStreamPrivate p;
+    BufferAccessStrategy bstrategy;
+    ReadStream *stream;
+    Buffer      buffer;
+    bool        report = pg_checksum_progress_reporting();
+    ChecksumProgressCounter progress = {0};
+
+    p.current_blocknum = startblk;
+    p.last_exclusive = Min(endblk, RelationGetNumberOfBlocks(rel));
+
+    bstrategy = GetAccessStrategy(BAS_BULKREAD);
+
+    /*
+     * It is safe to use batchmode as block_range_read_stream_cb takes no
+     * locks.
+     */
+    stream = read_stream_begin_relation(READ_STREAM_SEQUENTIAL |
+                                        READ_STREAM_USE_BATCHING,
+                                        bstrategy,
+                                        rel,
+                                        MAIN_FORKNUM,
+                                        block_range_read_stream_cb,
+                                        &p,
+                                        0);
+
+    while ((buffer = read_stream_next_buffer(stream, NULL)) != InvalidBuffer)
+    {
+        Page        page;
+
+        CHECK_FOR_INTERRUPTS();
+
+        LockBuffer(buffer, BUFFER_LOCK_SHARE);
+
+        page = BufferGetPage(buffer);
+        if (!PageIsNew(page))
+            callback(page, BufferGetBlockNumber(buffer), arg);
+
+        UnlockReleaseBuffer(buffer);
+
+        if (report)
+            pg_checksum_progress_count(&progress, 1, 0, 0);
+    }
+
+    if (report)
+        pg_checksum_progress_flush(&progress);
+
+    read_stream_end(stream);
+    FreeAccessStrategy(bstrategy);
+}
+
+/*
+ * pg_checksum_parallelscan_initialize
+ *    Initialize the shared state of a parallel checksum scan of rel.
+ *
+ * The number of blocks is fixed here, by the leader, so that all
+ * participants agree on it.  Blocks added later are not visible to the
+ * snapshot anyway.
+ */
+void
+pg_checksum_parallelscan_initialize(Relation rel, ChecksumParallelScan pscan)
+{
+    pscan->nblocks = RelationGetNumberOfBlocks(rel);
+    pg_atomic_init_u64(&pscan->next_block, 0);
+}
+
+/*
+ * Read stream callback of a parallel scan participant: return the next
+ * block of the current chunk, claiming a new chunk when it runs out.
+ */
+static BlockNumber
+checksum_parallel_read_stream_cb(ReadStream *stream,
+                                 void *callback_private_data,
+                                 void *per_buffer_data)
+{
+    ChecksumParallelStreamPrivate *p = callback_private_data;
+
+    if (p->next_block >= p->end_block)
+    {
+        uint64      start;
+
+        start = pg_atomic_fetch_add_u64(&p->pscan->next_block,
+                                        CHECKSUM_PARALLEL_CHUNK_BLOCKS);
+        if (start >= p->pscan->nblocks)
+            return InvalidBlockNumber;
+
+        p->next_block = (BlockNumber) start;
+        p->end_block = (BlockNumber) Min(start + CHECKSUM_PARALLEL_CHUNK_BLOCKS,
+                                         p->pscan->nblocks);
+    }
+
+    return p->next_block++;
+}
+
+/*
+ * pg_checksum_heap_scan_parallel
+ *    Like pg_checksum_heap_scan(), but only visit the blocks this
+ *    participant claims from the shared scan state pscan.
+ *
+ * Every participant (leader included) calls this with its own callback
+ * state; together they visit each block of the relation exactly once.
+ */
+void
+pg_checksum_heap_scan_parallel(Relation rel, Snapshot snapshot,
+                               ChecksumParallelScan pscan,
+                               checksum_page_callback callback, void *arg)
+{
+    ChecksumParallelStreamPrivate p;
+
+    p.pscan = pscan;
+    p.next_block = 0;
+    p.end_block = 0;
+
+    checksum_heap_scan_stream(rel, snapshot, checksum_parallel_read_stream_cb,
+                              &p, callback, NULL, arg);
+}
@@ -0,0 +1,455 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_scrubber.c
+ *    Background worker verifying logical checksums of relations
+ *
+ * The checksum scrubber continuously verifies the relations of one
+ * database, checksum_scrubber_database, so that corruption shows up without
+ * a maintenance-window pg_database_checksum() run.  Each pass over the
+ * database visits the relations that were verified longest ago first, so
+ * relations created since the last pass, and those a restart interrupted,
+ * are not starved.
+ *
+ * A relation is read in chunks of SCRUBBER_CHUNK_BLOCKS blocks, each in a
+ * transaction of its own, and its checksum is the one
+ * pg_database_checksum_manifest() reports for it if it isn't modified in the
+ * meantime.  Between chunks the scrubber sleeps as needed to keep its
+ * average read rate within checksum_scrubber_max_rate.  The result, the WAL
+ * position and the time of each verification are recorded in the
+ * cumulative statistics, where pg_stat_get_checksum_stats() shows them.  An
+ * error while verifying a relation is counted there too, and the scrubber
+ * moves on to the next one.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_scrubber.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/heapam.h"
+#include "access/relation.h"
+#include "access/table.h"
+#include "access/tableam.h"
+#include "access/xact.h"
+#include "access/xlog.h"
+#include "catalog/pg_class.h"
+#include "miscadmin.h"
+#include "pgstat.h"
+#include "portability/instr_time.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/interrupt.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum_database.h"
+#include "storage/checksum_scrubber.h"
+#include "storage/latch.h"
+#include "tcop/tcopprot.h"
+#include "utils/guc.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+/* Number of blocks read between two rate limiting delays (1MB by default) */
+#define SCRUBBER_CHUNK_BLOCKS   128
+
+/* GUCs */
+char       *checksum_scrubber_database = "";
+int         checksum_scrubber_max_rate = 8192;
+int         checksum_scrubber_naptime = 60;
+
+/*
+ * A relation to verify in the current pass, and when it was last verified
+ * or failed to be (0 if never).
+ */
+typedef struct ScrubberRelation
+{
+    Oid         relid;
+    TimestampTz last_verified;
+} ScrubberRelation;
+
+/* Rate limiting: bytes read since scrubber_start */
+static instr_time scrubber_start;
+static int64 scrubber_bytes = 0;
+
+/*
+ * scrubber_reset_rate
+ *    Start measuring the read rate afresh.
+ *
+ * Called at the start of each pass, so that time spent sleeping between
+ * passes doesn't allow a burst of reads, and when the rate limit changes.
+ */
+static void
+scrubber_reset_rate(void)
+{
+    INSTR_TIME_SET_CURRENT(scrubber_start);
+    scrubber_bytes = 0;
+}
+
+/*
+ * scrubber_process_interrupts
+ *    Handle interrupts and configuration reloads.
+ */
+static void
+scrubber_process_interrupts(void)
+{
+    CHECK_FOR_INTERRUPTS();
+
+    if (ConfigReloadPending)
+    {
+        int         old_max_rate = checksum_scrubber_max_rate;
+
+        ConfigReloadPending = false;
+        ProcessConfigFile(PGC_SIGHUP);
+
+        if (checksum_scrubber_max_rate != old_max_rate)
+            scrubber_reset_rate();
+    }
+}
+
+/*
+ * scrubber_delay
+ *    Account for nblocks blocks just read, and sleep if the scrubber is
+ *    reading faster than checksum_scrubber_max_rate.
+ */
+static void
+scrubber_delay(BlockNumber nblocks)
+{
+    instr_time  elapsed;
+    double      target_ms;
+    double      elapsed_ms;
+
+    scrubber_process_interrupts();
+
+    if (checksum_scrubber_max_rate <= 0)
+        return;
+
+    scrubber_bytes += (int64) nblocks * BLCKSZ;
+
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, scrubber_start);
+    elapsed_ms = INSTR_TIME_GET_MILLISEC(elapsed);
+    target_ms = (double) scrubber_bytes * 1000.0 /
+        ((double) checksum_scrubber_max_rate * 1024.0);
+
+    if (target_ms > elapsed_ms)
+    {
+        (void) WaitLatch(MyLatch,
+                         WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+                         (long) (target_ms - elapsed_ms),
+                         WAIT_EVENT_CHECKSUM_SCRUBBER_DELAY);
+        ResetLatch(MyLatch);
+        scrubber_process_interrupts();
+    }
+}
+
+/*
+ * Sort relations by the time of their last verification, oldest first.
+ */
+static int
+scrubber_relation_cmp(const void *a, const void *b)
+{
+    const ScrubberRelation *ra = (const ScrubberRelation *) a;
+    const ScrubberRelation *rb = (const ScrubberRelation *) b;
+
+    if (ra->last_verified != rb->last_verified)
+        return (ra->last_verified < rb->last_verified) ? -1 : 1;
+    if (ra->relid != rb->relid)
+        return (ra->relid < rb->relid) ? -1 : 1;
+    return 0;
+}
+
+/*
+ * scrubber_collect_relations
+ *    List the relations of the database to verify, in the order to verify
+ *    them.
+ *
+ * Those are the relations pg_database_checksum() covers with
+ * include_system and include_toast: tables, indexes, materialized views,
+ * sequences and TOAST tables that are neither unlogged nor temporary.  The
+ * result is allocated in context.
+ */
+static ScrubberRelation *
+scrubber_collect_relations(MemoryContext context, int *nrelations)
+{
+    ScrubberRelation *relations;
+    int         maxrelations = 1024;
+    int         n = 0;
+    Relation    pg_class_rel;
+    TableScanDesc scan;
+    HeapTuple   classTuple;
+
+    relations = MemoryContextAlloc(context,
+                                   sizeof(ScrubberRelation) * maxrelations);
+
+    pg_class_rel = table_open(RelationRelationId, AccessShareLock);
+    scan = table_beginscan_catalog(pg_class_rel, 0, NULL);
+
+    while ((classTuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
+    {
+        Form_pg_class classForm = (Form_pg_class) GETSTRUCT(classTuple);
+        PgStat_StatChecksumEntry *checksumentry;
+
+        if (classForm->relkind != RELKIND_RELATION &&
+            classForm->relkind != RELKIND_INDEX &&
+            classForm->relkind != RELKIND_MATVIEW &&
+            classForm->relkind != RELKIND_SEQUENCE &&
+            classForm->relkind != RELKIND_TOASTVALUE)
+            continue;
+
+        if (classForm->relpersistence != RELPERSISTENCE_PERMANENT)
+            continue;
+
+        if (n >= maxrelations)
+        {
+            maxrelations *= 2;
+            relations = repalloc(relations,
+                                 sizeof(ScrubberRelation) * maxrelations);
+        }
+
+        checksumentry = pgstat_fetch_stat_checksumentry(classForm->oid);
+        relations[n].relid = classForm->oid;
+        relations[n].last_verified =
+            checksumentry ? Max(checksumentry->last_verified_time,
+                                checksumentry->last_failure_time) : 0;
+        n++;
+    }
+
+    table_endscan(scan);
+    table_close(pg_class_rel, AccessShareLock);
+
+    qsort(relations, n, sizeof(ScrubberRelation), scrubber_relation_cmp);
+
+    *nrelations = n;
+    return relations;
+}
+
+/*
+ * scrubber_scan_relation
+ *    Compute the checksum of one relation and record it.
+ *
+ * Each chunk is read in a transaction of its own, with its own snapshot and
+ * lock, and the scrubber sleeps for rate limiting outside of it, so that
+ * verifying a large relation neither holds back the xmin horizon nor blocks
+ * DDL on the relation for the whole time.  The WAL insert position at the
+ * start of the first chunk is recorded as the position the result is valid
+ * for; the checksum is the one pg_database_checksum_manifest() reports if
+ * the relation doesn't change while it's read.  Relations dropped or
+ * rewritten in the meantime are left for the next pass.
+ */
+static void
+scrubber_scan_relation(Oid relid)
+{
+    XLogRecPtr  lsn = InvalidXLogRecPtr;
+    RelFileNumber relnumber = InvalidRelFileNumber;
+    uint64      checksum = 0;
+    char        activity[NAMEDATALEN * 2 + 32];
+
+    for (BlockNumber startblk = 0;; startblk += SCRUBBER_CHUNK_BLOCKS)
+    {
+        Relation    rel;
+        BlockNumber nblocks;
+        BlockNumber endblk = startblk + SCRUBBER_CHUNK_BLOCKS;
+        uint64      ntuples;
+        bool        last;
+
+        StartTransactionCommand();
+        PushActiveSnapshot(GetTransactionSnapshot());
+
+        rel = try_relation_open(relid, AccessShareLock);
+        if (rel == NULL ||
+            (startblk > 0 && rel->rd_locator.relNumber != relnumber))
+        {
+            if (rel != NULL)
+                relation_close(rel, AccessShareLock);
+            PopActiveSnapshot();
+            CommitTransactionCommand();
+            return;
+        }
+
+        if (startblk == 0)
+        {
+            lsn = GetXLogInsertRecPtr();
+            relnumber = rel->rd_locator.relNumber;
+
+            snprintf(activity, sizeof(activity), "checksum scrubber: %s.%s",
+                     get_namespace_name(RelationGetNamespace(rel)),
+                     RelationGetRelationName(rel));
+            pgstat_report_activity(STATE_RUNNING, activity);
+        }
+
+        /*
+         * The last chunk is open-ended, so that blocks added while the
+         * relation is read are covered, as they are by
+         * pg_database_checksum().
+         */
+        nblocks = RelationGetNumberOfBlocks(rel);
+        last = (endblk >= nblocks);
+
+        checksum ^= pg_relation_checksum_range(rel, startblk,
+                                               last ? InvalidBlockNumber : endblk,
+                                               CHECKSUM_AGGREGATE_XOR,
+                                               &ntuples);
+
+        /* Report while the lock keeps DROP from removing the stats first */
+        if (last)
+            pgstat_report_checksum_scrub(relid, checksum, lsn);
+
+        relation_close(rel, AccessShareLock);
+        PopActiveSnapshot();
+        CommitTransactionCommand();
+
+        if (last)
+        {
+            scrubber_delay(nblocks > startblk ? nblocks - startblk : 0);
+            break;
+        }
+        scrubber_delay(SCRUBBER_CHUNK_BLOCKS);
+    }
+}
+
+/*
+ * scrubber_verify_relation
+ *    Verify one relation, recording an error instead of exiting.
+ *
+ * An error, such as a page checksum failure, is reported, counted in the
+ * relation's scrub_failures and otherwise ignored; the failure time keeps
+ * the relation from being the first one retried by the next pass.
+ */
+static void
+scrubber_verify_relation(Oid relid)
+{
+    MemoryContext oldcontext = CurrentMemoryContext;
+    volatile bool failed = false;
+
+    PG_TRY();
+    {
+        scrubber_scan_relation(relid);
+    }
+    PG_CATCH();
+    {
+        HOLD_INTERRUPTS();
+        MemoryContextSwitchTo(oldcontext);
+
+        errcontext("checksum scrubber verifying relation with OID %u", relid);
+        EmitErrorReport();
+
+        AbortOutOfAnyTransaction();
+        FlushErrorState();
+        RESUME_INTERRUPTS();
+
+        failed = true;
+    }
+    PG_END_TRY();
+
+    if (failed)
+    {
+        Relation    rel;
+
+        StartTransactionCommand();
+        rel = try_relation_open(relid, AccessShareLock);
+        if (rel != NULL)
+        {
+            pgstat_report_checksum_scrub_failure(relid);
+            relation_close(rel, AccessShareLock);
+        }
+        CommitTransactionCommand();
+    }
+
+    pgstat_report_activity(STATE_IDLE, NULL);
+    pgstat_report_stat(false);
+}
+
+/*
+ * scrubber_pass
+ *    Verify every relation of the database once.
+ */
+static void
+scrubber_pass(MemoryContext context)
+{
+    ScrubberRelation *relations;
+    int         nrelations;
+
+    scrubber_reset_rate();
+
+    StartTransactionCommand();
+    relations = scrubber_collect_relations(context, &nrelations);
+    CommitTransactionCommand();
+
+    for (int i = 0; i < nrelations; i++)
+    {
+        scrubber_verify_relation(relations[i].relid);
+        scrubber_process_interrupts();
+    }
+
+    MemoryContextReset(context);
+}
+
+/*
+ * ChecksumScrubberRegister
+ *    Register the checksum scrubber background worker, if
+ *    checksum_scrubber_database is set.
+ */
+void
+ChecksumScrubberRegister(void)
+{
+    BackgroundWorker bgw;
+
+    if (checksum_scrubber_database[0] == '\0' || IsBinaryUpgrade)
+        return;
+
+    memset(&bgw, 0, sizeof(bgw));
+    bgw.bgw_flags = BGWORKER_SHMEM_ACCESS |
+        BGWORKER_BACKEND_DATABASE_CONNECTION;
+    bgw.bgw_start_time = BgWorkerStart_RecoveryFinished;
+    snprintf(bgw.bgw_library_name, MAXPGPATH, "postgres");
+    snprintf(bgw.bgw_function_name, BGW_MAXLEN, "ChecksumScrubberMain");
+    snprintf(bgw.bgw_name, BGW_MAXLEN, "checksum scrubber");
+    snprintf(bgw.bgw_type, BGW_MAXLEN, "checksum scrubber");
+    bgw.bgw_restart_time = 60;
+    bgw.bgw_notify_pid = 0;
+    bgw.bgw_main_arg = (Datum) 0;
+
+    RegisterBackgroundWorker(&bgw);
+}
+
+/*
+ * ChecksumScrubberMain
+ *    Main loop of the checksum scrubber.
+ */
+void
+ChecksumScrubberMain(Datum main_arg)
+{
+    MemoryContext pass_context;
+
+    /* Establish signal handlers. */
+    pqsignal(SIGHUP, SignalHandlerForConfigReload);
+    pqsignal(SIGTERM, die);
+    BackgroundWorkerUnblockSignals();
+
+    BackgroundWorkerInitializeConnection(checksum_scrubber_database, NULL, 0);
+
+    ereport(DEBUG1,
+            (errmsg_internal("checksum scrubber started for database \"%s\"",
+                             checksum_scrubber_database)));
+
+    pass_context = AllocSetContextCreate(TopMemoryContext,
+                                         "Checksum Scrubber",
+                                         ALLOCSET_DEFAULT_SIZES);
+
+    for (;;)
+    {
+        scrubber_pass(pass_context);
+
+        (void) WaitLatch(MyLatch,
+                         WL_LATCH_SET | WL_TIMEOUT | WL_EXIT_ON_PM_DEATH,
+                         checksum_scrubber_naptime * 1000L,
+                         WAIT_EVENT_CHECKSUM_SCRUBBER_MAIN);
+        ResetLatch(MyLatch);
+        scrubber_process_interrupts();
+    }
+}
@@ -0,0 +1,425 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_table.c
+ *    Table-level checksum implementation
+ *
+ * A table checksum combines the checksums of all tuples visible to the
+ * active snapshot, either by XOR or by multiset sum (see ChecksumAggregate).
+ * Both are commutative and associative, so the table can be split into
+ * arbitrary pieces whose partial checksums are combined afterwards.  Large
+ * tables are therefore scanned in parallel: the leader launches up to
+ * max_parallel_workers_per_gather workers, every participant (the leader
+ * included) hashes the block chunks it claims from a shared counter, and the
+ * partial results are merged in shared memory.  The result is identical to
+ * that of a serial scan.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_table.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/parallel.h"
+#include "access/relation.h"
+#include "executor/instrument.h"
+#include "miscadmin.h"
+#include "optimizer/cost.h"
+#include "optimizer/paths.h"
+#include "pgstat.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum_progress.h"
+#include "storage/checksum_scan.h"
+#include "storage/checksum_table.h"
+#include "storage/checksum_tuple.h"
+#include "storage/spin.h"
+#include "tcop/tcopprot.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+/* Magic numbers for parallel state sharing */
+#define PARALLEL_KEY_CHECKSUM_SHARED    UINT64CONST(0xC5C0000000000001)
+#define PARALLEL_KEY_QUERY_TEXT         UINT64CONST(0xC5C0000000000002)
+#define PARALLEL_KEY_WAL_USAGE          UINT64CONST(0xC5C0000000000003)
+#define PARALLEL_KEY_BUFFER_USAGE       UINT64CONST(0xC5C0000000000004)
+
+/*
+ * State of a table checksum computation, passed to checksum_table_page().
+ * Each participant of a parallel computation has its own.
+ */
+typedef struct ChecksumTableState
+{
+    bool        include_header;
+    ChecksumWidth width;
+    ChecksumAggregate aggregate;
+    pg_checksum128 checksum;
+} ChecksumTableState;
+
+/*
+ * Shared state of a parallel table checksum computation.
+ */
+typedef struct ChecksumTableShared
+{
+    /* Immutable state, set up by the leader */
+    Oid         reloid;
+    bool        include_header;
+    ChecksumWidth width;
+    ChecksumAggregate aggregate;
+    uint64      queryid;
+    bool        report_progress;    /* forward progress to the leader? */
+
+    /* Combined partial results of the participants that are done */
+    slock_t     mutex;
+    pg_checksum128 checksum;
+
+    /* Block allocation of the heap scan */
+    ChecksumParallelScanData pscan;
+} ChecksumTableShared;
+
+/*
+ * checksum_table_combine
+ *    Combine a tuple checksum, or a partial table checksum, into checksum.
+ *
+ * For the multiset aggregate the full 128-bit sum is kept even for 64-bit
+ * tuple checksums; the carry into the high half doesn't affect the low one.
+ */
+static inline void
+checksum_table_combine(ChecksumAggregate aggregate, pg_checksum128 *checksum,
+                       pg_checksum128 value)
+{
+    if (aggregate == CHECKSUM_AGGREGATE_MULTISET)
+        *checksum = pg_checksum_multiset_add128(*checksum, value);
+    else
+    {
+        checksum->hi ^= value.hi;
+        checksum->lo ^= value.lo;
+    }
+}
+
+/*
+ * checksum_table_page
+ *    Combine the checksums of the visible tuples of one heap page into the
+ *    table checksum.
+ */
+static void
+checksum_table_page(Page page, BlockNumber blkno,
+                    const OffsetNumber *offsets, int noffsets, void *arg)
+{
+    ChecksumTableState *state = (ChecksumTableState *) arg;
+
+    for (int i = 0; i < noffsets; i++)
+    {
+        OffsetNumber offnum = offsets[i];
+        pg_checksum128 tuple_checksum = {0, 0};
+
+        switch (state->width)
+        {
+            case CHECKSUM_WIDTH_32:
+                Assert(state->aggregate == CHECKSUM_AGGREGATE_XOR);
+                tuple_checksum.lo = pg_tuple_checksum(page, offnum, blkno,
+                                                      state->include_header);
+                break;
+            case CHECKSUM_WIDTH_64:
+                tuple_checksum.lo = pg_tuple_checksum64(page, offnum, blkno,
+                                                        state->include_header);
+                break;
+            case CHECKSUM_WIDTH_128:
+                tuple_checksum = pg_tuple_checksum128(page, offnum, blkno,
+                                                      state->include_header);
+                break;
+        }
+
+        checksum_table_combine(state->aggregate, &state->checksum,
+                               tuple_checksum);
+    }
+}
+
+/*
+ * checksum_table_parallel_workers
+ *    Decide how many workers to use for checksumming rel.
+ *
+ * Temporary tables are always checksummed serially.  Otherwise, the
+ * parallel_workers reloption is honored if set; if not, the number grows
+ * with the logarithm of the table size, like for a parallel sequential
+ * scan.  Either way, max_parallel_workers_per_gather is the upper limit.
+ */
+static int
+checksum_table_parallel_workers(Relation rel)
+{
+    BlockNumber nblocks;
+    int         nworkers;
+
+    /*
+     * We can't launch workers if we are one, and shouldn't from the leader
+     * of a parallel query either.
+     */
+    if (IsInParallelMode() || max_parallel_workers_per_gather == 0)
+        return 0;
+
+    /* Workers can't read our local buffers */
+    if (RelationUsesLocalBuffers(rel))
+        return 0;
+
+    nworkers = RelationGetParallelWorkers(rel, -1);
+    if (nworkers == -1)
+    {
+        int         threshold;
+
+        nblocks = RelationGetNumberOfBlocks(rel);
+        if (nblocks < (BlockNumber) min_parallel_table_scan_size)
+            return 0;
+
+        nworkers = 1;
+        threshold = Max(min_parallel_table_scan_size, 1);
+        while (nblocks >= (BlockNumber) (threshold * 3))
+        {
+            nworkers++;
+            threshold *= 3;
+            if (threshold > INT_MAX / 3)
+                break;          /* avoid overflow */
+        }
+    }
+
+    return Min(nworkers, max_parallel_workers_per_gather);
+}
+
+/*
+ * checksum_table_parallel_scan
+ *    Participate in a parallel table checksum computation, and add this
+ *    participant's partial result to the shared one.
+ */
+static void
+checksum_table_parallel_scan(Relation rel, ChecksumTableShared *shared)
+{
+    ChecksumTableState state;
+
+    state.include_header = shared->include_header;
+    state.width = shared->width;
+    state.aggregate = shared->aggregate;
+    state.checksum.hi = 0;
+    state.checksum.lo = 0;
+
+    pg_checksum_heap_scan_parallel(rel, GetActiveSnapshot(), &shared->pscan,
+                                   checksum_table_page, &state);
+
+    SpinLockAcquire(&shared->mutex);
+    checksum_table_combine(shared->aggregate, &shared->checksum,
+                           state.checksum);
+    SpinLockRelease(&shared->mutex);
+}
+
+/*
+ * checksum_table_parallel
+ *    Compute the checksum of rel with the help of up to nworkers parallel
+ *    workers.
+ *
+ * Returns false, without doing any work, if no dynamic shared memory is
+ * available; the caller then falls back to a serial scan.
+ */
+static bool
+checksum_table_parallel(Relation rel, ChecksumTableState *state, int nworkers)
+{
+    ParallelContext *pcxt;
+    ChecksumTableShared *shared;
+    WalUsage   *walusage;
+    BufferUsage *bufferusage;
+    int         querylen;
+
+    EnterParallelMode();
+    pcxt = CreateParallelContext("postgres", "checksum_table_parallel_main",
+                                 nworkers);
+
+    /* Estimate the size of all shared state */
+    shm_toc_estimate_chunk(&pcxt->estimator, sizeof(ChecksumTableShared));
+    shm_toc_estimate_keys(&pcxt->estimator, 1);
+    shm_toc_estimate_chunk(&pcxt->estimator,
+                           mul_size(sizeof(WalUsage), pcxt->nworkers));
+    shm_toc_estimate_keys(&pcxt->estimator, 1);
+    shm_toc_estimate_chunk(&pcxt->estimator,
+                           mul_size(sizeof(BufferUsage), pcxt->nworkers));
+    shm_toc_estimate_keys(&pcxt->estimator, 1);
+    if (debug_query_string)
+    {
+        querylen = strlen(debug_query_string);
+        shm_toc_estimate_chunk(&pcxt->estimator, querylen + 1);
+        shm_toc_estimate_keys(&pcxt->estimator, 1);
+    }
+    else
+        querylen = 0;           /* keep compiler quiet */
+
+    InitializeParallelDSM(pcxt);
+
+    /* If no DSM segment was available, back out (do serial scan) */
+    if (pcxt->seg == NULL)
+    {
+        DestroyParallelContext(pcxt);
+        ExitParallelMode();
+        return false;
+    }
+
+    shared = (ChecksumTableShared *) shm_toc_allocate(pcxt->toc,
+                                                      sizeof(ChecksumTableShared));
+    shared->reloid = RelationGetRelid(rel);
+    shared->include_header = state->include_header;
+    shared->width = state->width;
+    shared->aggregate = state->aggregate;
+    shared->queryid = pgstat_get_my_query_id();
+    shared->report_progress = pg_checksum_progress_reporting();
+    SpinLockInit(&shared->mutex);
+    shared->checksum = state->checksum;
+    pg_checksum_parallelscan_initialize(rel, &shared->pscan);
+    shm_toc_insert(pcxt->toc, PARALLEL_KEY_CHECKSUM_SHARED, shared);
+
+    if (debug_query_string)
+    {
+        char       *sharedquery;
+
+        sharedquery = (char *) shm_toc_allocate(pcxt->toc, querylen + 1);
+        memcpy(sharedquery, debug_query_string, querylen + 1);
+        shm_toc_insert(pcxt->toc, PARALLEL_KEY_QUERY_TEXT, sharedquery);
+    }
+
+    walusage = shm_toc_allocate(pcxt->toc,
+                                mul_size(sizeof(WalUsage), pcxt->nworkers));
+    shm_toc_insert(pcxt->toc, PARALLEL_KEY_WAL_USAGE, walusage);
+    bufferusage = shm_toc_allocate(pcxt->toc,
+                                   mul_size(sizeof(BufferUsage), pcxt->nworkers));
+    shm_toc_insert(pcxt->toc, PARALLEL_KEY_BUFFER_USAGE, bufferusage);
+
+    LaunchParallelWorkers(pcxt);
+
+    /*
+     * Join the scan ourselves.  This also covers the case that no worker
+     * could be launched at all.
+     */
+    checksum_table_parallel_scan(rel, shared);
+
+    pg_checksum_progress_update(PROGRESS_CHECKSUM_PHASE,
+                                PROGRESS_CHECKSUM_PHASE_WAIT_WORKERS);
+    WaitForParallelWorkersToFinish(pcxt);
+
+    for (int i = 0; i < pcxt->nworkers_launched; i++)
+        InstrAccumParallelQuery(&bufferusage[i], &walusage[i]);
+
+    state->checksum = shared->checksum;
+
+    DestroyParallelContext(pcxt);
+    ExitParallelMode();
+
+    return true;
+}
+
+/*
+ * checksum_table_parallel_main
+ *    Entry point of a parallel table checksum worker.
+ */
+void
+checksum_table_parallel_main(dsm_segment *seg, shm_toc *toc)
+{
+    ChecksumTableShared *shared;
+    Relation    rel;
+    WalUsage   *walusage;
+    BufferUsage *bufferusage;
+
+    /* Set debug_query_string for individual workers first */
+    debug_query_string = shm_toc_lookup(toc, PARALLEL_KEY_QUERY_TEXT, true);
+
+    /* Report the query string from leader */
+    pgstat_report_activity(STATE_RUNNING, debug_query_string);
+
+    shared = shm_toc_lookup(toc, PARALLEL_KEY_CHECKSUM_SHARED, false);
+
+    /* Track query ID */
+    pgstat_report_query_id(shared->queryid, false);
+
+    pg_checksum_progress_begin_worker(shared->report_progress);
+
+    rel = relation_open(shared->reloid, AccessShareLock);
+
+    /* Prepare to track buffer usage during parallel execution */
+    InstrStartParallelQuery();
+
+    checksum_table_parallel_scan(rel, shared);
+
+    /* Report WAL/buffer usage during parallel execution */
+    bufferusage = shm_toc_lookup(toc, PARALLEL_KEY_BUFFER_USAGE, false);
+    walusage = shm_toc_lookup(toc, PARALLEL_KEY_WAL_USAGE, false);
+    InstrEndParallelQuery(&bufferusage[ParallelWorkerNumber],
+                          &walusage[ParallelWorkerNumber]);
+
+    relation_close(rel, AccessShareLock);
+}
+
+/*
+ * pg_table_checksum_internal
+ *    Combine the checksums of all tuples of a table.
+ *
+ * Tuple checksums of the requested width are computed with
+ * pg_tuple_checksum(), pg_tuple_checksum64() or pg_tuple_checksum128(), and
+ * combined by XOR or, for the 64- and 128-bit widths, by multiset sum (see
+ * ChecksumAggregate).
+ *
+ * Parameters:
+ *    reloid:          OID of the table
+ *    include_header:  Whether tuple headers are part of the tuple checksums
+ *    width:           Width of the tuple checksums
+ *    aggregate:       How to combine the tuple checksums
+ *
+ * Returns:
+ *    The table checksum; 32- and 64-bit results are in the low half
+ *
+ * Notes:
+ *    - The table is read a page at a time with pg_checksum_heap_scan(), so
+ *      each block is pinned and locked only once however many tuples it
+ *      holds
+ *    - Tables large enough for a parallel sequential scan are checksummed
+ *      by parallel workers, subject to the same settings
+ *    - Progress is reported in pg_stat_progress_checksum, unless the
+ *      backend is already reporting another command's
+ */
+pg_checksum128
+pg_table_checksum_internal(Oid reloid, bool include_header,
+                           ChecksumWidth width, ChecksumAggregate aggregate)
+{
+    Relation    rel;
+    ChecksumTableState state;
+    int         nworkers;
+    bool        progress;
+    instr_time  start;
+
+    INSTR_TIME_SET_CURRENT(start);
+
+    state.include_header = include_header;
+    state.width = width;
+    state.aggregate = aggregate;
+    state.checksum.hi = 0;
+    state.checksum.lo = 0;
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_TABLE,
+                                          reloid);
+    pg_checksum_progress_start_relation(rel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_TABLE);
+
+    /* Hash every tuple visible to the current snapshot */
+    nworkers = checksum_table_parallel_workers(rel);
+    if (nworkers == 0 || !checksum_table_parallel(rel, &state, nworkers))
+        pg_checksum_heap_scan(rel, GetActiveSnapshot(), checksum_table_page,
+                              &state);
+
+    if (progress)
+        pgstat_progress_end_command();
+
+    pgstat_report_checksum_run(reloid, start, (int64) state.checksum.lo,
+                               false);
+
+    relation_close(rel, AccessShareLock);
+
+    return state.checksum;
+}
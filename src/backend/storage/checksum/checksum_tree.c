@@ -0,0 +1,236 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_tree.c
+ *    Merkle tree checksums over block ranges of a table
+ *
+ * A table checksum tells whether two copies of a table differ, but not
+ * where.  A checksum tree divides the table into leaves of leaf_blocks
+ * consecutive heap blocks each.  The checksum of a leaf is derived from the
+ * multiset sum of the 64-bit checksums of its visible tuples, and the
+ * checksum of an inner node is a hash of the checksums of its (up to
+ * fanout) children.  Two copies can compare their roots and descend only
+ * into the subtrees whose checksums differ, which localizes a difference
+ * in O(fanout * log(n)) node comparisons.
+ *
+ * Since leaves are keyed by block number, the trees of two copies are only
+ * comparable if their tuples are at the same locations, as on a physical
+ * replica.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/backend/storage/checksum/checksum_tree.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/relation.h"
+#include "port/pg_bswap.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum.h"
+#include "storage/checksum_scan.h"
+#include "storage/checksum_tree.h"
+#include "storage/checksum_tuple.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+/* State of the leaf scan, passed to checksum_tree_page() */
+typedef struct ChecksumTreeState
+{
+    BlockNumber leaf_blocks;
+    ChecksumTreeNode *leaves;
+} ChecksumTreeState;
+
+/*
+ * checksum_tree_page
+ *    Add the checksums of the visible tuples of one heap page to the sum of
+ *    the leaf the page belongs to.
+ */
+static void
+checksum_tree_page(Page page, BlockNumber blkno,
+                   const OffsetNumber *offsets, int noffsets, void *arg)
+{
+    ChecksumTreeState *state = (ChecksumTreeState *) arg;
+    ChecksumTreeNode *leaf = &state->leaves[blkno / state->leaf_blocks];
+
+    for (int i = 0; i < noffsets; i++)
+        leaf->checksum =
+            pg_checksum_multiset_add64(leaf->checksum,
+                                       pg_tuple_checksum64(page, offsets[i],
+                                                           blkno, false));
+    leaf->n_tuples += noffsets;
+}
+
+/*
+ * checksum_tree_hash
+ *    Hash a sequence of 64-bit values.
+ *
+ * The values are hashed in network byte order so that the result doesn't
+ * depend on the platform.
+ */
+static uint64
+checksum_tree_hash(const uint64 *values, int nvalues, uint64 *buf)
+{
+    for (int i = 0; i < nvalues; i++)
+        buf[i] = pg_hton64(values[i]);
+
+    return pg_checksum_data64((const char *) buf, nvalues * sizeof(uint64), 0);
+}
+
+/*
+ * pg_table_checksum_tree_internal
+ *    Compute the checksum tree of a table.
+ *
+ * Parameters:
+ *    reloid:       Table to checksum
+ *    fanout:       Maximum number of children of an inner node, from 2 to
+ *                  CHECKSUM_TREE_MAX_FANOUT
+ *    leaf_blocks:  Number of heap blocks covered by a leaf (>= 1)
+ *    nnodes:       Receives the number of nodes returned
+ *
+ * Returns:
+ *    palloc'd array of all nodes of the tree, level by level starting with
+ *    the root, and within a level in block order
+ *
+ * Notes:
+ *    - The table is read once; the inner nodes are computed from the leaves
+ *    - A leaf's checksum also covers its tuple count, so a leaf whose
+ *      tuples' checksums happen to sum to zero still differs from an empty
+ *      one
+ *    - An empty table has a single leaf, which is also the root
+ */
+ChecksumTreeNode *
+pg_table_checksum_tree_internal(Oid reloid, int fanout,
+                                BlockNumber leaf_blocks, int *nnodes)
+{
+    Relation    rel;
+    ChecksumTreeState state;
+    ChecksumTreeNode **levels;
+    int        *level_nodes;
+    ChecksumTreeNode *result;
+    BlockNumber nblocks;
+    uint64     *values;
+    uint64     *buf;
+    uint64      nleaves64;
+    int         nleaves;
+    int         nlevels;
+    int         n;
+
+    Assert(fanout >= 2 && fanout <= CHECKSUM_TREE_MAX_FANOUT &&
+           leaf_blocks >= 1);
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+
+    /*
+     * Fix the number of blocks, and hence the shape of the tree, up front.
+     * Blocks added later cannot hold tuples visible to our snapshot.
+     */
+    nblocks = RelationGetNumberOfBlocks(rel);
+    nleaves64 = Max(((uint64) nblocks + leaf_blocks - 1) / leaf_blocks, 1);
+    if (nleaves64 > MaxAllocSize / (2 * sizeof(ChecksumTreeNode)))
+        ereport(ERROR,
+                (errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
+                 errmsg("checksum tree of relation \"%s\" would have too many leaves",
+                        RelationGetRelationName(rel)),
+                 errhint("Use a larger leaf_blocks value.")));
+    nleaves = (int) nleaves64;
+
+    /* Count the levels; the leaves are the bottom one */
+    nlevels = 1;
+    for (int width = nleaves; width > 1; width = (width + fanout - 1) / fanout)
+        nlevels++;
+
+    levels = palloc_array(ChecksumTreeNode *, nlevels);
+    level_nodes = palloc_array(int, nlevels);
+
+    /* Set up the leaves */
+    level_nodes[nlevels - 1] = nleaves;
+    levels[nlevels - 1] = palloc0_array(ChecksumTreeNode, nleaves);
+    for (int i = 0; i < nleaves; i++)
+    {
+        ChecksumTreeNode *leaf = &levels[nlevels - 1][i];
+
+        leaf->level = nlevels - 1;
+        leaf->node = i;
+        leaf->startblk = (BlockNumber) i * leaf_blocks;
+        leaf->endblk = (BlockNumber) Min((uint64) leaf->startblk + leaf_blocks,
+                                         nblocks);
+    }
+
+    /* Hash every tuple visible to the current snapshot into its leaf */
+    state.leaf_blocks = leaf_blocks;
+    state.leaves = levels[nlevels - 1];
+    pg_checksum_heap_scan_range(rel, GetActiveSnapshot(), 0, nblocks,
+                                checksum_tree_page, &state);
+
+    relation_close(rel, AccessShareLock);
+
+    values = palloc_array(uint64, Max(fanout, 2));
+    buf = palloc_array(uint64, Max(fanout, 2));
+
+    /* Turn the leaves' sums into checksums */
+    for (int i = 0; i < nleaves; i++)
+    {
+        ChecksumTreeNode *leaf = &levels[nlevels - 1][i];
+
+        values[0] = leaf->n_tuples;
+        values[1] = leaf->checksum;
+        leaf->checksum = checksum_tree_hash(values, 2, buf);
+    }
+
+    /* Build the inner levels bottom-up */
+    for (int level = nlevels - 2; level >= 0; level--)
+    {
+        ChecksumTreeNode *children = levels[level + 1];
+        int         nchildren = level_nodes[level + 1];
+
+        level_nodes[level] = (nchildren + fanout - 1) / fanout;
+        levels[level] = palloc0_array(ChecksumTreeNode, level_nodes[level]);
+
+        for (int i = 0; i < level_nodes[level]; i++)
+        {
+            ChecksumTreeNode *node = &levels[level][i];
+            int         first = i * fanout;
+            int         last = Min(first + fanout, nchildren);
+
+            node->level = level;
+            node->node = i;
+            node->startblk = children[first].startblk;
+            node->endblk = children[last - 1].endblk;
+            for (int c = first; c < last; c++)
+            {
+                node->n_tuples += children[c].n_tuples;
+                values[c - first] = children[c].checksum;
+            }
+            node->checksum = checksum_tree_hash(values, last - first, buf);
+        }
+    }
+
+    /* Flatten the levels, root first */
+    n = 0;
+    for (int level = 0; level < nlevels; level++)
+        n += level_nodes[level];
+    result = palloc_array(ChecksumTreeNode, n);
+
+    n = 0;
+    for (int level = 0; level < nlevels; level++)
+    {
+        memcpy(&result[n], levels[level],
+               sizeof(ChecksumTreeNode) * level_nodes[level]);
+        n += level_nodes[level];
+        pfree(levels[level]);
+    }
+
+    pfree(levels);
+    pfree(level_nodes);
+    pfree(values);
+    pfree(buf);
+
+    *nnodes = n;
+    return result;
+}
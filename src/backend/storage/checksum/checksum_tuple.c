@@ -36,118 +36,123 @@
 #include "utils/rel.h"
 
 /*
- * pg_tuple_checksum
- *    Compute a checksum for a heap tuple.
- *
- * This function calculates a 32-bit checksum for a heap tuple, optionally
- * including the tuple header. The checksum incorporates:
- *    - The tuple's physical location (block number and offset)
- *    - MVCC information (xmin/xmax) when header is not included
- *    - Either the entire tuple or just the data portion
+ * The tuple checksum itself is in storage/checksum_tuple_impl.h, so that
+ * programs working on relation files, such as pg_checksums, compute the
+ * same checksums.
+ */
+#include "storage/checksum_tuple_impl.h"	/* IWYU pragma: keep */
+
+/*
+ * tuple_checksum_init64
+ *    Initial value of the wide tuple checksums.
  *
- * Parameters:
- *    page:           Page containing the tuple
- *    offnum:         Offset number of the tuple within the page
- *    blkno:          Block number containing the page
- *    include_header: If true, include the HeapTupleHeader in the calculation;
- *                    if false, calculate checksum only on tuple data
+ * The full block number and offset are kept (the 32-bit location hash loses
+ * the high bits of the block number), and, when the header is not hashed,
+ * the MVCC information goes into the upper half.  Since the wide checksums
+ * avalanche their initial value, all of it affects every output bit.
+ */
+static uint64
+tuple_checksum_init64(HeapTupleHeader tuple, OffsetNumber offnum,
+                      BlockNumber blkno, bool include_header)
+{
+    uint64      init = ((uint64) blkno << 16) | offnum;
+
+    if (!include_header)
+        init ^= (uint64) (HeapTupleHeaderGetRawXmin(tuple) ^
+                          HeapTupleHeaderGetRawXmax(tuple)) << 32;
+
+    return init;
+}
+
+/*
+ * pg_tuple_checksum64
+ *    Compute a 64-bit checksum for a heap tuple.
  *
- * Returns:
- *    32-bit checksum, or 0 if the offset is invalid or tuple is not used
+ * Same inputs as pg_tuple_checksum(), hashed with pg_checksum_data64().
+ * Use this when aggregating checksums over very large tables, where 32-bit
+ * tuple checksums collide too often.
  *
- * Notes:
- *    - Checksums are computed even for deleted tuples (old row versions)
- *      to maintain integrity across all MVCC states
- *    - The block number and offset are encoded into a location hash
- *      to bind the tuple to its physical location
- *    - When excluding headers, MVCC information is XORed to differentiate
- *      between different versions of the same logical row
+ * Returns 0 if the offset is invalid or the tuple is not used.
  */
-uint32
-pg_tuple_checksum(Page page, OffsetNumber offnum, BlockNumber blkno, bool include_header)
+uint64
+pg_tuple_checksum64(Page page, OffsetNumber offnum, BlockNumber blkno,
+                    bool include_header)
 {
-    ItemId      lp;
     HeapTupleHeader tuple;
     char       *data;
     uint32      len;
-    uint32      checksum;
-    uint32      location_hash;
-    
-    /* Validate offset number range */
-    if (offnum < FirstOffsetNumber || offnum > PageGetMaxOffsetNumber(page))
-        return 0;
-    
-    lp = PageGetItemId(page, offnum);
-    
-    /* Skip unused ItemIds (deallocated tuple slots) */
-    if (!ItemIdIsUsed(lp))
+
+    if (!tuple_checksum_input(page, offnum, include_header,
+                              &tuple, &data, &len))
         return 0;
-    
-    /*
-     * Include deleted tuples (e.g., old versions after UPDATE) in checksum
-     * calculation. This is important for verifying integrity of all row
-     * versions throughout their lifecycle, especially in MVCC systems.
-     */
-    
-    tuple = (HeapTupleHeader) PageGetItem(page, lp);
-    len = ItemIdGetLength(lp);
-    
-    if (include_header)
-    {
-        /* Include entire tuple (header + data) in checksum */
-        data = (char *) tuple;
-    }
-    else
-    {
-        /* Skip header, checksum only the tuple data */
-        data = (char *) tuple + tuple->t_hoff;
-        len -= tuple->t_hoff;
-        
-        if (len <= 0)
-            return 0;
-    }
 
-    /*
-     * Create a location hash from block number and offset.
-     * This binds the checksum to the tuple's physical location,
-     * ensuring that identical tuples at different locations have
-     * different checksums.
-     */
-    location_hash = (blkno << 16) | offnum;
-    
-    /* Calculate checksum using location_hash as the initial value */
-    checksum = pg_checksum_data(data, len, location_hash);
-    
-    /*
-     * Additionally XOR with location_hash to guarantee uniqueness.
-     * This extra step ensures that even if pg_checksum_data produces
-     * the same result for different locations, the final checksums differ.
-     */
-    checksum ^= location_hash;
-    
-    /*
-     * Incorporate MVCC information to differentiate between row versions.
-     * This ensures that different versions of the same logical row have
-     * different checksums, which is essential for detecting corruption
-     * in MVCC chains (e.g., when xmin/xmax values are corrupted).
-     */
-    if (!include_header)
-    {
-        uint32 mvcc_info = (HeapTupleHeaderGetRawXmin(tuple) ^ 
-                           HeapTupleHeaderGetRawXmax(tuple));
-        checksum ^= mvcc_info;
-    }
-    
-    /*
-     * IMPORTANT: Guarantee that tuple checksums never equal CHECKSUM_NULL.
-     * This prevents collisions with NULL column values.
-     */
-    if (checksum == CHECKSUM_NULL)
+    return pg_checksum_data64(data, len,
+                              tuple_checksum_init64(tuple, offnum, blkno,
+                                                    include_header));
+}
+
+/*
+ * pg_tuple_checksum128
+ *    Compute a 128-bit checksum for a heap tuple.
+ *
+ * Same inputs as pg_tuple_checksum(), hashed with pg_checksum_data128().
+ * The high half equals pg_tuple_checksum64().
+ *
+ * Returns all zeroes if the offset is invalid or the tuple is not used.
+ */
+pg_checksum128
+pg_tuple_checksum128(Page page, OffsetNumber offnum, BlockNumber blkno,
+                     bool include_header)
+{
+    HeapTupleHeader tuple;
+    char       *data;
+    uint32      len;
+    pg_checksum128 init;
+
+    if (!tuple_checksum_input(page, offnum, include_header,
+                              &tuple, &data, &len))
     {
-        checksum = (CHECKSUM_NULL ^ location_hash) & 0xFFFFFFFE;
+        init.hi = init.lo = 0;
+        return init;
     }
-    
-    return checksum;
+
+    init.hi = init.lo = tuple_checksum_init64(tuple, offnum, blkno,
+                                              include_header);
+
+    return pg_checksum_data128(data, len, init);
+}
+
+/*
+ * pg_tuple_logical_checksum64
+ *    Compute a 64-bit checksum of the contents of a heap tuple only.
+ *
+ * Unlike pg_tuple_checksum64(), neither the tuple's location nor its MVCC
+ * header is hashed, only the number of attributes, the null bitmap and the
+ * data.  The checksum of a row therefore stays the same when it is moved,
+ * frozen or has its hint bits set, so that a table checksum built from it
+ * can be maintained incrementally as rows are inserted and deleted.
+ *
+ * Parameters:
+ *    tuple:  Heap tuple header, followed by the tuple data
+ *    len:    Total length of the tuple, header included
+ *
+ * Returns:
+ *    64-bit checksum of the tuple contents
+ */
+uint64
+pg_tuple_logical_checksum64(HeapTupleHeader tuple, uint32 len)
+{
+    uint16      natts = HeapTupleHeaderGetNatts(tuple);
+    uint64      checksum;
+
+    checksum = pg_checksum_data64((const char *) &natts, sizeof(natts), 0);
+
+    if (tuple->t_infomask & HEAP_HASNULL)
+        checksum = pg_checksum_data64((const char *) tuple->t_bits,
+                                      BITMAPLEN(natts), checksum);
+
+    return pg_checksum_data64((const char *) tuple + tuple->t_hoff,
+                              len - tuple->t_hoff, checksum);
 }
 
 /*
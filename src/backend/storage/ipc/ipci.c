@@ -40,6 +40,7 @@
 #include "replication/walsender.h"
 #include "storage/aio_subsys.h"
 #include "storage/bufmgr.h"
+#include "storage/checksum_logical.h"
 #include "storage/dsm.h"
 #include "storage/dsm_registry.h"
 #include "storage/ipc.h"
@@ -126,6 +127,7 @@ CalculateShmemSize(void)
 	size = add_size(size, AutoVacuumShmemSize());
 	size = add_size(size, ReplicationSlotsShmemSize());
 	size = add_size(size, ReplicationOriginShmemSize());
+	size = add_size(size, LogicalChecksumShmemSize());
 	size = add_size(size, WalSndShmemSize());
 	size = add_size(size, WalRcvShmemSize());
 	size = add_size(size, WalSummarizerShmemSize());
@@ -311,6 +313,7 @@ CreateOrAttachShmemStructs(void)
 	AutoVacuumShmemInit();
 	ReplicationSlotsShmemInit();
 	ReplicationOriginShmemInit();
+	LogicalChecksumShmemInit();
 	WalSndShmemInit();
 	WalRcvShmemInit();
 	WalSummarizerShmemInit();
@@ -381,6 +381,21 @@ static const PgStat_KindInfo pgstat_kind_builtin_infos[PGSTAT_KIND_BUILTIN_SIZE]
 		.reset_timestamp_cb = pgstat_backend_reset_timestamp_cb,
 	},
 
+	[PGSTAT_KIND_CHECKSUM] = {
+		.name = "checksum",
+
+		.fixed_amount = false,
+		.write_to_file = true,
+
+		.shared_size = sizeof(PgStatShared_Checksum),
+		.shared_data_off = offsetof(PgStatShared_Checksum, stats),
+		.shared_data_len = sizeof(((PgStatShared_Checksum *) 0)->stats),
+		.pending_size = sizeof(PgStat_ChecksumCounts),
+
+		.flush_pending_cb = pgstat_checksum_flush_cb,
+		.reset_timestamp_cb = pgstat_checksum_reset_timestamp_cb,
+	},
+
 	/* stats for fixed-numbered (mostly 1) objects */
 
 	[PGSTAT_KIND_ARCHIVER] = {
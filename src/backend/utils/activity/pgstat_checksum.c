@@ -0,0 +1,217 @@
+/* -------------------------------------------------------------------------
+ *
+ * pgstat_checksum.c
+ *	  Implementation of checksum statistics.
+ *
+ * This file contains the implementation of the statistics kept about the
+ * logical checksum functions and the background checksum scrubber. There is
+ * one entry per relation, and one per database, with an objid of
+ * InvalidOid, which sums up the tuples, bytes and mismatches of its
+ * relations and counts the database-wide checksum runs. It is kept
+ * separate from pgstat.c to enforce the line between the statistics access
+ * / storage implementation and the details about individual types of
+ * statistics.
+ *
+ * Copyright (c) 2001-2026, PostgreSQL Global Development Group
+ *
+ * IDENTIFICATION
+ *	  src/backend/utils/activity/pgstat_checksum.c
+ * -------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "utils/pgstat_internal.h"
+#include "utils/rel.h"
+#include "utils/timestamp.h"
+
+
+/*
+ * Count tuples and bytes hashed by a checksum scan of rel.
+ *
+ * Called by every process taking part in the scan, including parallel
+ * workers, so the counts cover all of them.
+ */
+void
+pgstat_count_checksum_scan(Relation rel, PgStat_Counter tuples,
+						   PgStat_Counter bytes)
+{
+	PgStat_EntryRef *entry_ref;
+	PgStat_ChecksumCounts *pending;
+
+	if (!pgstat_track_counts || (tuples == 0 && bytes == 0))
+		return;
+
+	entry_ref = pgstat_prep_pending_entry(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+										  RelationGetRelid(rel), NULL);
+	pending = (PgStat_ChecksumCounts *) entry_ref->pending;
+	pending->tuples += tuples;
+	pending->bytes += bytes;
+
+	entry_ref = pgstat_prep_pending_entry(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+										  InvalidOid, NULL);
+	pending = (PgStat_ChecksumCounts *) entry_ref->pending;
+	pending->tuples += tuples;
+	pending->bytes += bytes;
+}
+
+/*
+ * Report a completed run of a checksum function over a relation, or over
+ * the whole database if relid is InvalidOid, which started at start and
+ * returned result.  mismatch is true if the function found the relation
+ * inconsistent.
+ */
+void
+pgstat_report_checksum_run(Oid relid, instr_time start, int64 result,
+						   bool mismatch)
+{
+	PgStat_EntryRef *entry_ref;
+	PgStat_ChecksumCounts *pending;
+	instr_time	elapsed;
+
+	if (!pgstat_track_counts)
+		return;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, start);
+
+	entry_ref = pgstat_prep_pending_entry(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+										  relid, NULL);
+	pending = (PgStat_ChecksumCounts *) entry_ref->pending;
+	pending->invocations++;
+	INSTR_TIME_ADD(pending->total_time, elapsed);
+	pending->last_result = result;
+	pending->last_run_time = GetCurrentTimestamp();
+
+	if (mismatch)
+	{
+		pending->mismatches++;
+
+		/* Mismatches are summed up in the database entry, too */
+		if (OidIsValid(relid))
+		{
+			entry_ref = pgstat_prep_pending_entry(PGSTAT_KIND_CHECKSUM,
+												  MyDatabaseId, InvalidOid,
+												  NULL);
+			pending = (PgStat_ChecksumCounts *) entry_ref->pending;
+			pending->mismatches++;
+		}
+	}
+}
+
+/*
+ * Report that the checksum scrubber verified a relation of the current
+ * database, with the given result, as of WAL position lsn.
+ */
+void
+pgstat_report_checksum_scrub(Oid relid, uint64 checksum, XLogRecPtr lsn)
+{
+	PgStat_EntryRef *entry_ref;
+	PgStatShared_Checksum *shchecksumentry;
+
+	if (!pgstat_track_counts)
+		return;
+
+	entry_ref = pgstat_get_entry_ref_locked(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+											relid, false);
+
+	shchecksumentry = (PgStatShared_Checksum *) entry_ref->shared_stats;
+	shchecksumentry->stats.scrub_count++;
+	shchecksumentry->stats.last_checksum = checksum;
+	shchecksumentry->stats.last_verified_lsn = lsn;
+	shchecksumentry->stats.last_verified_time = GetCurrentTimestamp();
+
+	pgstat_unlock_entry(entry_ref);
+}
+
+/*
+ * Report that the checksum scrubber failed to verify a relation of the
+ * current database, because of an error.
+ */
+void
+pgstat_report_checksum_scrub_failure(Oid relid)
+{
+	PgStat_EntryRef *entry_ref;
+	PgStatShared_Checksum *shchecksumentry;
+
+	if (!pgstat_track_counts)
+		return;
+
+	entry_ref = pgstat_get_entry_ref_locked(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+											relid, false);
+
+	shchecksumentry = (PgStatShared_Checksum *) entry_ref->shared_stats;
+	shchecksumentry->stats.scrub_failures++;
+	shchecksumentry->stats.last_failure_time = GetCurrentTimestamp();
+
+	pgstat_unlock_entry(entry_ref);
+}
+
+/*
+ * Report dropping a relation.
+ *
+ * Ensures that the relation's checksum stats are dropped if the transaction
+ * commits.
+ */
+void
+pgstat_drop_checksum(Relation rel)
+{
+	pgstat_drop_transactional(PGSTAT_KIND_CHECKSUM, MyDatabaseId,
+							  RelationGetRelid(rel));
+}
+
+/*
+ * Support function for the SQL-callable pgstat* functions. Returns
+ * the collected checksum statistics for one relation of the current
+ * database, or for the database itself if relid is InvalidOid, or NULL.
+ */
+PgStat_StatChecksumEntry *
+pgstat_fetch_stat_checksumentry(Oid relid)
+{
+	return (PgStat_StatChecksumEntry *)
+		pgstat_fetch_entry(PGSTAT_KIND_CHECKSUM, MyDatabaseId, relid);
+}
+
+/*
+ * Flush out pending stats for the entry
+ *
+ * If nowait is true and the lock could not be immediately acquired, returns
+ * false without flushing the entry.  Otherwise returns true.
+ */
+bool
+pgstat_checksum_flush_cb(PgStat_EntryRef *entry_ref, bool nowait)
+{
+	PgStat_ChecksumCounts *localent;
+	PgStatShared_Checksum *shchecksumentry;
+
+	localent = (PgStat_ChecksumCounts *) entry_ref->pending;
+	shchecksumentry = (PgStatShared_Checksum *) entry_ref->shared_stats;
+
+	if (!pgstat_lock_entry(entry_ref, nowait))
+		return false;
+
+#define CHECKSUM_ACC(fld) shchecksumentry->stats.fld += localent->fld
+	CHECKSUM_ACC(invocations);
+	CHECKSUM_ACC(tuples);
+	CHECKSUM_ACC(bytes);
+	CHECKSUM_ACC(mismatches);
+#undef CHECKSUM_ACC
+	shchecksumentry->stats.total_time +=
+		INSTR_TIME_GET_MICROSEC(localent->total_time);
+
+	if (localent->last_run_time != 0)
+	{
+		shchecksumentry->stats.last_result = localent->last_result;
+		shchecksumentry->stats.last_run_time = localent->last_run_time;
+	}
+
+	pgstat_unlock_entry(entry_ref);
+
+	return true;
+}
+
+void
+pgstat_checksum_reset_timestamp_cb(PgStatShared_Common *header, TimestampTz ts)
+{
+	((PgStatShared_Checksum *) header)->stats.stat_reset_timestamp = ts;
+}
@@ -184,6 +184,7 @@ pgstat_drop_relation(Relation rel)
 	pgstat_drop_transactional(PGSTAT_KIND_RELATION,
 							  rel->rd_rel->relisshared ? InvalidOid : MyDatabaseId,
 							  RelationGetRelid(rel));
+	pgstat_drop_checksum(rel);
 
 	if (!pgstat_should_count_relation(rel))
 		return;
@@ -7,7 +7,7 @@
  * users and administrators. Functions are provided for:
  *    - Individual tuples (with or without headers)
  *    - Specific columns within tuples
- *    - Entire tables (XOR of all tuple checksums)
+ *    - Entire tables (XOR or multiset sum of all tuple checksums)
  *    - Index tuples and entire indexes
  *    - Database-level checksums
  *
@@ -32,10 +32,14 @@
 
 #include "funcapi.h"
 #include "miscadmin.h"
+#include "pgstat.h"
 #include "access/heapam.h"
 #include "access/genam.h"
 #include "access/tableam.h"
+#include "catalog/index.h"
 #include "catalog/pg_type.h"
+#include "port/pg_bswap.h"
+#include "utils/array.h"
 #include "utils/builtins.h"
 #include "utils/rel.h"
 #include "access/htup.h"
@@ -45,10 +49,16 @@
 #include "storage/checksum_column.h"
 #include "storage/checksum_database.h"
 #include "storage/checksum_index.h"
+#include "storage/checksum_logical.h"
+#include "storage/checksum_progress.h"
+#include "storage/checksum_scan.h"
+#include "storage/checksum_table.h"
+#include "storage/checksum_tree.h"
 #include "storage/ipc.h"
 #include "access/nbtree.h"
 #include "utils/syscache.h"
 #include "utils/lsyscache.h"
+#include "utils/snapmgr.h"
 
 /*
  * pg_checksum_tuple
@@ -123,6 +133,180 @@ pg_checksum_tuple(PG_FUNCTION_ARGS)
     PG_RETURN_INT32((int32)checksum);
 }
 
+/*
+ * pg_checksum_tuple64
+ *    SQL function: pg_checksum_tuple64(reloid, tid, include_header)
+ *
+ * 64-bit variant of pg_checksum_tuple, computed with pg_tuple_checksum64().
+ * Its values are the ones aggregated by pg_checksum_table64.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_tuple64);
+
+Datum
+pg_checksum_tuple64(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    ItemPointer tid = PG_GETARG_ITEMPOINTER(1);
+    bool        include_header = PG_GETARG_BOOL(2);
+    Relation    rel;
+    Buffer      buffer;
+    uint64      checksum;
+
+    rel = relation_open(reloid, AccessShareLock);
+
+    buffer = ReadBuffer(rel, ItemPointerGetBlockNumber(tid));
+    LockBuffer(buffer, BUFFER_LOCK_SHARE);
+
+    checksum = pg_tuple_checksum64(BufferGetPage(buffer),
+                                   ItemPointerGetOffsetNumber(tid),
+                                   BufferGetBlockNumber(buffer),
+                                   include_header);
+
+    UnlockReleaseBuffer(buffer);
+    relation_close(rel, AccessShareLock);
+
+    PG_RETURN_INT64((int64) checksum);
+}
+
+/*
+ * State of pg_checksum_tuples(), passed to checksum_tuples_page() and
+ * checksum_tuples_release()
+ */
+typedef struct ChecksumTuplesState
+{
+    ReturnSetInfo *rsinfo;
+    bool        include_header;
+    int         ntuples;        /* number of entries in tids and checksums */
+    ItemPointerData tids[MaxHeapTuplesPerPage];
+    uint32      checksums[MaxHeapTuplesPerPage];
+} ChecksumTuplesState;
+
+/*
+ * checksum_tuples_page
+ *    Compute the checksum of every visible tuple of one heap page.
+ *
+ * The rows are only collected here; checksum_tuples_release() adds them to
+ * the tuplestore once the page is unlocked, since that may spill to disk.
+ */
+static void
+checksum_tuples_page(Page page, BlockNumber blkno,
+                     const OffsetNumber *offsets, int noffsets, void *arg)
+{
+    ChecksumTuplesState *state = (ChecksumTuplesState *) arg;
+
+    for (int i = 0; i < noffsets; i++)
+    {
+        state->checksums[i] = pg_tuple_checksum(page, offsets[i], blkno,
+                                                state->include_header);
+        ItemPointerSet(&state->tids[i], blkno, offsets[i]);
+    }
+    state->ntuples = noffsets;
+}
+
+/*
+ * checksum_tuples_release
+ *    Emit the (ctid, checksum) rows collected by checksum_tuples_page().
+ */
+static void
+checksum_tuples_release(void *arg)
+{
+    ChecksumTuplesState *state = (ChecksumTuplesState *) arg;
+
+    for (int i = 0; i < state->ntuples; i++)
+    {
+        Datum       values[2];
+        bool        nulls[2] = {0};
+
+        values[0] = ItemPointerGetDatum(&state->tids[i]);
+        values[1] = Int32GetDatum((int32) state->checksums[i]);
+
+        tuplestore_putvalues(state->rsinfo->setResult,
+                             state->rsinfo->setDesc, values, nulls);
+    }
+    state->ntuples = 0;
+}
+
+/*
+ * pg_checksum_tuples
+ *    SQL function: pg_checksum_tuples(reloid, include_header
+ *                                     [, start_block, end_block])
+ *
+ * Returns a (ctid, checksum) row for every tuple of the table visible to
+ * the current snapshot, optionally only for blocks start_block up to (but
+ * not including) end_block.  The checksums are the ones pg_checksum_tuple
+ * returns, but the table is read in one streaming pass, each page being
+ * locked once for all of its tuples, instead of one buffer lookup per row.
+ * Joining the results for two copies of a table on ctid shows which rows
+ * differ.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_tuples);
+
+Datum
+pg_checksum_tuples(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    int64       startblk = 0;
+    int64       endblk = (int64) InvalidBlockNumber;
+    ChecksumTuplesState *state;
+    Relation    rel;
+
+    if (PG_NARGS() > 2)
+    {
+        startblk = PG_GETARG_INT64(2);
+        endblk = PG_GETARG_INT64(3);
+
+        if (startblk < 0 || startblk > MaxBlockNumber)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                     errmsg("invalid start block number %" PRId64, startblk)));
+        if (endblk < startblk || endblk > (int64) MaxBlockNumber + 1)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                     errmsg("invalid end block number %" PRId64, endblk)));
+    }
+
+    InitMaterializedSRF(fcinfo, 0);
+
+    state = palloc_object(ChecksumTuplesState);
+    state->rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+    state->include_header = include_header;
+    state->ntuples = 0;
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+
+    pg_checksum_heap_scan_range_ext(rel, GetActiveSnapshot(),
+                                    (BlockNumber) startblk,
+                                    (BlockNumber) endblk,
+                                    checksum_tuples_page,
+                                    checksum_tuples_release, state);
+
+    relation_close(rel, AccessShareLock);
+    pfree(state);
+
+    return (Datum) 0;
+}
+
+/*
+ * checksum128_to_bytea
+ *    Represent a 128-bit checksum as a 16-byte bytea, high half first, in
+ *    network byte order so that it prints the same on every platform.
+ */
+static bytea *
+checksum128_to_bytea(pg_checksum128 checksum)
+{
+    bytea      *result = (bytea *) palloc(VARHDRSZ + 2 * sizeof(uint64));
+    uint64      hi = pg_hton64(checksum.hi);
+    uint64      lo = pg_hton64(checksum.lo);
+
+    SET_VARSIZE(result, VARHDRSZ + 2 * sizeof(uint64));
+    memcpy(VARDATA(result), &hi, sizeof(uint64));
+    memcpy(VARDATA(result) + sizeof(uint64), &lo, sizeof(uint64));
+
+    return result;
+}
+
 /*
  * pg_checksum_table
  *    SQL function: pg_checksum_table(reloid, include_header)
@@ -146,49 +330,109 @@ pg_checksum_table(PG_FUNCTION_ARGS)
 {
     Oid         reloid = PG_GETARG_OID(0);
     bool        include_header = PG_GETARG_BOOL(1);
-    Relation    rel;
-    TableScanDesc scan;
-    HeapTuple   tuple;
-    uint32      table_checksum = 0;
-    BlockNumber blkno;
-    
-    /* Open relation with minimal locking */
-    rel = relation_open(reloid, AccessShareLock);
-    
-    /* Start a table scan using current snapshot */
-    scan = table_beginscan(rel, GetActiveSnapshot(), 0, NULL);
-    
-    /* Process each tuple in the table */
-    while ((tuple = heap_getnext(scan, ForwardScanDirection)) != NULL)
-    {
-        Buffer      buffer;
-        Page        page;
-        uint32      tuple_checksum;
-        
-        /* Read the page containing this tuple */
-        buffer = ReadBuffer(rel, ItemPointerGetBlockNumber(&tuple->t_self));
-        LockBuffer(buffer, BUFFER_LOCK_SHARE);
-        
-        page = BufferGetPage(buffer);
-        blkno = BufferGetBlockNumber(buffer);
-        
-        /* Compute tuple checksum */
-        tuple_checksum = pg_tuple_checksum(page, 
-                                           ItemPointerGetOffsetNumber(&tuple->t_self), 
-                                           blkno,
-                                           include_header);
-        
-        /* XOR with accumulating table checksum */
-        table_checksum ^= tuple_checksum;
-        
-        UnlockReleaseBuffer(buffer);
-    }
-    
-    /* Clean up */
-    table_endscan(scan);
-    relation_close(rel, AccessShareLock);
-    
-    PG_RETURN_INT32((int32)table_checksum);
+    pg_checksum128 checksum;
+
+    checksum = pg_table_checksum_internal(reloid, include_header,
+                                          CHECKSUM_WIDTH_32,
+                                          CHECKSUM_AGGREGATE_XOR);
+
+    PG_RETURN_INT32((int32) checksum.lo);
+}
+
+/*
+ * pg_checksum_table64
+ *    SQL function: pg_checksum_table64(reloid, include_header)
+ *
+ * Like pg_checksum_table, but XORs 64-bit tuple checksums.  With 32-bit
+ * tuple checksums, collisions and pairwise cancellation become likely on
+ * tables with more than a few tens of thousands of rows; use this (or
+ * pg_checksum_table128) to compare large tables.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table64);
+
+Datum
+pg_checksum_table64(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    pg_checksum128 checksum;
+
+    checksum = pg_table_checksum_internal(reloid, include_header,
+                                          CHECKSUM_WIDTH_64,
+                                          CHECKSUM_AGGREGATE_XOR);
+
+    PG_RETURN_INT64((int64) checksum.lo);
+}
+
+/*
+ * pg_checksum_table128
+ *    SQL function: pg_checksum_table128(reloid, include_header)
+ *
+ * Like pg_checksum_table, but XORs 128-bit tuple checksums.  The result is
+ * returned as a 16-byte bytea.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table128);
+
+Datum
+pg_checksum_table128(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    pg_checksum128 checksum;
+
+    checksum = pg_table_checksum_internal(reloid, include_header,
+                                          CHECKSUM_WIDTH_128,
+                                          CHECKSUM_AGGREGATE_XOR);
+
+    PG_RETURN_BYTEA_P(checksum128_to_bytea(checksum));
+}
+
+/*
+ * pg_checksum_table_multiset
+ *    SQL function: pg_checksum_table_multiset(reloid, include_header)
+ *
+ * Sums the 64-bit tuple checksums of pg_checksum_tuple64 modulo 2^64
+ * instead of XOR-ing them.  Like XOR, the sum is order-independent, and
+ * per-partition results can be combined by adding them; unlike XOR, two
+ * equal tuple checksums don't cancel out.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table_multiset);
+
+Datum
+pg_checksum_table_multiset(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    pg_checksum128 checksum;
+
+    checksum = pg_table_checksum_internal(reloid, include_header,
+                                          CHECKSUM_WIDTH_64,
+                                          CHECKSUM_AGGREGATE_MULTISET);
+
+    PG_RETURN_INT64((int64) checksum.lo);
+}
+
+/*
+ * pg_checksum_table128_multiset
+ *    SQL function: pg_checksum_table128_multiset(reloid, include_header)
+ *
+ * 128-bit variant of pg_checksum_table_multiset: the sum, modulo 2^128, of
+ * 128-bit tuple checksums, returned as a 16-byte bytea.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table128_multiset);
+
+Datum
+pg_checksum_table128_multiset(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    pg_checksum128 checksum;
+
+    checksum = pg_table_checksum_internal(reloid, include_header,
+                                          CHECKSUM_WIDTH_128,
+                                          CHECKSUM_AGGREGATE_MULTISET);
+
+    PG_RETURN_BYTEA_P(checksum128_to_bytea(checksum));
 }
 
 /*
@@ -277,6 +521,10 @@ pg_checksum_page_data(PG_FUNCTION_ARGS)
  * Security: Requires SELECT privilege on the relation.
  *
  * Performance: Reads only the necessary page and extracts the column value.
+ *
+ * Memory: An uncompressed out-of-line value is hashed one slice at a time,
+ * but a compressed value is decompressed as a whole first, so checksumming
+ * it takes as much memory as reading it.
  */
 PG_FUNCTION_INFO_V1(pg_checksum_column);
 
@@ -341,6 +589,317 @@ pg_checksum_column(PG_FUNCTION_ARGS)
     PG_RETURN_INT32((int32)checksum);
 }
 
+/*
+ * checksum_columns_attnums
+ *    Validate the attnums argument of the column set checksum functions
+ *    against the columns of rel.
+ *
+ * Returns:
+ *    palloc'd array of the attribute numbers, in the order given
+ */
+static AttrNumber *
+checksum_columns_attnums(Relation rel, ArrayType *arr, int *nattnums)
+{
+    TupleDesc   tupleDesc = RelationGetDescr(rel);
+    Datum      *elems;
+    bool       *nulls;
+    int         nelems;
+    AttrNumber *attnums;
+
+    if (ARR_NDIM(arr) > 1)
+        ereport(ERROR,
+                (errcode(ERRCODE_ARRAY_SUBSCRIPT_ERROR),
+                 errmsg("attribute number array must be one-dimensional")));
+
+    deconstruct_array_builtin(arr, INT2OID, &elems, &nulls, &nelems);
+    if (nelems == 0)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("at least one attribute number is required")));
+
+    attnums = palloc_array(AttrNumber, nelems);
+    for (int i = 0; i < nelems; i++)
+    {
+        if (nulls[i])
+            ereport(ERROR,
+                    (errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+                     errmsg("attribute number array must not contain nulls")));
+
+        attnums[i] = DatumGetInt16(elems[i]);
+        if (attnums[i] <= 0 || attnums[i] > tupleDesc->natts)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                     errmsg("invalid attribute number: %d", attnums[i])));
+        if (TupleDescCompactAttr(tupleDesc, attnums[i] - 1)->attisdropped)
+            ereport(ERROR,
+                    (errcode(ERRCODE_UNDEFINED_COLUMN),
+                     errmsg("attribute %d of relation \"%s\" has been dropped",
+                            attnums[i], RelationGetRelationName(rel))));
+    }
+
+    *nattnums = nelems;
+    return attnums;
+}
+
+/*
+ * checksum_columns_row
+ *    Emit the (ctid, checksum) row of one tuple for pg_checksum_columns.
+ */
+static void
+checksum_columns_row(ItemPointer tid, uint64 checksum, void *arg)
+{
+    ReturnSetInfo *rsinfo = (ReturnSetInfo *) arg;
+    Datum       values[2];
+    bool        nulls[2] = {0};
+
+    values[0] = ItemPointerGetDatum(tid);
+    values[1] = Int64GetDatum((int64) checksum);
+
+    tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc, values, nulls);
+}
+
+/*
+ * pg_checksum_columns
+ *    SQL function: pg_checksum_columns(reloid, attnums)
+ *
+ * Returns a (ctid, checksum) row for every tuple of the table visible to
+ * the current snapshot, where checksum covers only the columns listed in
+ * attnums, e.g. a business key and an amount.  Each tuple is deformed
+ * once, up to the highest requested attribute, rather than once per
+ * column as with pg_checksum_column.  The checksum does not depend on the
+ * tuple's location, so the results for two copies of a table can be
+ * compared on the listed columns even if the rows are stored differently.
+ * As with pg_checksum_column, compressed values are decompressed in memory
+ * as a whole to be hashed.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_columns);
+
+Datum
+pg_checksum_columns(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    ArrayType  *arr = PG_GETARG_ARRAYTYPE_P(1);
+    Relation    rel;
+    AttrNumber *attnums;
+    int         nattnums;
+
+    InitMaterializedSRF(fcinfo, 0);
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+    attnums = checksum_columns_attnums(rel, arr, &nattnums);
+
+    pg_checksum_columns_scan(rel, GetActiveSnapshot(), attnums, nattnums,
+                             checksum_columns_row, fcinfo->resultinfo);
+
+    relation_close(rel, AccessShareLock);
+
+    return (Datum) 0;
+}
+
+/*
+ * checksum_columns_add
+ *    Add the checksum of one tuple to the pg_checksum_table_columns sum.
+ */
+static void
+checksum_columns_add(ItemPointer tid, uint64 checksum, void *arg)
+{
+    uint64     *sum = (uint64 *) arg;
+
+    *sum = pg_checksum_multiset_add64(*sum, checksum);
+}
+
+/*
+ * pg_checksum_table_columns
+ *    SQL function: pg_checksum_table_columns(reloid, attnums)
+ *
+ * Aggregate form of pg_checksum_columns: the multiset sum, modulo 2^64, of
+ * the row checksums of the listed columns over the whole table.  Like the
+ * other multiset checksums it is independent of row order and does not
+ * let duplicated rows cancel out.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table_columns);
+
+Datum
+pg_checksum_table_columns(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    ArrayType  *arr = PG_GETARG_ARRAYTYPE_P(1);
+    Relation    rel;
+    AttrNumber *attnums;
+    int         nattnums;
+    uint64      sum = 0;
+    bool        progress;
+    instr_time  start;
+
+    INSTR_TIME_SET_CURRENT(start);
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+    attnums = checksum_columns_attnums(rel, arr, &nattnums);
+
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_TABLE,
+                                          reloid);
+    pg_checksum_progress_start_relation(rel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_TABLE);
+
+    pg_checksum_columns_scan(rel, GetActiveSnapshot(), attnums, nattnums,
+                             checksum_columns_add, &sum);
+
+    if (progress)
+        pgstat_progress_end_command();
+
+    pgstat_report_checksum_run(reloid, start, (int64) sum, false);
+
+    relation_close(rel, AccessShareLock);
+
+    PG_RETURN_INT64((int64) sum);
+}
+
+/*
+ * pg_checksum_tuples_content
+ *    SQL function: pg_checksum_tuples_content(reloid)
+ *
+ * Returns a (ctid, checksum) row for every tuple of the table visible to
+ * the current snapshot, where checksum covers only the values of the
+ * table's columns: not the tuple's location, header or transaction IDs,
+ * nor how its values are toasted.  The checksum of a row therefore
+ * survives VACUUM FULL and CLUSTER, and is the same on a logical replica,
+ * so the rows of two nodes can be matched up by key and compared.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_tuples_content);
+
+Datum
+pg_checksum_tuples_content(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    Relation    rel;
+
+    InitMaterializedSRF(fcinfo, 0);
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+
+    pg_checksum_content_scan(rel, GetActiveSnapshot(),
+                             checksum_columns_row, fcinfo->resultinfo);
+
+    relation_close(rel, AccessShareLock);
+
+    return (Datum) 0;
+}
+
+/*
+ * pg_checksum_table_content
+ *    SQL function: pg_checksum_table_content(reloid)
+ *
+ * Aggregate form of pg_checksum_tuples_content: the multiset sum, modulo
+ * 2^64, of the content checksums of all rows.  Two copies of a table with
+ * the same rows have the same checksum, however their rows are stored.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table_content);
+
+Datum
+pg_checksum_table_content(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    Relation    rel;
+    uint64      sum = 0;
+    bool        progress;
+    instr_time  start;
+
+    INSTR_TIME_SET_CURRENT(start);
+
+    /* Open relation with minimal locking */
+    rel = relation_open(reloid, AccessShareLock);
+
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_TABLE,
+                                          reloid);
+    pg_checksum_progress_start_relation(rel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_TABLE);
+
+    pg_checksum_content_scan(rel, GetActiveSnapshot(),
+                             checksum_columns_add, &sum);
+
+    if (progress)
+        pgstat_progress_end_command();
+
+    pgstat_report_checksum_run(reloid, start, (int64) sum, false);
+
+    relation_close(rel, AccessShareLock);
+
+    PG_RETURN_INT64((int64) sum);
+}
+
+/* State of an index checksum scan, passed to checksum_index_entry() */
+typedef struct ChecksumIndexState
+{
+    ChecksumAggregate aggregate;
+    uint64      checksum;
+    int64       nentries;
+} ChecksumIndexState;
+
+/*
+ * checksum_index_entry
+ *    Combine the checksum of one index entry into the index checksum.
+ */
+static void
+checksum_index_entry(uint32 entry_checksum, void *arg)
+{
+    ChecksumIndexState *state = (ChecksumIndexState *) arg;
+
+    if (state->aggregate == CHECKSUM_AGGREGATE_MULTISET)
+        state->checksum =
+            pg_checksum_multiset_add64(state->checksum,
+                                       pg_checksum_multiset_element(entry_checksum));
+    else
+        state->checksum ^= entry_checksum;
+    state->nentries++;
+}
+
+/*
+ * checksum_index_internal
+ *    Combine the checksums of all entries of an index.
+ *
+ * With CHECKSUM_AGGREGATE_XOR the result is the XOR of the 32-bit index
+ * entry checksums; with CHECKSUM_AGGREGATE_MULTISET it is the sum, modulo
+ * 2^64, of those checksums spread over 64 bits.  Only the leaf entries of
+ * the index are hashed, by pg_index_checksum_scan_range().
+ */
+static uint64
+checksum_index_internal(Oid indexoid, ChecksumAggregate aggregate)
+{
+    Relation    rel;
+    ChecksumIndexState state;
+    bool        progress;
+    instr_time  start;
+
+    INSTR_TIME_SET_CURRENT(start);
+
+    /* Open the index with minimal locking */
+    rel = index_open(indexoid, AccessShareLock);
+
+    state.aggregate = aggregate;
+    state.checksum = 0;
+    state.nentries = 0;
+
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_INDEX,
+                                          indexoid);
+    pg_checksum_progress_start_relation(rel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_INDEX);
+
+    pg_index_checksum_scan_range(rel, 0, InvalidBlockNumber,
+                                 checksum_index_entry, &state);
+
+    if (progress)
+        pgstat_progress_end_command();
+
+    pgstat_report_checksum_run(indexoid, start, (int64) state.checksum, false);
+
+    index_close(rel, AccessShareLock);
+
+    return state.checksum;
+}
+
 /*
  * pg_checksum_index
  *    SQL function: pg_checksum_index(indexoid)
@@ -363,83 +922,167 @@ Datum
 pg_checksum_index(PG_FUNCTION_ARGS)
 {
     Oid         indexoid = PG_GETARG_OID(0);
-    Relation    rel;
+    uint64      checksum;
+
+    checksum = checksum_index_internal(indexoid, CHECKSUM_AGGREGATE_XOR);
+
+    PG_RETURN_INT32((int32) checksum);
+}
+
+/*
+ * pg_checksum_index_multiset
+ *    SQL function: pg_checksum_index_multiset(indexoid)
+ *
+ * Like pg_checksum_index, but combines the index tuple checksums by
+ * multiset sum, so that equal entries don't cancel out.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_index_multiset);
+
+Datum
+pg_checksum_index_multiset(PG_FUNCTION_ARGS)
+{
+    Oid         indexoid = PG_GETARG_OID(0);
+    uint64      checksum;
+
+    checksum = checksum_index_internal(indexoid, CHECKSUM_AGGREGATE_MULTISET);
+
+    PG_RETURN_INT64((int64) checksum);
+}
+
+/*
+ * pg_checksum_index_verify
+ *    SQL function: pg_checksum_index_verify(indexoid)
+ *
+ * Checks that an index holds exactly the entries its table calls for.  The
+ * multiset checksum of the leaf entries of the index, each a key and a heap
+ * TID, is compared with the multiset checksum of the entries formed from
+ * the table, using the index expressions and predicate.  Each side is read
+ * once, in physical order, in constant memory.
+ *
+ * Returns whether the two sides match, the number of entries on each side
+ * and their multiset checksums.  Both the table and the index are locked in
+ * ShareLock mode, as for CREATE INDEX, so that neither changes in between.
+ * Entries pointing to dead tuples not yet removed by VACUUM make the sides
+ * differ on a healthy index, so if they differ, the TIDs of such tuples are
+ * collected and the index is read again without the entries that point to
+ * them; the index side returned is then that of the second pass.  Only if
+ * the TIDs don't fit in maintenance_work_mem is the result inconclusive,
+ * with consistent NULL.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_index_verify);
+
+Datum
+pg_checksum_index_verify(PG_FUNCTION_ARGS)
+{
+    Oid         indexoid = PG_GETARG_OID(0);
+    Oid         heapoid;
+    Relation    heaprel = NULL;
+    Relation    indexrel;
+    ChecksumIndexState index_state = {CHECKSUM_AGGREGATE_MULTISET, 0, 0};
+    ChecksumIndexState heap_state = {CHECKSUM_AGGREGATE_MULTISET, 0, 0};
     TupleDesc   tupdesc;
-    uint32      index_checksum = 0;
-    uint64      n_tuples = 0;
-    BlockNumber nblocks;
-    BufferAccessStrategy bstrategy;
-    BlockNumber blkno;
-    Buffer      buffer;
-    Page        page;
-    OffsetNumber maxoff;
-    OffsetNumber offnum;
-    ItemId      itemId;
-    IndexTuple  itup;
-    uint32      tuple_checksum;
+    Datum       values[5];
+    bool        nulls[5] = {0};
+    bool        progress;
+    bool        consistent;
+    bool        inconclusive = false;
+    instr_time  start;
 
-    /* Open the index with minimal locking */
-    rel = index_open(indexoid, AccessShareLock);
-    tupdesc = RelationGetDescr(rel);
+    INSTR_TIME_SET_CURRENT(start);
 
-    /* Get total number of blocks in the index */
-    nblocks = RelationGetNumberOfBlocks(rel);
-    
-    /* Use bulk read strategy for efficient sequential scanning */
-    bstrategy = GetAccessStrategy(BAS_BULKREAD);
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+        elog(ERROR, "return type must be a row type");
+
+    /* Lock the table before the index, as index builds do */
+    heapoid = IndexGetRelation(indexoid, true);
+    if (OidIsValid(heapoid))
+        heaprel = table_open(heapoid, ShareLock);
+
+    indexrel = index_open(indexoid, ShareLock);
+
+    if (heaprel == NULL || heapoid != IndexGetRelation(indexoid, false))
+        ereport(ERROR,
+                (errcode(ERRCODE_UNDEFINED_TABLE),
+                 errmsg("could not open parent table of index \"%s\"",
+                        RelationGetRelationName(indexrel))));
+
+    if (indexrel->rd_rel->relkind != RELKIND_INDEX)
+        ereport(ERROR,
+                (errcode(ERRCODE_WRONG_OBJECT_TYPE),
+                 errmsg("cannot verify partitioned index \"%s\"",
+                        RelationGetRelationName(indexrel))));
+
+    if (!indexrel->rd_index->indisvalid)
+        ereport(ERROR,
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                 errmsg("cannot verify invalid index \"%s\"",
+                        RelationGetRelationName(indexrel))));
+
+    progress = pg_checksum_progress_begin(PROGRESS_CHECKSUM_COMMAND_INDEX_VERIFY,
+                                          indexoid);
+    pg_checksum_progress_start_relation(heaprel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_TABLE);
+    pg_index_heap_checksum_scan_range(heaprel, indexrel,
+                                      0, InvalidBlockNumber,
+                                      checksum_index_entry, &heap_state);
+
+    pg_checksum_progress_start_relation(indexrel,
+                                        PROGRESS_CHECKSUM_PHASE_SCAN_INDEX);
+    pg_index_checksum_scan_range(indexrel, 0, InvalidBlockNumber,
+                                 checksum_index_entry, &index_state);
+
+    consistent = (index_state.checksum == heap_state.checksum &&
+                  index_state.nentries == heap_state.nentries);
 
-    /* Process each block in the index */
-    for (blkno = 0; blkno < nblocks; blkno++)
+    /*
+     * Entries for dead tuples may account for the difference; compare again
+     * without them, so that any other difference still shows
+     */
+    if (!consistent)
     {
-        buffer = ReadBufferExtended(rel, MAIN_FORKNUM, blkno,
-                                    RBM_NORMAL, bstrategy);
-        LockBuffer(buffer, BUFFER_LOCK_SHARE);
-        
-        page = BufferGetPage(buffer);
-        
-        /* Skip uninitialized pages */
-        if (PageIsNew(page))
-        {
-            UnlockReleaseBuffer(buffer);
-            continue;
-        }
-        
-        /* Process all index tuples on the page */
-        maxoff = PageGetMaxOffsetNumber(page);
-        
-        for (offnum = FirstOffsetNumber;
-             offnum <= maxoff;
-             offnum = OffsetNumberNext(offnum))
+        size_t      max_bytes = (size_t) maintenance_work_mem * 1024;
+        TidStore   *dead_tids = TidStoreCreateLocal(max_bytes, true);
+        int64       ndead;
+
+        ndead = pg_index_heap_dead_tids(heaprel, 0, InvalidBlockNumber,
+                                        dead_tids, max_bytes);
+        if (ndead < 0)
+            inconclusive = true;
+        else if (ndead > 0)
         {
-            itemId = PageGetItemId(page, offnum);
-            
-            /* Skip unused or dead index entries */
-            if (!ItemIdIsUsed(itemId) || ItemIdIsDead(itemId))
-                continue;
-                
-            itup = (IndexTuple) PageGetItem(page, itemId);
-            
-            if (itup)
-            {
-                /* Compute checksum for this index tuple */
-                tuple_checksum = pg_index_tuple_checksum(itup, tupdesc, offnum);
-                index_checksum ^= tuple_checksum;
-                n_tuples++;
-            }
+            index_state.checksum = 0;
+            index_state.nentries = 0;
+
+            pg_checksum_progress_start_relation(indexrel,
+                                                PROGRESS_CHECKSUM_PHASE_SCAN_INDEX);
+            pg_index_checksum_scan_range_ext(indexrel, 0, InvalidBlockNumber,
+                                             dead_tids, checksum_index_entry,
+                                             &index_state);
+
+            consistent = (index_state.checksum == heap_state.checksum &&
+                          index_state.nentries == heap_state.nentries);
         }
-        
-        UnlockReleaseBuffer(buffer);
-        
-        /* Check for interrupts every 64 pages to allow cancellation */
-        if ((blkno & 63) == 0)
-            CHECK_FOR_INTERRUPTS();
+        TidStoreDestroy(dead_tids);
     }
-    
-    /* Clean up */
-    FreeAccessStrategy(bstrategy);
-    index_close(rel, AccessShareLock);
 
-    PG_RETURN_INT32((int32)index_checksum);
+    if (progress)
+        pgstat_progress_end_command();
+
+    /* An index that doesn't match its table counts as a mismatch */
+    pgstat_report_checksum_run(indexoid, start, (int64) index_state.checksum,
+                               !consistent && !inconclusive);
+
+    index_close(indexrel, ShareLock);
+    table_close(heaprel, ShareLock);
+
+    values[0] = BoolGetDatum(consistent);
+    nulls[0] = inconclusive;
+    values[1] = Int64GetDatum(index_state.nentries);
+    values[2] = Int64GetDatum(heap_state.nentries);
+    values[3] = Int64GetDatum((int64) index_state.checksum);
+    values[4] = Int64GetDatum((int64) heap_state.checksum);
+
+    PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
 }
 
 /*
@@ -488,7 +1131,233 @@ pg_database_checksum(PG_FUNCTION_ARGS)
     checksum = pg_database_checksum_internal(MyDatabaseId,
                                               include_system,
                                               include_toast,
-                                              NULL, NULL);
+                                              CHECKSUM_AGGREGATE_XOR,
+                                              NULL, NULL, NULL, NULL);
 
     PG_RETURN_INT64((int64)checksum);
-}
\ No newline at end of file
+}
+
+/*
+ * pg_database_checksum_multiset
+ *    SQL function: pg_database_checksum_multiset(include_system, include_toast)
+ *
+ * Like pg_database_checksum, but combines the per-tuple and per-index-entry
+ * values by multiset sum rather than XOR.
+ *
+ * Security: Requires superuser privileges due to the scope of access.
+ */
+PG_FUNCTION_INFO_V1(pg_database_checksum_multiset);
+
+Datum
+pg_database_checksum_multiset(PG_FUNCTION_ARGS)
+{
+    bool        include_system = PG_GETARG_BOOL(0);
+    bool        include_toast = PG_GETARG_BOOL(1);
+    uint64      checksum;
+
+    if (!superuser())
+        ereport(ERROR,
+                (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+                 errmsg("must be superuser to compute database checksum")));
+
+    checksum = pg_database_checksum_internal(MyDatabaseId,
+                                              include_system,
+                                              include_toast,
+                                              CHECKSUM_AGGREGATE_MULTISET,
+                                              NULL, NULL, NULL, NULL);
+
+    PG_RETURN_INT64((int64) checksum);
+}
+
+/*
+ * pg_database_checksum_manifest
+ *    SQL function: pg_database_checksum_manifest(include_system, include_toast)
+ *
+ * Computes the same checksum as pg_database_checksum, but returns one row
+ * per relation instead: its OID, relkind, number of tuples (or index
+ * entries) and pages, checksum, and the time spent on it.  The XOR of the
+ * relation checksums is the database checksum.  Comparing the manifests of
+ * two copies of a database shows which relations differ, without checksumming
+ * them one by one.
+ *
+ * Security: Requires superuser privileges due to the scope of access.
+ */
+PG_FUNCTION_INFO_V1(pg_database_checksum_manifest);
+
+Datum
+pg_database_checksum_manifest(PG_FUNCTION_ARGS)
+{
+    ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+    bool        include_system = PG_GETARG_BOOL(0);
+    bool        include_toast = PG_GETARG_BOOL(1);
+    DatabaseChecksumRelation *relations;
+    int         nrelations;
+
+    if (!superuser())
+        ereport(ERROR,
+                (errcode(ERRCODE_INSUFFICIENT_PRIVILEGE),
+                 errmsg("must be superuser to compute database checksum")));
+
+    InitMaterializedSRF(fcinfo, 0);
+
+    (void) pg_database_checksum_internal(MyDatabaseId,
+                                         include_system,
+                                         include_toast,
+                                         CHECKSUM_AGGREGATE_XOR,
+                                         NULL, NULL,
+                                         &relations, &nrelations);
+
+    for (int i = 0; i < nrelations; i++)
+    {
+        Datum       values[6];
+        bool        nulls[6] = {0};
+
+        values[0] = ObjectIdGetDatum(relations[i].relid);
+        values[1] = CharGetDatum(relations[i].relkind);
+        values[2] = Int64GetDatum((int64) relations[i].n_tuples);
+        values[3] = Int64GetDatum((int64) relations[i].n_pages);
+        values[4] = Int64GetDatum((int64) relations[i].checksum);
+        values[5] = Float8GetDatum(relations[i].elapsed_ms);
+
+        tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
+                             values, nulls);
+    }
+
+    return (Datum) 0;
+}
+
+/*
+ * pg_checksum_table_tree
+ *    SQL function: pg_checksum_table_tree(reloid, fanout, leaf_blocks)
+ *
+ * Returns the Merkle tree of checksums over block ranges of a table, one
+ * row per node: its level (0 for the root), position within the level,
+ * block range, number of tuples and checksum.  Two copies of a table can
+ * compare their roots and then only the children of the nodes that differ,
+ * to find the block ranges that differ.
+ */
+PG_FUNCTION_INFO_V1(pg_checksum_table_tree);
+
+Datum
+pg_checksum_table_tree(PG_FUNCTION_ARGS)
+{
+    ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+    Oid         reloid = PG_GETARG_OID(0);
+    int32       fanout = PG_GETARG_INT32(1);
+    int32       leaf_blocks = PG_GETARG_INT32(2);
+    ChecksumTreeNode *nodes;
+    int         nnodes;
+
+    if (fanout < 2 || fanout > CHECKSUM_TREE_MAX_FANOUT)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("fanout must be between 2 and %d",
+                        CHECKSUM_TREE_MAX_FANOUT)));
+    if (leaf_blocks < 1)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("leaf_blocks must be at least 1")));
+
+    InitMaterializedSRF(fcinfo, 0);
+
+    nodes = pg_table_checksum_tree_internal(reloid, fanout,
+                                            (BlockNumber) leaf_blocks,
+                                            &nnodes);
+
+    for (int i = 0; i < nnodes; i++)
+    {
+        Datum       values[6];
+        bool        nulls[6] = {0};
+
+        values[0] = Int32GetDatum(nodes[i].level);
+        values[1] = Int32GetDatum(nodes[i].node);
+        values[2] = Int64GetDatum((int64) nodes[i].startblk);
+        values[3] = Int64GetDatum((int64) nodes[i].endblk);
+        values[4] = Int64GetDatum((int64) nodes[i].n_tuples);
+        values[5] = Int64GetDatum((int64) nodes[i].checksum);
+
+        tuplestore_putvalues(rsinfo->setResult, rsinfo->setDesc,
+                             values, nulls);
+    }
+
+    return (Datum) 0;
+}
+
+/*
+ * logical_checksum_datum
+ *    Build the (checksum, tuples) result of the logical checksum functions.
+ */
+static Datum
+logical_checksum_datum(FunctionCallInfo fcinfo, LogicalChecksum value)
+{
+    TupleDesc   tupdesc;
+    Datum       values[2];
+    bool        nulls[2] = {0};
+
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+        elog(ERROR, "return type must be a row type");
+
+    values[0] = Int64GetDatum((int64) value.checksum);
+    values[1] = Int64GetDatum(value.ntuples);
+
+    return HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls));
+}
+
+/*
+ * pg_logical_checksum
+ *    SQL function: pg_logical_checksum(reloid)
+ *
+ * Returns the incrementally maintained logical checksum of a table with the
+ * logical_checksum storage parameter, and its number of rows, as of the
+ * last committed transaction.  This doesn't read the table.
+ */
+PG_FUNCTION_INFO_V1(pg_logical_checksum);
+
+Datum
+pg_logical_checksum(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    LogicalChecksum value;
+
+    if (!pg_logical_checksum_get(reloid, &value))
+    {
+        char       *relname = get_rel_name(reloid);
+
+        if (relname == NULL)
+            ereport(ERROR,
+                    (errcode(ERRCODE_UNDEFINED_TABLE),
+                     errmsg("relation with OID %u does not exist", reloid)));
+        ereport(ERROR,
+                (errcode(ERRCODE_OBJECT_NOT_IN_PREREQUISITE_STATE),
+                 errmsg("logical checksum of table \"%s\" is not maintained",
+                        relname),
+                 errhint("Set the \"logical_checksum\" storage parameter of the table.")));
+    }
+
+    return logical_checksum_datum(fcinfo, value);
+}
+
+/*
+ * pg_logical_checksum_compute
+ *    SQL function: pg_logical_checksum_compute(reloid)
+ *
+ * Computes the logical checksum of a table and its number of rows by
+ * reading it, the same way pg_logical_checksum() maintains them.  This
+ * works for any heap table, with or without the logical_checksum storage
+ * parameter, and can be used to verify the maintained value.
+ */
+PG_FUNCTION_INFO_V1(pg_logical_checksum_compute);
+
+Datum
+pg_logical_checksum_compute(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    Relation    rel;
+    LogicalChecksum value;
+
+    rel = relation_open(reloid, AccessShareLock);
+    value = pg_table_logical_checksum_internal(rel, GetActiveSnapshot());
+    relation_close(rel, AccessShareLock);
+
+    return logical_checksum_datum(fcinfo, value);
+}
@@ -30,6 +30,7 @@
 #include "storage/procarray.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/pg_lsn.h"
 #include "utils/timestamp.h"
 
 #define UINT32_ACCESS_ONCE(var)		 ((uint32)(*((volatile uint32 *)&(var))))
@@ -295,6 +296,8 @@ pg_stat_get_progress_info(PG_FUNCTION_ARGS)
 		cmdtype = PROGRESS_COMMAND_BASEBACKUP;
 	else if (pg_strcasecmp(cmd, "COPY") == 0)
 		cmdtype = PROGRESS_COMMAND_COPY;
+	else if (pg_strcasecmp(cmd, "CHECKSUM") == 0)
+		cmdtype = PROGRESS_COMMAND_CHECKSUM;
 	else
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
@@ -2290,6 +2293,129 @@ pg_stat_get_subscription_stats(PG_FUNCTION_ARGS)
 	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
 }
 
+/*
+ * Get the checksum statistics of a relation of the current database, or of
+ * the database itself if relid is InvalidOid.  If no checksum was computed,
+ * the counters are zero and the rest is NULL.
+ */
+Datum
+pg_stat_get_checksum_stats(PG_FUNCTION_ARGS)
+{
+#define PG_STAT_GET_CHECKSUM_STATS_COLS	15
+	Oid			relid = PG_GETARG_OID(0);
+	TupleDesc	tupdesc;
+	Datum		values[PG_STAT_GET_CHECKSUM_STATS_COLS] = {0};
+	bool		nulls[PG_STAT_GET_CHECKSUM_STATS_COLS] = {0};
+	PgStat_StatChecksumEntry *checksumentry;
+	PgStat_StatChecksumEntry allzero;
+	int			i = 0;
+
+	/* Get checksum stats */
+	checksumentry = pgstat_fetch_stat_checksumentry(relid);
+
+	/* Initialise attributes information in the tuple descriptor */
+	tupdesc = CreateTemplateTupleDesc(PG_STAT_GET_CHECKSUM_STATS_COLS);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 1, "relid",
+					   OIDOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 2, "invocations",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 3, "tuples",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 4, "bytes",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 5, "total_time",
+					   FLOAT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 6, "mismatches",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 7, "last_result",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 8, "last_run_time",
+					   TIMESTAMPTZOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 9, "scrub_count",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 10, "scrub_failures",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 11, "last_checksum",
+					   INT8OID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 12, "last_verified_lsn",
+					   PG_LSNOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 13, "last_verified_time",
+					   TIMESTAMPTZOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 14, "last_failure_time",
+					   TIMESTAMPTZOID, -1, 0);
+	TupleDescInitEntry(tupdesc, (AttrNumber) 15, "stats_reset",
+					   TIMESTAMPTZOID, -1, 0);
+	BlessTupleDesc(tupdesc);
+
+	if (!checksumentry)
+	{
+		/* If the relation was never verified, initialise its stats */
+		memset(&allzero, 0, sizeof(PgStat_StatChecksumEntry));
+		checksumentry = &allzero;
+	}
+
+	/* relid */
+	values[i++] = ObjectIdGetDatum(relid);
+
+	/* invocations, tuples and bytes */
+	values[i++] = Int64GetDatum(checksumentry->invocations);
+	values[i++] = Int64GetDatum(checksumentry->tuples);
+	values[i++] = Int64GetDatum(checksumentry->bytes);
+
+	/* total_time, in milliseconds */
+	values[i++] = Float8GetDatum(((double) checksumentry->total_time) / 1000.0);
+
+	/* mismatches */
+	values[i++] = Int64GetDatum(checksumentry->mismatches);
+
+	/* last_result and last_run_time */
+	if (checksumentry->last_run_time == 0)
+	{
+		nulls[i++] = true;
+		nulls[i++] = true;
+	}
+	else
+	{
+		values[i++] = Int64GetDatum(checksumentry->last_result);
+		values[i++] = TimestampTzGetDatum(checksumentry->last_run_time);
+	}
+
+	/* scrub_count and scrub_failures */
+	values[i++] = Int64GetDatum(checksumentry->scrub_count);
+	values[i++] = Int64GetDatum(checksumentry->scrub_failures);
+
+	/* last_checksum, last_verified_lsn and last_verified_time */
+	if (checksumentry->last_verified_time == 0)
+	{
+		nulls[i++] = true;
+		nulls[i++] = true;
+		nulls[i++] = true;
+	}
+	else
+	{
+		values[i++] = Int64GetDatum((int64) checksumentry->last_checksum);
+		values[i++] = LSNGetDatum(checksumentry->last_verified_lsn);
+		values[i++] = TimestampTzGetDatum(checksumentry->last_verified_time);
+	}
+
+	/* last_failure_time */
+	if (checksumentry->last_failure_time == 0)
+		nulls[i++] = true;
+	else
+		values[i++] = TimestampTzGetDatum(checksumentry->last_failure_time);
+
+	/* stats_reset */
+	if (checksumentry->stat_reset_timestamp == 0)
+		nulls[i] = true;
+	else
+		values[i] = TimestampTzGetDatum(checksumentry->stat_reset_timestamp);
+
+	Assert(i + 1 == PG_STAT_GET_CHECKSUM_STATS_COLS);
+
+	/* Returns the record as Datum */
+	PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
+
 /*
  * Checks for presence of stats for object with provided kind, database oid,
  * object oid.
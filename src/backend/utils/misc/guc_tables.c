@@ -79,6 +79,8 @@
 #include "storage/aio.h"
 #include "storage/bufmgr.h"
 #include "storage/bufpage.h"
+#include "storage/checksum_logical.h"
+#include "storage/checksum_scrubber.h"
 #include "storage/copydir.h"
 #include "storage/io_worker.h"
 #include "storage/large_object.h"
@@ -12,7 +12,14 @@
  *-------------------------------------------------------------------------
  */
 
-#include "postgres_fe.h"
+/*
+ * We have to use postgres.h not postgres_fe.h here, because the heap tuple
+ * headers that --logical needs depend on backend-only types like Datum.
+ * But we need a frontend-ish environment otherwise.  Hence this ugly hack.
+ */
+#define FRONTEND 1
+
+#include "postgres.h"
 
 #include <dirent.h>
 #include <limits.h>
@@ -20,17 +27,62 @@
 #include <time.h>
 #include <unistd.h>
 
+#ifdef USE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "access/clog.h"
+#include "access/htup_details.h"
+#include "access/transam.h"
 #include "common/controldata_utils.h"
 #include "common/file_utils.h"
+#include "common/int.h"
 #include "common/logging.h"
 #include "common/relpath.h"
 #include "fe_utils/option_utils.h"
 #include "fe_utils/version.h"
 #include "getopt_long.h"
 #include "pg_getopt.h"
+#include "port/pg_iovec.h"
+#include "portability/instr_time.h"
 #include "storage/bufpage.h"
 #include "storage/checksum.h"
 #include "storage/checksum_impl.h"
+#include "storage/checksum_tuple_impl.h"
+
+#ifdef WIN32
+/* Use Windows threads */
+#include <windows.h>
+#define GETERRNO() (_dosmaperr(GetLastError()), errno)
+#define THREAD_T HANDLE
+#define THREAD_FUNC_RETURN_TYPE unsigned
+#define THREAD_FUNC_RETURN return 0
+#define THREAD_FUNC_CC __stdcall
+#define THREAD_CREATE(handle, function, arg) \
+	((*(handle) = (HANDLE) _beginthreadex(NULL, 0, (function), (arg), 0, NULL)) == 0 ? errno : 0)
+#define THREAD_JOIN(handle) \
+	(WaitForSingleObject(handle, INFINITE) != WAIT_OBJECT_0 ? \
+	GETERRNO() : CloseHandle(handle) ? 0 : GETERRNO())
+#define THREAD_MUTEX_T CRITICAL_SECTION
+#define THREAD_MUTEX_INIT(mutex) (InitializeCriticalSection(mutex), 0)
+#define THREAD_MUTEX_LOCK(mutex) EnterCriticalSection(mutex)
+#define THREAD_MUTEX_UNLOCK(mutex) LeaveCriticalSection(mutex)
+#else
+/* Use POSIX threads */
+#include "port/pg_pthread.h"
+#define THREAD_T pthread_t
+#define THREAD_FUNC_RETURN_TYPE void *
+#define THREAD_FUNC_RETURN return NULL
+#define THREAD_FUNC_CC
+#define THREAD_CREATE(handle, function, arg) \
+	pthread_create((handle), NULL, (function), (arg))
+#define THREAD_JOIN(handle) \
+	pthread_join((handle), NULL)
+#define THREAD_MUTEX_T pthread_mutex_t
+#define THREAD_MUTEX_INIT(mutex) pthread_mutex_init((mutex), NULL)
+#define THREAD_MUTEX_LOCK(mutex) pthread_mutex_lock(mutex)
+#define THREAD_MUTEX_UNLOCK(mutex) pthread_mutex_unlock(mutex)
+#endif
 
 
 static int64 files_scanned = 0;
@@ -44,6 +96,8 @@ static char *only_filenode = NULL;
 static bool do_sync = true;
 static bool verbose = false;
 static bool showprogress = false;
+static bool logical = false;
+static int	num_jobs = 1;
 static DataDirSyncMethod sync_method = DATA_DIR_SYNC_METHOD_FSYNC;
 
 typedef enum
@@ -63,6 +117,108 @@ static const char *progname;
 static int64 total_size = 0;
 static int64 current_size = 0;
 static pg_time_t last_progress_report = 0;
+static instr_time scan_start;
+
+/*
+ * Segment files to scan.
+ *
+ * scan_directory() collects the segment files to work on in segments, and
+ * worker threads then take them one at a time, largest first.
+ * next_segment, segments_done, current_size and the output of the workers
+ * are shared between the threads and protected by segments_mutex; the
+ * results of a segment are only written by the thread that scans it.
+ */
+typedef struct SegmentFile
+{
+	char	   *path;			/* segment file */
+	char	   *relpath;		/* relation, i.e. path without segment number */
+	int			segmentno;
+	int64		size;
+
+	/* Results of the scan */
+	int64		blocks;
+	int64		badblocks;		/* page checksum failures */
+	int64		blocks_written; /* pages whose checksum was set */
+
+	/* Results of the scan for --logical */
+	bool		unlogged;		/* relation has an init fork, not scanned */
+	bool		heap;			/* no page with special space was seen */
+	char	   *error;			/* why the checksum can't be trusted, or NULL */
+	uint32		checksum;		/* XOR of the visible tuples' checksums */
+	int64		tuples;			/* number of visible tuples */
+} SegmentFile;
+
+static SegmentFile *segments = NULL;
+static int	n_segments = 0;
+static int	max_segments = 0;
+static int	next_segment = 0;
+static int	segments_done = 0;
+static THREAD_MUTEX_T segments_mutex;
+
+/*
+ * Segment files are read in chunks of up to READ_CHUNK_BLOCKS blocks, each
+ * with one vectored read that has an iovec per block.  With io_uring, each
+ * worker keeps up to IO_URING_DEPTH chunks in flight instead.
+ */
+#define READ_CHUNK_BLOCKS PG_IOV_MAX
+#define READ_CHUNK_SIZE (READ_CHUNK_BLOCKS * BLCKSZ)
+#define IO_URING_DEPTH 16
+
+typedef enum
+{
+	IO_METHOD_SYNC,
+	IO_METHOD_IO_URING,
+} IOMethod;
+
+static IOMethod io_method = IO_METHOD_SYNC;
+
+/*
+ * A segment file open for reading by a worker thread.
+ */
+typedef struct SegmentReader
+{
+	SegmentFile *seg;
+	int			fd;
+	pgoff_t		size;			/* size of the file when opened */
+	pgoff_t		offset;			/* offset of the chunk last returned */
+	pgoff_t		next_offset;	/* offset of the next chunk to return */
+	char	   *buffer;			/* READ_CHUNK_SIZE per chunk */
+	int64		reported;		/* bytes counted in current_size */
+#ifdef USE_LIBURING
+	struct io_uring ring;
+	pgoff_t		submit_offset;	/* offset of the next chunk to submit */
+	int			head;			/* buffer slot of the next chunk to return */
+	int			inflight;		/* chunks submitted and not yet returned */
+	pgoff_t		slot_offset[IO_URING_DEPTH];	/* offset of each slot's chunk */
+	int			slot_len[IO_URING_DEPTH];	/* length of each slot's chunk */
+	int			result[IO_URING_DEPTH]; /* bytes read so far, or -errno */
+	bool		complete[IO_URING_DEPTH];	/* is result final? */
+#endif
+} SegmentReader;
+
+/*
+ * Layout of pg_xact, as in clog.c.  The whole of it is read before the
+ * workers start, so they can look up transaction status without locking.
+ */
+#define CLOG_BITS_PER_XACT	2
+#define CLOG_XACTS_PER_BYTE 4
+#define CLOG_XACTS_PER_PAGE (BLCKSZ * CLOG_XACTS_PER_BYTE)
+#define CLOG_XACT_BITMASK	((1 << CLOG_BITS_PER_XACT) - 1)
+#define CLOG_XACTS_PER_SEGMENT (CLOG_XACTS_PER_PAGE * SLRU_PAGES_PER_SEGMENT)
+#define CLOG_SEGMENTS \
+	((int) ((UINT64CONST(0xFFFFFFFF) + 1) / CLOG_XACTS_PER_SEGMENT))
+
+static char **clog_segments = NULL;
+
+/*
+ * Visibility of a heap tuple, as decided by logical_tuple_visibility().
+ */
+typedef enum
+{
+	LOGICAL_TUPLE_INVISIBLE,
+	LOGICAL_TUPLE_VISIBLE,
+	LOGICAL_TUPLE_UNKNOWN,
+} LogicalTupleVisibility;
 
 static void
 usage(void)
@@ -76,6 +232,10 @@ usage(void)
 	printf(_("  -d, --disable            disable data checksums\n"));
 	printf(_("  -e, --enable             enable data checksums\n"));
 	printf(_("  -f, --filenode=FILENODE  check only relation with specified filenode\n"));
+	printf(_("  -j, --jobs=NUM           use this many threads to scan files\n"));
+	printf(_("      --io-method=METHOD   set method for reading files\n"));
+	printf(_("      --logical            compute table checksums from the tuples of heap\n"
+			 "                           relations\n"));
 	printf(_("  -N, --no-sync            do not wait for changes to be written safely to disk\n"));
 	printf(_("  -P, --progress           show progress information\n"));
 	printf(_("      --sync-method=METHOD set method for syncing files to disk\n"));
@@ -119,12 +279,17 @@ static const struct exclude_list_item skip[] = {
 /*
  * Report current progress status.  Parts borrowed from
  * src/bin/pg_basebackup/pg_basebackup.c.
+ *
+ * While worker threads are running, the caller must hold segments_mutex.
  */
 static void
 progress_report(bool finished)
 {
 	int			percent;
 	pg_time_t	now;
+	instr_time	elapsed;
+	double		elapsed_sec;
+	double		rate;
 
 	Assert(showprogress);
 
@@ -142,10 +307,17 @@ progress_report(bool finished)
 	/* Calculate current percentage of size done */
 	percent = total_size ? (int) ((current_size) * 100 / total_size) : 0;
 
-	fprintf(stderr, _("%" PRId64 "/%" PRId64 " MB (%d%%) computed"),
+	/* Calculate the read rate of all workers together */
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, scan_start);
+	elapsed_sec = INSTR_TIME_GET_DOUBLE(elapsed);
+	rate = elapsed_sec > 0 ?
+		current_size / elapsed_sec / (1024 * 1024 * 1024) : 0;
+
+	fprintf(stderr, _("%" PRId64 "/%" PRId64 " MB (%d%%) computed, %.2f GB/s"),
 			(current_size / (1024 * 1024)),
 			(total_size / (1024 * 1024)),
-			percent);
+			percent, rate);
 
 	/*
 	 * Stay on the same line if reporting to a terminal and we're not done
@@ -172,121 +344,835 @@ skipfile(const char *fn)
 	return false;
 }
 
+/*
+ * segment_reader_init
+ *    Set up a worker thread's reader, for use with every segment file the
+ *    thread scans.
+ */
 static void
-scan_file(const char *fn, int segmentno)
+segment_reader_init(SegmentReader *reader)
 {
-	PGIOAlignedBlock buf;
-	PageHeader	header = (PageHeader) buf.data;
-	int			f;
-	BlockNumber blockno;
-	int			flags;
-	int64		blocks_written_in_file = 0;
+	memset(reader, 0, sizeof(SegmentReader));
+	reader->fd = -1;
 
-	Assert(mode == PG_MODE_ENABLE ||
-		   mode == PG_MODE_CHECK);
+#ifdef USE_LIBURING
+	if (io_method == IO_METHOD_IO_URING)
+	{
+		int			ret;
 
-	flags = (mode == PG_MODE_ENABLE) ? O_RDWR : O_RDONLY;
-	f = open(fn, PG_BINARY | flags, 0);
+		ret = io_uring_queue_init(IO_URING_DEPTH, &reader->ring, 0);
+		if (ret < 0)
+		{
+			errno = -ret;
+			pg_log_error("could not set up io_uring queue: %m");
+			pg_log_error_hint("Use --io-method=sync.");
+			exit(1);
+		}
+		reader->buffer = palloc(READ_CHUNK_SIZE * IO_URING_DEPTH);
+		return;
+	}
+#endif
 
-	if (f < 0)
-		pg_fatal("could not open file \"%s\": %m", fn);
+	reader->buffer = palloc(READ_CHUNK_SIZE);
+}
 
-	files_scanned++;
+/*
+ * segment_reader_free
+ *    Release the resources of a reader set up by segment_reader_init().
+ */
+static void
+segment_reader_free(SegmentReader *reader)
+{
+#ifdef USE_LIBURING
+	if (io_method == IO_METHOD_IO_URING)
+		io_uring_queue_exit(&reader->ring);
+#endif
+	pfree(reader->buffer);
+}
 
-	for (blockno = 0;; blockno++)
+/*
+ * segment_reader_begin
+ *    Open seg for reading with reader, read-write if writable is true.
+ */
+static void
+segment_reader_begin(SegmentReader *reader, SegmentFile *seg, bool writable)
+{
+	struct stat st;
+
+	reader->seg = seg;
+	reader->fd = open(seg->path, PG_BINARY | (writable ? O_RDWR : O_RDONLY), 0);
+	if (reader->fd < 0)
+		pg_fatal("could not open file \"%s\": %m", seg->path);
+	if (fstat(reader->fd, &st) < 0)
+		pg_fatal("could not stat file \"%s\": %m", seg->path);
+
+	reader->size = st.st_size;
+	reader->offset = 0;
+	reader->next_offset = 0;
+	reader->reported = 0;
+#ifdef USE_LIBURING
+	reader->submit_offset = 0;
+#endif
+}
+
+/*
+ * segment_reader_report
+ *    Count nbytes more of the current segment as done, for progress
+ *    reporting.
+ */
+static void
+segment_reader_report(SegmentReader *reader, int64 nbytes)
+{
+	THREAD_MUTEX_LOCK(&segments_mutex);
+	current_size += nbytes;
+	THREAD_MUTEX_UNLOCK(&segments_mutex);
+	reader->reported += nbytes;
+}
+
+/*
+ * segment_reader_check
+ *    Check the result r of reading len bytes at reader->next_offset into
+ *    buffer, and advance to the next chunk.
+ *
+ * Returns r, and sets *data to buffer.
+ */
+static int
+segment_reader_check(SegmentReader *reader, char *buffer, ssize_t r,
+					 int len, char **data)
+{
+	BlockNumber blockno = reader->next_offset / BLCKSZ;
+
+	if (r < 0)
+		pg_fatal("could not read block %u in file \"%s\": %m",
+				 blockno, reader->seg->path);
+	if (r != len || r % BLCKSZ != 0)
+		pg_fatal("could not read block %u in file \"%s\": read %d of %d",
+				 blockno + (BlockNumber) (r / BLCKSZ), reader->seg->path,
+				 (int) (r % BLCKSZ), BLCKSZ);
+
+	reader->offset = reader->next_offset;
+	reader->next_offset += r;
+
+	/*
+	 * Since the file size is counted as total_size for progress status
+	 * information, the sizes of all pages including new ones in the file
+	 * should be counted as current_size.  Otherwise the progress reporting
+	 * calculated using those counters may not reach 100%.
+	 */
+	segment_reader_report(reader, r);
+
+	*data = buffer;
+	return r;
+}
+
+#ifdef USE_LIBURING
+/*
+ * segment_reader_prep
+ *    Prepare a read of what is still missing of the chunk in slot.
+ *
+ * The caller has to submit it.
+ */
+static void
+segment_reader_prep(SegmentReader *reader, int slot)
+{
+	struct io_uring_sqe *sqe = io_uring_get_sqe(&reader->ring);
+	int			done = reader->result[slot];
+
+	/* There is one entry per slot, and a slot has one read in flight */
+	Assert(sqe != NULL);
+
+	io_uring_prep_read(sqe, reader->fd,
+					   reader->buffer + slot * READ_CHUNK_SIZE + done,
+					   reader->slot_len[slot] - done,
+					   reader->slot_offset[slot] + done);
+	io_uring_sqe_set_data(sqe, (void *) (uintptr_t) slot);
+}
+
+/*
+ * segment_reader_submit
+ *    Submit the reads prepared with segment_reader_prep().
+ */
+static void
+segment_reader_submit(SegmentReader *reader)
+{
+	int			ret = io_uring_submit(&reader->ring);
+
+	if (ret < 0)
 	{
-		uint16		csum;
-		int			r = read(f, buf.data, BLCKSZ);
+		errno = -ret;
+		pg_fatal("could not submit I/O to io_uring: %m");
+	}
+}
 
-		if (r == 0)
-			break;
-		if (r != BLCKSZ)
+/*
+ * segment_reader_wait
+ *    Wait until the read of the chunk at the head of reader's ring is
+ *    complete.
+ *
+ * Like read(), a read may return fewer bytes than asked for; the rest of
+ * the chunk is then read again.  A read that returns nothing, at the end of
+ * the file, completes the chunk short.
+ */
+static void
+segment_reader_wait(SegmentReader *reader)
+{
+	while (!reader->complete[reader->head])
+	{
+		struct io_uring_cqe *cqe;
+		int			slot;
+		int			res;
+		int			ret;
+
+		ret = io_uring_wait_cqe(&reader->ring, &cqe);
+		if (ret == -EINTR)
+			continue;
+		if (ret < 0)
 		{
-			if (r < 0)
-				pg_fatal("could not read block %u in file \"%s\": %m",
-						 blockno, fn);
-			else
-				pg_fatal("could not read block %u in file \"%s\": read %d of %d",
-						 blockno, fn, r, BLCKSZ);
+			errno = -ret;
+			pg_fatal("could not wait for io_uring completion: %m");
 		}
-		blocks_scanned++;
-
-		/*
-		 * Since the file size is counted as total_size for progress status
-		 * information, the sizes of all pages including new ones in the file
-		 * should be counted as current_size. Otherwise the progress reporting
-		 * calculated using those counters may not reach 100%.
-		 */
-		current_size += r;
-
-		/* New pages have no checksum yet */
-		if (PageIsNew(buf.data))
+
+		slot = (int) (uintptr_t) io_uring_cqe_get_data(cqe);
+		res = cqe->res;
+		io_uring_cqe_seen(&reader->ring, cqe);
+
+		if (res < 0)
+		{
+			reader->result[slot] = res;
+			reader->complete[slot] = true;
 			continue;
+		}
 
-		csum = pg_checksum_page(buf.data, blockno + segmentno * RELSEG_SIZE);
-		if (mode == PG_MODE_CHECK)
+		reader->result[slot] += res;
+		if (res > 0 && reader->result[slot] < reader->slot_len[slot])
 		{
-			if (csum != header->pd_checksum)
-			{
-				if (ControlFile->data_checksum_version == PG_DATA_CHECKSUM_VERSION)
-					pg_log_error("checksum verification failed in file \"%s\", block %u: calculated checksum %X but block contains %X",
-								 fn, blockno, csum, header->pd_checksum);
-				badblocks++;
-			}
+			segment_reader_prep(reader, slot);
+			segment_reader_submit(reader);
 		}
-		else if (mode == PG_MODE_ENABLE)
+		else
+			reader->complete[slot] = true;
+	}
+}
+
+/*
+ * segment_reader_next_uring
+ *    segment_reader_next() for --io-method=io_uring.
+ *
+ * Before waiting for the next chunk, reads are submitted for as many of the
+ * following chunks as there are free slots in the ring.
+ */
+static int
+segment_reader_next_uring(SegmentReader *reader, char **data)
+{
+	bool		submit = false;
+	int			slot;
+	int			len;
+
+	while (reader->inflight < IO_URING_DEPTH &&
+		   reader->submit_offset < reader->size)
+	{
+		slot = (reader->head + reader->inflight) % IO_URING_DEPTH;
+		len = Min(READ_CHUNK_SIZE, reader->size - reader->submit_offset);
+
+		reader->slot_offset[slot] = reader->submit_offset;
+		reader->slot_len[slot] = len;
+		reader->result[slot] = 0;
+		reader->complete[slot] = false;
+		segment_reader_prep(reader, slot);
+
+		reader->inflight++;
+		reader->submit_offset += len;
+		submit = true;
+	}
+
+	if (submit)
+		segment_reader_submit(reader);
+
+	if (reader->inflight == 0)
+		return 0;
+
+	segment_reader_wait(reader);
+	slot = reader->head;
+	reader->head = (reader->head + 1) % IO_URING_DEPTH;
+	reader->inflight--;
+
+	/* io_uring returns a negated errno */
+	if (reader->result[slot] < 0)
+	{
+		errno = -reader->result[slot];
+		reader->result[slot] = -1;
+	}
+
+	return segment_reader_check(reader, reader->buffer + slot * READ_CHUNK_SIZE,
+								reader->result[slot], reader->slot_len[slot],
+								data);
+}
+#endif
+
+/*
+ * segment_reader_next
+ *    Read the next chunk of the current segment.
+ *
+ * Returns the number of bytes read, a multiple of BLCKSZ, or 0 at the end
+ * of the file, and sets *data to the chunk read.  The chunk starts at
+ * reader->offset, and stays valid until the next call.  A short read is
+ * continued where it stopped, so only a file that shrank since it was opened
+ * yields less than a whole chunk.
+ */
+static int
+segment_reader_next(SegmentReader *reader, char **data)
+{
+	struct iovec iov[READ_CHUNK_BLOCKS];
+	int			len;
+	int			iovcnt;
+	ssize_t		done = 0;
+
+#ifdef USE_LIBURING
+	if (io_method == IO_METHOD_IO_URING)
+		return segment_reader_next_uring(reader, data);
+#endif
+
+	if (reader->next_offset >= reader->size)
+		return 0;
+
+	/* One iovec per block, the last one possibly partial */
+	len = Min(READ_CHUNK_SIZE, reader->size - reader->next_offset);
+	iovcnt = 0;
+	for (int off = 0; off < len; off += BLCKSZ)
+	{
+		iov[iovcnt].iov_base = reader->buffer + off;
+		iov[iovcnt].iov_len = Min(BLCKSZ, len - off);
+		iovcnt++;
+	}
+
+	/* Read the rest after a short read, until the end of the file */
+	while (done < len)
+	{
+		ssize_t		r = pg_preadv(reader->fd, iov, iovcnt,
+								  reader->next_offset + done);
+
+		if (r < 0)
 		{
-			int			w;
+			done = r;
+			break;
+		}
+		if (r == 0)
+			break;
 
-			/*
-			 * Do not rewrite if the checksum is already set to the expected
-			 * value.
-			 */
-			if (header->pd_checksum == csum)
-				continue;
+		done += r;
+		iovcnt = compute_remaining_iovec(iov, iov, iovcnt, r);
+	}
+
+	return segment_reader_check(reader, reader->buffer, done, len, data);
+}
+
+/*
+ * segment_reader_end
+ *    Close the current segment of reader.
+ *
+ * Whatever was not read of the file is counted as done, for progress
+ * reporting.
+ */
+static void
+segment_reader_end(SegmentReader *reader)
+{
+#ifdef USE_LIBURING
+	/* Reads still in flight target our buffers, so wait for them */
+	while (reader->inflight > 0)
+	{
+		segment_reader_wait(reader);
+		reader->head = (reader->head + 1) % IO_URING_DEPTH;
+		reader->inflight--;
+	}
+#endif
+
+	close(reader->fd);
+	reader->fd = -1;
+
+	if (reader->seg->size > reader->reported)
+		segment_reader_report(reader, reader->seg->size - reader->reported);
+}
 
-			blocks_written_in_file++;
+/*
+ * scan_file
+ *    Verify or set the page checksums of one segment file.
+ *
+ * Runs in a worker thread, with reader.
+ */
+static void
+scan_file(SegmentReader *reader, SegmentFile *seg)
+{
+	char	   *data;
+	int			nbytes;
+
+	Assert(mode == PG_MODE_ENABLE ||
+		   mode == PG_MODE_CHECK);
+
+	segment_reader_begin(reader, seg, mode == PG_MODE_ENABLE);
 
-			/* Set checksum in page header */
-			header->pd_checksum = csum;
+	while ((nbytes = segment_reader_next(reader, &data)) > 0)
+	{
+		for (int i = 0; i < nbytes / BLCKSZ; i++)
+		{
+			char	   *page = data + i * BLCKSZ;
+			PageHeader	header = (PageHeader) page;
+			BlockNumber blockno = reader->offset / BLCKSZ + i;
+			uint16		csum;
 
-			/* Seek back to beginning of block */
-			if (lseek(f, -BLCKSZ, SEEK_CUR) < 0)
-				pg_fatal("seek failed for block %u in file \"%s\": %m", blockno, fn);
+			seg->blocks++;
 
-			/* Write block with checksum */
-			w = write(f, buf.data, BLCKSZ);
-			if (w != BLCKSZ)
+			/* New pages have no checksum yet */
+			if (PageIsNew(page))
+				continue;
+
+			csum = pg_checksum_page(page, blockno + seg->segmentno * RELSEG_SIZE);
+			if (mode == PG_MODE_CHECK)
 			{
-				if (w < 0)
-					pg_fatal("could not write block %u in file \"%s\": %m",
-							 blockno, fn);
-				else
-					pg_fatal("could not write block %u in file \"%s\": wrote %d of %d",
-							 blockno, fn, w, BLCKSZ);
+				if (csum != header->pd_checksum)
+				{
+					if (ControlFile->data_checksum_version == PG_DATA_CHECKSUM_VERSION)
+					{
+						THREAD_MUTEX_LOCK(&segments_mutex);
+						pg_log_error("checksum verification failed in file \"%s\", block %u: calculated checksum %X but block contains %X",
+									 seg->path, blockno, csum, header->pd_checksum);
+						THREAD_MUTEX_UNLOCK(&segments_mutex);
+					}
+					seg->badblocks++;
+				}
 			}
-		}
+			else if (mode == PG_MODE_ENABLE)
+			{
+				int			w;
 
-		if (showprogress)
-			progress_report(false);
+				/*
+				 * Do not rewrite if the checksum is already set to the
+				 * expected value.
+				 */
+				if (header->pd_checksum == csum)
+					continue;
+
+				seg->blocks_written++;
+
+				/* Set checksum in page header */
+				header->pd_checksum = csum;
+
+				/* Write block with checksum */
+				w = pg_pwrite(reader->fd, page, BLCKSZ,
+							  (pgoff_t) blockno * BLCKSZ);
+				if (w != BLCKSZ)
+				{
+					if (w < 0)
+						pg_fatal("could not write block %u in file \"%s\": %m",
+								 blockno, seg->path);
+					else
+						pg_fatal("could not write block %u in file \"%s\": wrote %d of %d",
+								 blockno, seg->path, w, BLCKSZ);
+				}
+			}
+		}
 	}
 
+	segment_reader_end(reader);
+
 	if (verbose)
 	{
+		THREAD_MUTEX_LOCK(&segments_mutex);
 		if (mode == PG_MODE_CHECK)
-			pg_log_info("checksums verified in file \"%s\"", fn);
+			pg_log_info("checksums verified in file \"%s\"", seg->path);
 		if (mode == PG_MODE_ENABLE)
-			pg_log_info("checksums enabled in file \"%s\"", fn);
+			pg_log_info("checksums enabled in file \"%s\"", seg->path);
+		THREAD_MUTEX_UNLOCK(&segments_mutex);
+	}
+}
+
+/*
+ * add_segment
+ *    Queue segment file fn of the relation file relfile in directory dir for
+ *    the worker threads, and return its entry.
+ */
+static SegmentFile *
+add_segment(const char *fn, const char *dir, const char *relfile,
+			int segmentno, int64 size)
+{
+	SegmentFile *seg;
+
+	if (segments == NULL)
+	{
+		max_segments = 1024;
+		segments = palloc_array(SegmentFile, max_segments);
+	}
+	else if (n_segments >= max_segments)
+	{
+		max_segments *= 2;
+		segments = repalloc_array(segments, SegmentFile, max_segments);
+	}
+
+	seg = &segments[n_segments++];
+	memset(seg, 0, sizeof(SegmentFile));
+	seg->path = pstrdup(fn);
+	seg->relpath = psprintf("%s/%s", dir, relfile);
+	seg->segmentno = segmentno;
+	seg->size = size;
+
+	return seg;
+}
+
+/*
+ * load_clog
+ *    Read all segments of pg_xact into clog_segments.
+ *
+ * Segments that don't exist, because they were truncated away or are
+ * beyond the last transaction, are left NULL.
+ */
+static void
+load_clog(const char *DataDir)
+{
+	char		path[MAXPGPATH];
+	DIR		   *dir;
+	struct dirent *de;
+
+	clog_segments = palloc0_array(char *, CLOG_SEGMENTS);
+
+	snprintf(path, sizeof(path), "%s/pg_xact", DataDir);
+	dir = opendir(path);
+	if (!dir)
+		pg_fatal("could not open directory \"%s\": %m", path);
+	while ((de = readdir(dir)) != NULL)
+	{
+		char		fn[MAXPGPATH];
+		unsigned long segno;
+		char	   *segment;
+		int			f;
+		int			r;
+
+		if (strlen(de->d_name) != 4 ||
+			strspn(de->d_name, "0123456789ABCDEF") != 4)
+			continue;
+		segno = strtoul(de->d_name, NULL, 16);
+		if (segno >= CLOG_SEGMENTS)
+			continue;
+
+		snprintf(fn, sizeof(fn), "%s/%s", path, de->d_name);
+		f = open(fn, PG_BINARY | O_RDONLY, 0);
+		if (f < 0)
+			pg_fatal("could not open file \"%s\": %m", fn);
+
+		/* A short segment reads as transactions still in progress */
+		segment = palloc0(BLCKSZ * SLRU_PAGES_PER_SEGMENT);
+		r = read(f, segment, BLCKSZ * SLRU_PAGES_PER_SEGMENT);
+		if (r < 0)
+			pg_fatal("could not read file \"%s\": %m", fn);
+		close(f);
+
+		clog_segments[segno] = segment;
+	}
+	closedir(dir);
+}
+
+/*
+ * logical_xid_committed
+ *    Look up whether xid committed, in the pg_xact read by load_clog().
+ *
+ * Returns false if the status of xid isn't known; otherwise sets
+ * *committed.
+ */
+static bool
+logical_xid_committed(TransactionId xid, bool *committed)
+{
+	char	   *segment;
+	uint32		xidoff;
+	int			status;
+
+	if (!TransactionIdIsNormal(xid))
+	{
+		*committed = (xid != InvalidTransactionId);
+		return true;
+	}
+
+	segment = clog_segments[xid / CLOG_XACTS_PER_SEGMENT];
+	if (segment == NULL)
+		return false;
+
+	xidoff = xid % CLOG_XACTS_PER_SEGMENT;
+	status = (segment[xidoff / CLOG_XACTS_PER_BYTE] >>
+			  ((xidoff % CLOG_XACTS_PER_BYTE) * CLOG_BITS_PER_XACT)) &
+		CLOG_XACT_BITMASK;
+
+	/*
+	 * The cluster was shut down, so a transaction that didn't commit either
+	 * aborted or is prepared; the changes of neither are visible.
+	 */
+	*committed = (status == TRANSACTION_STATUS_COMMITTED);
+	return true;
+}
+
+/*
+ * logical_tuple_visibility
+ *    Decide whether tuple is visible to a snapshot taken once the cluster is
+ *    started again, following HeapTupleSatisfiesMVCC().
+ *
+ * Returns LOGICAL_TUPLE_UNKNOWN, with *error set, if the tuple was deleted
+ * or updated by a multixact, whose members aren't read here, or if the
+ * status of a transaction can't be found in pg_xact.
+ */
+static LogicalTupleVisibility
+logical_tuple_visibility(HeapTupleHeader tuple, char **error)
+{
+	uint16		infomask = tuple->t_infomask;
+	TransactionId xid;
+	bool		committed;
+
+	if (!HeapTupleHeaderXminCommitted(tuple))
+	{
+		if (HeapTupleHeaderXminInvalid(tuple))
+			return LOGICAL_TUPLE_INVISIBLE;
+
+		/* Moved by an old-style VACUUM FULL, decided by the vacuum's xid */
+		if (infomask & (HEAP_MOVED_OFF | HEAP_MOVED_IN))
+			xid = HeapTupleHeaderGetXvac(tuple);
+		else
+			xid = HeapTupleHeaderGetRawXmin(tuple);
+
+		if (!logical_xid_committed(xid, &committed))
+		{
+			*error = psprintf(_("could not determine status of transaction %u"),
+							  xid);
+			return LOGICAL_TUPLE_UNKNOWN;
+		}
+		if (infomask & HEAP_MOVED_OFF)
+		{
+			/* Moved away by a vacuum that committed */
+			if (committed)
+				return LOGICAL_TUPLE_INVISIBLE;
+		}
+		else if (!committed)
+			return LOGICAL_TUPLE_INVISIBLE;
 	}
 
-	/* Update write counters if any write activity has happened */
-	if (blocks_written_in_file > 0)
+	if (infomask & HEAP_XMAX_INVALID)
+		return LOGICAL_TUPLE_VISIBLE;
+	if (HEAP_XMAX_IS_LOCKED_ONLY(infomask))
+		return LOGICAL_TUPLE_VISIBLE;
+	if (infomask & HEAP_XMAX_IS_MULTI)
 	{
-		files_written++;
-		blocks_written += blocks_written_in_file;
+		*error = psprintf(_("tuple was updated or deleted by multixact %u"),
+						  HeapTupleHeaderGetRawXmax(tuple));
+		return LOGICAL_TUPLE_UNKNOWN;
 	}
+	if (infomask & HEAP_XMAX_COMMITTED)
+		return LOGICAL_TUPLE_INVISIBLE;
 
-	close(f);
+	xid = HeapTupleHeaderGetRawXmax(tuple);
+	if (!logical_xid_committed(xid, &committed))
+	{
+		*error = psprintf(_("could not determine status of transaction %u"),
+						  xid);
+		return LOGICAL_TUPLE_UNKNOWN;
+	}
+	return committed ? LOGICAL_TUPLE_INVISIBLE : LOGICAL_TUPLE_VISIBLE;
+}
+
+/*
+ * logical_scan_page
+ *    Combine the checksums of the visible tuples of one heap page into the
+ *    checksum of seg.
+ *
+ * Returns false, with seg->error set, if the checksum of the page can't be
+ * computed.
+ */
+static bool
+logical_scan_page(SegmentFile *seg, Page page, BlockNumber blkno)
+{
+	PageHeader	phdr = (PageHeader) page;
+	OffsetNumber maxoff;
+	bool		all_visible;
+
+	if (phdr->pd_lower < SizeOfPageHeaderData ||
+		phdr->pd_lower > phdr->pd_upper ||
+		phdr->pd_upper > BLCKSZ)
+	{
+		seg->error = psprintf(_("invalid page header in block %u"), blkno);
+		return false;
+	}
+
+	all_visible = PageIsAllVisible(page);
+	maxoff = PageGetMaxOffsetNumber(page);
+	for (OffsetNumber offnum = FirstOffsetNumber; offnum <= maxoff; offnum++)
+	{
+		ItemId		lp = PageGetItemId(page, offnum);
+
+		if (!ItemIdIsNormal(lp))
+			continue;
+
+		if (ItemIdGetLength(lp) < SizeofHeapTupleHeader ||
+			ItemIdGetOffset(lp) + ItemIdGetLength(lp) > BLCKSZ)
+		{
+			seg->error = psprintf(_("invalid line pointer (%u,%u)"),
+								  blkno, offnum);
+			return false;
+		}
+
+		if (!all_visible)
+		{
+			HeapTupleHeader tuple = (HeapTupleHeader) PageGetItem(page, lp);
+			char	   *error;
+
+			switch (logical_tuple_visibility(tuple, &error))
+			{
+				case LOGICAL_TUPLE_INVISIBLE:
+					continue;
+				case LOGICAL_TUPLE_VISIBLE:
+					break;
+				case LOGICAL_TUPLE_UNKNOWN:
+					seg->error = psprintf(_("could not determine visibility of tuple (%u,%u): %s"),
+										  blkno, offnum, error);
+					return false;
+			}
+		}
+
+		seg->checksum ^= pg_tuple_checksum(page, offnum, blkno, false);
+		seg->tuples++;
+	}
+
+	return true;
+}
+
+/*
+ * logical_scan_segment
+ *    Compute the checksum of the visible tuples in one segment file.
+ *
+ * Runs in a worker thread, with reader.  A relation whose pages have special
+ * space is not a heap, but an index or a sequence; the scan stops at the
+ * first such page and leaves seg->heap false.
+ */
+static void
+logical_scan_segment(SegmentReader *reader, SegmentFile *seg)
+{
+	char	   *data;
+	int			nbytes;
+	bool		stop = false;
+
+	segment_reader_begin(reader, seg, false);
+
+	seg->heap = true;
+	while (!stop && (nbytes = segment_reader_next(reader, &data)) > 0)
+	{
+		for (int i = 0; i < nbytes / BLCKSZ; i++)
+		{
+			char	   *page = data + i * BLCKSZ;
+			BlockNumber blockno = reader->offset / BLCKSZ + i;
+
+			seg->blocks++;
+
+			/* New pages have no tuples yet */
+			if (PageIsNew(page))
+				continue;
+
+			if (((PageHeader) page)->pd_special != BLCKSZ)
+			{
+				seg->heap = false;
+				stop = true;
+				break;
+			}
+
+			if (!logical_scan_page(seg, page,
+								   blockno + seg->segmentno * RELSEG_SIZE))
+			{
+				stop = true;
+				break;
+			}
+		}
+	}
+
+	segment_reader_end(reader);
+}
+
+/*
+ * scan_worker
+ *    Main function of a worker thread.
+ */
+static THREAD_FUNC_RETURN_TYPE THREAD_FUNC_CC
+scan_worker(void *arg)
+{
+	SegmentReader reader;
+
+	segment_reader_init(&reader);
+
+	for (;;)
+	{
+		int			next;
+
+		THREAD_MUTEX_LOCK(&segments_mutex);
+		next = next_segment++;
+		THREAD_MUTEX_UNLOCK(&segments_mutex);
+
+		if (next >= n_segments)
+			break;
+
+		if (logical)
+		{
+			if (!segments[next].unlogged)
+				logical_scan_segment(&reader, &segments[next]);
+		}
+		else
+			scan_file(&reader, &segments[next]);
+
+		THREAD_MUTEX_LOCK(&segments_mutex);
+		segments_done++;
+		THREAD_MUTEX_UNLOCK(&segments_mutex);
+	}
+
+	segment_reader_free(&reader);
+
+	THREAD_FUNC_RETURN;
+}
+
+/*
+ * Sort segments by size, largest first, so that a big relation scanned at
+ * the end doesn't leave the other threads idle.
+ */
+static int
+segment_size_cmp(const void *a, const void *b)
+{
+	const SegmentFile *sa = (const SegmentFile *) a;
+	const SegmentFile *sb = (const SegmentFile *) b;
+
+	return pg_cmp_s64(sb->size, sa->size);
+}
+
+/*
+ * Sort segments by relation and segment number, to report per relation.
+ */
+static int
+segment_relpath_cmp(const void *a, const void *b)
+{
+	const SegmentFile *sa = (const SegmentFile *) a;
+	const SegmentFile *sb = (const SegmentFile *) b;
+	int			cmp;
+
+	cmp = strcmp(sa->relpath, sb->relpath);
+	if (cmp != 0)
+		return cmp;
+	return pg_cmp_s32(sa->segmentno, sb->segmentno);
+}
+
+/*
+ * has_init_fork
+ *    Check whether the relation file relfile in directory dir has an init
+ *    fork, i.e. belongs to an unlogged relation.
+ */
+static bool
+has_init_fork(const char *dir, const char *relfile)
+{
+	char		initpath[MAXPGPATH];
+	struct stat st;
+
+	snprintf(initpath, sizeof(initpath), "%s/%s_init", dir, relfile);
+	if (lstat(initpath, &st) == 0)
+		return true;
+	if (errno != ENOENT)
+		pg_fatal("could not stat file \"%s\": %m", initpath);
+	return false;
 }
 
 /*
@@ -342,6 +1228,7 @@ scan_directory(const char *basedir, const char *subdir, bool sizeonly)
 			char	   *forkpath,
 					   *segmentpath;
 			int			segmentno = 0;
+			bool		unlogged;
 
 			if (skipfile(de->d_name))
 				continue;
@@ -371,14 +1258,31 @@ scan_directory(const char *basedir, const char *subdir, bool sizeonly)
 				/* filenode not to be included */
 				continue;
 
-			dirsize += st.st_size;
+			/* Tuples are only found in the main fork */
+			if (logical && forkpath != NULL)
+				continue;
+
+			/*
+			 * The main fork of an unlogged relation is queued without being
+			 * read, so that logical_checksums() can report it as skipped.
+			 */
+			unlogged = logical && has_init_fork(path, fnonly);
+			if (!unlogged)
+				dirsize += st.st_size;
 
 			/*
 			 * No need to work on the file when calculating only the size of
-			 * the items in the data folder.
+			 * the items in the data folder.  Otherwise, queue it for the
+			 * worker threads.
 			 */
 			if (!sizeonly)
-				scan_file(fn, segmentno);
+			{
+				SegmentFile *seg;
+
+				seg = add_segment(fn, path, fnonly, segmentno,
+								  unlogged ? 0 : st.st_size);
+				seg->unlogged = unlogged;
+			}
 		}
 		else if (S_ISDIR(st.st_mode) || S_ISLNK(st.st_mode))
 		{
@@ -429,6 +1333,186 @@ scan_directory(const char *basedir, const char *subdir, bool sizeonly)
 	return dirsize;
 }
 
+/*
+ * scan_segments
+ *    Find the segment files to work on, and scan them with num_jobs worker
+ *    threads.
+ */
+static void
+scan_segments(const char *DataDir)
+{
+	THREAD_T   *threads;
+	int			i;
+
+	/*
+	 * If progress status information is requested, we need to scan the
+	 * directory tree twice: once to know how much total data needs to be
+	 * processed and once to do the real work.
+	 */
+	if (showprogress)
+	{
+		total_size = scan_directory(DataDir, "global", true);
+		total_size += scan_directory(DataDir, "base", true);
+		total_size += scan_directory(DataDir, PG_TBLSPC_DIR, true);
+	}
+
+	(void) scan_directory(DataDir, "global", false);
+	(void) scan_directory(DataDir, "base", false);
+	(void) scan_directory(DataDir, PG_TBLSPC_DIR, false);
+
+	if (n_segments > 1)
+		qsort(segments, n_segments, sizeof(SegmentFile),
+			  segment_size_cmp);
+
+	errno = THREAD_MUTEX_INIT(&segments_mutex);
+	if (errno != 0)
+		pg_fatal("could not initialize mutex: %m");
+
+	INSTR_TIME_SET_CURRENT(scan_start);
+
+	threads = palloc_array(THREAD_T, num_jobs);
+	for (i = 0; i < num_jobs; i++)
+	{
+		errno = THREAD_CREATE(&threads[i], scan_worker, NULL);
+		if (errno != 0)
+			pg_fatal("could not create thread: %m");
+	}
+
+	/* The workers don't report progress themselves; do it for them */
+	if (showprogress)
+	{
+		for (;;)
+		{
+			bool		done;
+
+			THREAD_MUTEX_LOCK(&segments_mutex);
+			done = (segments_done == n_segments);
+			if (!done)
+				progress_report(false);
+			THREAD_MUTEX_UNLOCK(&segments_mutex);
+
+			if (done)
+				break;
+			pg_usleep(100000L);
+		}
+	}
+
+	for (i = 0; i < num_jobs; i++)
+	{
+		errno = THREAD_JOIN(threads[i]);
+		if (errno != 0)
+			pg_fatal("could not join thread: %m");
+	}
+	pfree(threads);
+
+	if (showprogress)
+		progress_report(true);
+
+	for (i = 0; i < n_segments; i++)
+	{
+		if (!segments[i].unlogged)
+			files_scanned++;
+		blocks_scanned += segments[i].blocks;
+	}
+}
+
+/*
+ * logical_checksums
+ *    Compute the checksum of every heap relation of the cluster from its
+ *    visible tuples, like pg_checksum_table(rel, false) does in a running
+ *    server, and print it.
+ *
+ * Relations are identified by their file path relative to the data
+ * directory, as returned by pg_relation_filepath(), since the catalogs
+ * can't be read offline.
+ *
+ * Unlogged relations are skipped.  Their main fork is neither WAL-logged nor
+ * included in base backups, and is reset to the init fork after a crash, so
+ * its tuples are not something a copy of the cluster can be checked against.
+ */
+static void
+logical_checksums(const char *DataDir)
+{
+	int64		nrelations = 0;
+	int64		ntuples = 0;
+	int64		nfailed = 0;
+	int			i;
+
+	load_clog(DataDir);
+	scan_segments(DataDir);
+
+	/* Combine the segments of each relation, and report */
+	if (n_segments > 1)
+		qsort(segments, n_segments, sizeof(SegmentFile),
+			  segment_relpath_cmp);
+
+	for (i = 0; i < n_segments;)
+	{
+		const char *relpath = segments[i].relpath;
+		bool		unlogged = false;
+		bool		heap = true;
+		char	   *error = NULL;
+		uint32		checksum = 0;
+		int64		tuples = 0;
+
+		for (; i < n_segments &&
+			 strcmp(segments[i].relpath, relpath) == 0; i++)
+		{
+			SegmentFile *seg = &segments[i];
+
+			unlogged = unlogged || seg->unlogged;
+			heap = heap && seg->heap;
+			if (error == NULL)
+				error = seg->error;
+			checksum ^= seg->checksum;
+			tuples += seg->tuples;
+		}
+
+		/* Report the path relative to the data directory */
+		relpath += strlen(DataDir) + 1;
+
+		if (unlogged)
+		{
+			if (verbose)
+				pg_log_info("skipping relation \"%s\", which is unlogged",
+							relpath);
+			continue;
+		}
+
+		if (!heap)
+		{
+			if (verbose)
+				pg_log_info("skipping relation \"%s\", which is not a heap",
+							relpath);
+			continue;
+		}
+
+		if (error != NULL)
+		{
+			pg_log_error("could not compute checksum of relation \"%s\": %s",
+						 relpath, error);
+			nfailed++;
+			continue;
+		}
+
+		/* Printed as the int4 that pg_checksum_table() returns */
+		printf(_("%s: %" PRId64 " tuples, checksum %d\n"),
+			   relpath, tuples, (int32) checksum);
+		nrelations++;
+		ntuples += tuples;
+	}
+
+	printf(_("Logical checksum operation completed\n"));
+	printf(_("Files scanned:   %" PRId64 "\n"), files_scanned);
+	printf(_("Blocks scanned:  %" PRId64 "\n"), blocks_scanned);
+	printf(_("Relations:       %" PRId64 "\n"), nrelations);
+	printf(_("Tuples:          %" PRId64 "\n"), ntuples);
+	printf(_("Relations not verified: %" PRId64 "\n"), nfailed);
+
+	if (nfailed > 0)
+		exit(1);
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -438,10 +1522,13 @@ main(int argc, char *argv[])
 		{"disable", no_argument, NULL, 'd'},
 		{"enable", no_argument, NULL, 'e'},
 		{"filenode", required_argument, NULL, 'f'},
+		{"jobs", required_argument, NULL, 'j'},
 		{"no-sync", no_argument, NULL, 'N'},
 		{"progress", no_argument, NULL, 'P'},
 		{"verbose", no_argument, NULL, 'v'},
 		{"sync-method", required_argument, NULL, 1},
+		{"logical", no_argument, NULL, 2},
+		{"io-method", required_argument, NULL, 3},
 		{NULL, 0, NULL, 0}
 	};
 
@@ -470,7 +1557,7 @@ main(int argc, char *argv[])
 		}
 	}
 
-	while ((c = getopt_long(argc, argv, "cdD:ef:NPv", long_options, &option_index)) != -1)
+	while ((c = getopt_long(argc, argv, "cdD:ef:j:NPv", long_options, &option_index)) != -1)
 	{
 		switch (c)
 		{
@@ -493,6 +1580,11 @@ main(int argc, char *argv[])
 					exit(1);
 				only_filenode = pstrdup(optarg);
 				break;
+			case 'j':
+				if (!option_parse_int(optarg, "-j/--jobs", 1, INT_MAX,
+									  &num_jobs))
+					exit(1);
+				break;
 			case 'N':
 				do_sync = false;
 				break;
@@ -506,6 +1598,28 @@ main(int argc, char *argv[])
 				if (!parse_sync_method(optarg, &sync_method))
 					exit(1);
 				break;
+			case 2:
+				logical = true;
+				break;
+			case 3:
+				if (strcmp(optarg, "sync") == 0)
+					io_method = IO_METHOD_SYNC;
+				else if (strcmp(optarg, "io_uring") == 0)
+				{
+#ifdef USE_LIBURING
+					io_method = IO_METHOD_IO_URING;
+#else
+					pg_log_error("this build does not support I/O method \"%s\"",
+								 "io_uring");
+					exit(1);
+#endif
+				}
+				else
+				{
+					pg_log_error("unrecognized I/O method: %s", optarg);
+					exit(1);
+				}
+				break;
 			default:
 				/* getopt_long already emitted a complaint */
 				pg_log_error_hint("Try \"%s --help\" for more information.", progname);
@@ -546,6 +1660,22 @@ main(int argc, char *argv[])
 		exit(1);
 	}
 
+	/* logical checksums can only be verified */
+	if (mode != PG_MODE_CHECK && logical)
+	{
+		pg_log_error("option --logical can only be used with --check");
+		pg_log_error_hint("Try \"%s --help\" for more information.", progname);
+		exit(1);
+	}
+
+	/* there are no files to scan when disabling */
+	if (mode == PG_MODE_DISABLE && num_jobs > 1)
+	{
+		pg_log_error("option -j/--jobs can only be used with --check or --enable");
+		pg_log_error_hint("Try \"%s --help\" for more information.", progname);
+		exit(1);
+	}
+
 	/*
 	 * Retrieve the contents of this cluster's PG_VERSION.  We require
 	 * compatibility with the same major version as the one this tool is
@@ -586,7 +1716,7 @@ main(int argc, char *argv[])
 		pg_fatal("cluster must be shut down");
 
 	if (ControlFile->data_checksum_version == 0 &&
-		mode == PG_MODE_CHECK)
+		mode == PG_MODE_CHECK && !logical)
 		pg_fatal("data checksums are not enabled in cluster");
 
 	if (ControlFile->data_checksum_version == 0 &&
@@ -597,28 +1727,26 @@ main(int argc, char *argv[])
 		mode == PG_MODE_ENABLE)
 		pg_fatal("data checksums are already enabled in cluster");
 
-	/* Operate on all files if checking or enabling checksums */
-	if (mode == PG_MODE_CHECK || mode == PG_MODE_ENABLE)
+	/*
+	 * Compute the logical checksums of the relations, or operate on all files
+	 * if checking or enabling checksums.
+	 */
+	if (logical)
+		logical_checksums(DataDir);
+	else if (mode == PG_MODE_CHECK || mode == PG_MODE_ENABLE)
 	{
-		/*
-		 * If progress status information is requested, we need to scan the
-		 * directory tree twice: once to know how much total data needs to be
-		 * processed and once to do the real work.
-		 */
-		if (showprogress)
+		scan_segments(DataDir);
+
+		for (int i = 0; i < n_segments; i++)
 		{
-			total_size = scan_directory(DataDir, "global", true);
-			total_size += scan_directory(DataDir, "base", true);
-			total_size += scan_directory(DataDir, PG_TBLSPC_DIR, true);
+			badblocks += segments[i].badblocks;
+			if (segments[i].blocks_written > 0)
+			{
+				files_written++;
+				blocks_written += segments[i].blocks_written;
+			}
 		}
 
-		(void) scan_directory(DataDir, "global", false);
-		(void) scan_directory(DataDir, "base", false);
-		(void) scan_directory(DataDir, PG_TBLSPC_DIR, false);
-
-		if (showprogress)
-			progress_report(true);
-
 		printf(_("Checksum operation completed\n"));
 		printf(_("Files scanned:   %" PRId64 "\n"), files_scanned);
 		printf(_("Blocks scanned:  %" PRId64 "\n"), blocks_scanned);
@@ -12,6 +12,7 @@ use PostgreSQL::Test::Utils;
 
 use Test::More;
 
+my $supports_io_uring = check_pg_config("#define USE_LIBURING 1");
 
 # Utility routine to create and check a table with corrupted checksums
 # on a wanted tablespace.  Note that this stops and starts the node
@@ -77,6 +78,32 @@ sub check_relation_corruption
 		[qr/checksum verification failed/],
 		"fails with corrupted data on tablespace $tablespace");
 
+	# And with several worker threads
+	$node->command_checks_all(
+		[ 'pg_checksums', '--check', '--jobs' => '3', '--pgdata' => $pgdata ],
+		1,
+		[qr/Bad checksums:.*1/],
+		[qr/checksum verification failed/],
+		"fails with corrupted data on tablespace $tablespace with several jobs"
+	);
+
+	# And when reading through io_uring
+	if ($supports_io_uring)
+	{
+		$node->command_checks_all(
+			[
+				'pg_checksums', '--check',
+				'--jobs' => '3',
+				'--io-method' => 'io_uring',
+				'--pgdata' => $pgdata
+			],
+			1,
+			[qr/Bad checksums:.*1/],
+			[qr/checksum verification failed/],
+			"fails with corrupted data on tablespace $tablespace with io_uring"
+		);
+	}
+
 	# Drop corrupted table again and make sure there is no more corruption.
 	$node->start;
 	$node->safe_psql('postgres', "DROP TABLE $table;");
@@ -155,9 +182,16 @@ command_like(
 	qr/Data page checksum version:.*0/,
 	'checksums disabled in control file');
 
-# Enable checksums again for follow-up tests.
-command_ok([ 'pg_checksums', '--enable', '--no-sync', '--pgdata' => $pgdata ],
-	"checksums successfully enabled in cluster");
+# Enable checksums again for follow-up tests, this time with the files
+# spread across worker threads.
+command_ok(
+	[
+		'pg_checksums', '--enable',
+		'--no-sync',
+		'--jobs' => '4',
+		'--pgdata' => $pgdata
+	],
+	"checksums successfully enabled in cluster with several jobs");
 
 # Control file should know that checksums are enabled.
 command_like(
@@ -174,6 +208,51 @@ command_ok(
 	[ 'pg_checksums', '--pgdata' => $pgdata ],
 	"verifies checksums as default action");
 
+# Checksums pass when files are spread across worker threads, and with the
+# progress report
+command_ok(
+	[
+		'pg_checksums', '--check',
+		'--jobs' => '4',
+		'--io-method' => 'sync',
+		'--progress',
+		'--pgdata' => $pgdata
+	],
+	"succeeds with several jobs");
+
+# Files can also be read through io_uring, if the build supports it
+if ($supports_io_uring)
+{
+	command_ok(
+		[
+			'pg_checksums', '--check',
+			'--jobs' => '4',
+			'--io-method' => 'io_uring',
+			'--progress',
+			'--pgdata' => $pgdata
+		],
+		"succeeds with io_uring");
+}
+else
+{
+	command_fails_like(
+		[
+			'pg_checksums', '--check',
+			'--io-method' => 'io_uring',
+			'--pgdata' => $pgdata
+		],
+		qr/this build does not support I\/O method "io_uring"/,
+		"fails with io_uring when the build does not support it");
+}
+
+# Worker threads are only used when scanning files
+command_fails(
+	[ 'pg_checksums', '--disable', '--jobs' => '4', '--pgdata' => $pgdata ],
+	"fails when jobs are requested and action is --disable");
+command_fails(
+	[ 'pg_checksums', '--check', '--io-method' => 'foo', '--pgdata' => $pgdata ],
+	"fails with unrecognized I/O method");
+
 # Specific relation files cannot be requested when action is --disable
 # or --enable.
 command_fails(
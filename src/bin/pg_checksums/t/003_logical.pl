@@ -0,0 +1,145 @@
+
+# Copyright (c) 2026, PostgreSQL Global Development Group
+
+# Check that pg_checksums --logical computes the same table checksums as
+# pg_checksum_table() in the running server.
+
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('main');
+$node->init;
+$node->start;
+my $pgdata = $node->data_dir;
+
+# Tables with deleted, updated and aborted rows, spread over several blocks,
+# one with TOASTed values, and an index and an unlogged table that --logical
+# has to skip.
+$node->safe_psql(
+	'postgres', q{
+	CREATE TABLE logical_t1 (a int, b text) WITH (autovacuum_enabled = false);
+	INSERT INTO logical_t1 SELECT a, repeat('x', a % 100)
+	  FROM generate_series(1, 10000) AS a;
+	CREATE INDEX logical_t1_a ON logical_t1 (a);
+	DELETE FROM logical_t1 WHERE a % 7 = 0;
+	UPDATE logical_t1 SET b = 'updated' WHERE a % 11 = 0;
+	BEGIN;
+	INSERT INTO logical_t1 VALUES (-1, 'aborted');
+	DELETE FROM logical_t1 WHERE a % 13 = 0;
+	ROLLBACK;
+	CREATE TABLE logical_t2 (a int) WITH (autovacuum_enabled = false);
+	INSERT INTO logical_t2 SELECT generate_series(1, 1000);
+	VACUUM FREEZE logical_t2;
+	CREATE TABLE logical_empty (a int);
+	CREATE TABLE logical_toast (a int, b text)
+	  WITH (autovacuum_enabled = false);
+	ALTER TABLE logical_toast ALTER COLUMN b SET STORAGE EXTERNAL;
+	INSERT INTO logical_toast SELECT a, repeat(md5(a::text), 300)
+	  FROM generate_series(1, 100) AS a;
+	DELETE FROM logical_toast WHERE a % 3 = 0;
+	CREATE UNLOGGED TABLE logical_unlogged (a int);
+	INSERT INTO logical_unlogged SELECT generate_series(1, 100);
+	CREATE TABLE logical_segments (a int, b text)
+	  WITH (autovacuum_enabled = false);
+	INSERT INTO logical_segments SELECT a, 'first'
+	  FROM generate_series(1, 10) AS a;
+});
+my $toast = $node->safe_psql('postgres',
+	"SELECT reltoastrelid::regclass FROM pg_class WHERE relname = 'logical_toast';"
+);
+my $unlogged_path = $node->safe_psql('postgres',
+	"SELECT pg_relation_filepath('logical_unlogged');");
+
+# A relation of more than one segment.  Its first segment is extended to the
+# full segment size with a hole, which reads as new pages, so that the rows
+# inserted after a restart go to the next segment.
+my $segment_blocks = $node->safe_psql('postgres',
+	"SELECT setting FROM pg_settings WHERE name = 'segment_size';");
+my $block_size = $node->safe_psql('postgres', 'SHOW block_size;');
+my $segments_path = $node->safe_psql('postgres',
+	"SELECT pg_relation_filepath('logical_segments');");
+$node->stop;
+open(my $fh, '+<', "$pgdata/$segments_path")
+  or die "could not open \"$pgdata/$segments_path\": $!";
+binmode $fh;
+truncate($fh, $segment_blocks * $block_size)
+  or die "could not extend \"$pgdata/$segments_path\": $!";
+close $fh;
+$node->start;
+$node->safe_psql('postgres',
+	"INSERT INTO logical_segments SELECT a, repeat('y', 100) FROM generate_series(11, 1000) AS a;"
+);
+ok(-f "$pgdata/$segments_path.1", 'relation has a second segment');
+
+# The lines pg_checksums should print for each table, and its filenode.
+my %expected;
+my %filenode;
+foreach my $table ('logical_t1', 'logical_t2', 'logical_empty',
+	'logical_toast', $toast, 'logical_segments')
+{
+	$expected{$table} = $node->safe_psql('postgres',
+		"SELECT pg_relation_filepath('$table') || ': ' || count(*) || ' tuples, checksum ' || pg_checksum_table('$table', false) FROM $table;"
+	);
+	$filenode{$table} = $node->safe_psql('postgres',
+		"SELECT pg_relation_filenode('$table');");
+}
+my $index_path = $node->safe_psql('postgres',
+	"SELECT pg_relation_filepath('logical_t1_a');");
+
+# A clean shutdown is required.
+command_fails_like(
+	[ 'pg_checksums', '--check', '--logical', '--pgdata' => $pgdata ],
+	qr/cluster must be shut down/,
+	'fails with online cluster');
+
+$node->stop;
+
+foreach my $jobs (1, 4)
+{
+	my ($stdout, $stderr) = run_command(
+		[
+			'pg_checksums', '--check',
+			'--logical', '--verbose',
+			'--jobs' => $jobs,
+			'--pgdata' => $pgdata,
+		]);
+
+	foreach my $table (sort keys %expected)
+	{
+		like($stdout, qr/^\Q$expected{$table}\E$/m,
+			"checksum of $table matches with $jobs jobs");
+	}
+	like(
+		$stderr,
+		qr/skipping relation "\Q$index_path\E", which is not a heap/,
+		"index is skipped with $jobs jobs");
+	like(
+		$stderr,
+		qr/skipping relation "\Q$unlogged_path\E", which is unlogged/,
+		"unlogged table is skipped with $jobs jobs");
+	unlike($stdout, qr/^\Q$unlogged_path\E:/m,
+		"no checksum of unlogged table with $jobs jobs");
+	like($stdout, qr/^Relations not verified: 0$/m,
+		"all relations verified with $jobs jobs");
+}
+
+command_like(
+	[
+		'pg_checksums', '--check',
+		'--logical',
+		'--filenode' => $filenode{logical_t2},
+		'--pgdata' => $pgdata,
+	],
+	qr/^\Q$expected{logical_t2}\E\n(?:.*\n)*Relations:       1$/m,
+	'only the relation with the specified filenode is checksummed');
+
+command_fails_like(
+	[ 'pg_checksums', '--enable', '--logical', '--pgdata' => $pgdata ],
+	qr/option --logical can only be used with --check/,
+	'fails with --enable');
+
+done_testing();
@@ -179,4 +179,27 @@
 #define PROGRESS_COPY_TYPE_PIPE 3
 #define PROGRESS_COPY_TYPE_CALLBACK 4
 
+/* Progress parameters for checksum functions */
+#define PROGRESS_CHECKSUM_COMMAND				0
+#define PROGRESS_CHECKSUM_PHASE					1
+#define PROGRESS_CHECKSUM_CURRENT_RELID			2
+#define PROGRESS_CHECKSUM_RELATIONS_TOTAL		3
+#define PROGRESS_CHECKSUM_RELATIONS_DONE		4
+#define PROGRESS_CHECKSUM_BLOCKS_TOTAL			5
+#define PROGRESS_CHECKSUM_BLOCKS_DONE			6
+#define PROGRESS_CHECKSUM_TUPLES_DONE			7
+#define PROGRESS_CHECKSUM_BYTES_DONE			8
+
+/* Commands of checksum functions (as advertised via PROGRESS_CHECKSUM_COMMAND) */
+#define PROGRESS_CHECKSUM_COMMAND_TABLE			1
+#define PROGRESS_CHECKSUM_COMMAND_INDEX			2
+#define PROGRESS_CHECKSUM_COMMAND_INDEX_VERIFY	3
+#define PROGRESS_CHECKSUM_COMMAND_DATABASE		4
+
+/* Phases of checksum functions (as advertised via PROGRESS_CHECKSUM_PHASE) */
+#define PROGRESS_CHECKSUM_PHASE_COLLECT_RELATIONS	1
+#define PROGRESS_CHECKSUM_PHASE_SCAN_TABLE		2
+#define PROGRESS_CHECKSUM_PHASE_SCAN_INDEX		3
+#define PROGRESS_CHECKSUM_PHASE_WAIT_WORKERS	4
+
 #endif
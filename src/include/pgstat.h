@@ -86,6 +86,25 @@ typedef struct PgStat_FunctionCounts
 	instr_time	self_time;
 } PgStat_FunctionCounts;
 
+/* ----------
+ * PgStat_ChecksumCounts	The checksum activity counts kept by a backend,
+ *							per relation and per database
+ *
+ * Like PgStat_FunctionCounts, the time is in instr_time format here.  The
+ * last result is only passed on if last_run_time is set.
+ * ----------
+ */
+typedef struct PgStat_ChecksumCounts
+{
+	PgStat_Counter invocations;
+	PgStat_Counter tuples;
+	PgStat_Counter bytes;
+	instr_time	total_time;
+	PgStat_Counter mismatches;
+	int64		last_result;
+	TimestampTz last_run_time;
+} PgStat_ChecksumCounts;
+
 /*
  * Working state needed to accumulate per-function-call timing statistics.
  */
@@ -214,7 +233,7 @@ typedef struct PgStat_TableXactStatus
  * ------------------------------------------------------------
  */
 
-#define PGSTAT_FILE_FORMAT_ID	0x01A5BCBB
+#define PGSTAT_FILE_FORMAT_ID	0x01A5BCBE
 
 typedef struct PgStat_ArchiverStats
 {
@@ -342,6 +361,25 @@ typedef struct PgStat_IO
 	PgStat_BktypeIO stats[BACKEND_NUM_TYPES];
 } PgStat_IO;
 
+typedef struct PgStat_StatChecksumEntry
+{
+	PgStat_Counter invocations;
+	PgStat_Counter tuples;
+	PgStat_Counter bytes;
+	PgStat_Counter total_time;	/* time in microseconds */
+	PgStat_Counter mismatches;
+	int64		last_result;
+	TimestampTz last_run_time;
+
+	PgStat_Counter scrub_count;
+	PgStat_Counter scrub_failures;	/* verifications that raised an error */
+	uint64		last_checksum;	/* XOR checksum of the last verification */
+	XLogRecPtr	last_verified_lsn;
+	TimestampTz last_verified_time;
+	TimestampTz last_failure_time;
+	TimestampTz stat_reset_timestamp;
+} PgStat_StatChecksumEntry;
+
 typedef struct PgStat_StatDBEntry
 {
 	PgStat_Counter xact_commit;
@@ -614,6 +652,21 @@ extern bool pgstat_tracks_io_op(BackendType bktype, IOObject io_object,
 								IOContext io_context, IOOp io_op);
 
 
+/*
+ * Functions in pgstat_checksum.c
+ */
+
+extern void pgstat_count_checksum_scan(Relation rel, PgStat_Counter tuples,
+									   PgStat_Counter bytes);
+extern void pgstat_report_checksum_run(Oid relid, instr_time start,
+									   int64 result, bool mismatch);
+extern void pgstat_report_checksum_scrub(Oid relid, uint64 checksum,
+										 XLogRecPtr lsn);
+extern void pgstat_report_checksum_scrub_failure(Oid relid);
+extern void pgstat_drop_checksum(Relation rel);
+extern PgStat_StatChecksumEntry *pgstat_fetch_stat_checksumentry(Oid relid);
+
+
 /*
  * Functions in pgstat_database.c
  */
@@ -15,13 +15,126 @@
 
 #include "storage/block.h"
 
+/* Result of the 128-bit data checksum */
+typedef struct pg_checksum128
+{
+	uint64		hi;
+	uint64		lo;
+} pg_checksum128;
+
 /*
  * Compute the checksum for a Postgres page.  The page must be aligned on a
  * 4-byte boundary.
  */
 extern uint16 pg_checksum_page(char *page, BlockNumber blkno);
 
+/*
+ * Special checksum value for NULL.  Tuple, index entry and column checksums
+ * never take this value.
+ */
+#define CHECKSUM_NULL 0xFFFFFFFF
+
 /* Compute checksum for arbitrary data block */
 extern uint32 pg_checksum_data(const char *data, uint32 len, uint32 init_value);
 
+/* Number of partial checksums pg_checksum_data() computes in parallel */
+#define PG_CHECKSUM_DATA_LANES 32
+
+/*
+ * State of an incremental pg_checksum_data() computation.  Feeding data to
+ * pg_logical_checksum_update() in any number of pieces and then calling
+ * pg_logical_checksum_final() gives the same result as pg_checksum_data()
+ * on the concatenation of the pieces, without ever copying them.
+ */
+typedef struct pg_logical_checksum_context
+{
+	uint32		sums[PG_CHECKSUM_DATA_LANES];	/* partial checksums */
+	uint32		init_value;
+	uint32		lane;			/* partial checksum of the next word */
+	uint32		ncarry;			/* bytes of an incomplete word in carry */
+	char		carry[sizeof(uint32)];
+} pg_logical_checksum_context;
+
+extern void pg_logical_checksum_init(pg_logical_checksum_context *ctx,
+									 uint32 init_value);
+extern void pg_logical_checksum_update(pg_logical_checksum_context *ctx,
+									   const char *data, uint32 len);
+extern uint32 pg_logical_checksum_final(pg_logical_checksum_context *ctx);
+
+/* Wider variants of pg_checksum_data, for aggregating huge numbers of values */
+extern uint64 pg_checksum_data64(const char *data, uint32 len, uint64 init_value);
+extern pg_checksum128 pg_checksum_data128(const char *data, uint32 len,
+										  pg_checksum128 init_value);
+
+/*
+ * How the checksums of many tuples or index entries are combined into the
+ * checksum of a relation or database.
+ *
+ * CHECKSUM_AGGREGATE_XOR is the original scheme.  It is cheap, but equal
+ * element checksums cancel out in pairs, so duplicated rows go unnoticed.
+ *
+ * CHECKSUM_AGGREGATE_MULTISET sums the (well-mixed, 64- or 128-bit) element
+ * checksums modulo 2^64 or 2^128.  This is still commutative and associative,
+ * so partial results of a partitioned or parallel computation can be merged
+ * by adding them, but an element only cancels out if it is added 2^64 times.
+ * Unlike XOR, removing an element is a distinct operation (subtraction), so
+ * an incrementally maintained sum can also be decremented safely.
+ */
+typedef enum ChecksumAggregate
+{
+	CHECKSUM_AGGREGATE_XOR,
+	CHECKSUM_AGGREGATE_MULTISET,
+} ChecksumAggregate;
+
+/*
+ * Spread a 32- or 64-bit element checksum over all 64 bits before adding it
+ * to a multiset sum.  This is the MurmurHash3 finalizer, which is a bijection,
+ * so distinct elements stay distinct.  The results of pg_checksum_data64()
+ * and pg_checksum_data128() are already mixed this way.
+ */
+static inline uint64
+pg_checksum_multiset_element(uint64 value)
+{
+	value ^= value >> 33;
+	value *= UINT64CONST(0xFF51AFD7ED558CCD);
+	value ^= value >> 33;
+	value *= UINT64CONST(0xC4CEB9FE1A85EC53);
+	value ^= value >> 33;
+	return value;
+}
+
+/* Add an element checksum to, or remove it from, a 64-bit multiset sum */
+static inline uint64
+pg_checksum_multiset_add64(uint64 sum, uint64 element)
+{
+	return sum + element;
+}
+
+static inline uint64
+pg_checksum_multiset_remove64(uint64 sum, uint64 element)
+{
+	return sum - element;
+}
+
+/* Likewise for a 128-bit multiset sum */
+static inline pg_checksum128
+pg_checksum_multiset_add128(pg_checksum128 sum, pg_checksum128 element)
+{
+	pg_checksum128 result;
+
+	result.lo = sum.lo + element.lo;
+	result.hi = sum.hi + element.hi + (result.lo < sum.lo);
+	return result;
+}
+
+static inline pg_checksum128
+pg_checksum_multiset_remove128(pg_checksum128 sum, pg_checksum128 element)
+{
+	pg_checksum128 result;
+
+	result.lo = sum.lo - element.lo;
+	result.hi = sum.hi - element.hi - (sum.lo < element.lo);
+	return result;
+}
+
 #endif							/* CHECKSUM_H */
\ No newline at end of file
@@ -14,11 +14,57 @@
 #define CHECKSUM_COLUMN_H
 
 #include "access/htup.h"
+#include "access/tupdesc.h"
+#include "executor/tuptable.h"
+#include "storage/checksum.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
 
-/* Special checksum value for NULL */
-#define CHECKSUM_NULL 0xFFFFFFFF
+/*
+ * Type properties that decide how the values of a column are hashed.  Built
+ * once per column so that hashing a value needs no catalog lookup.
+ */
+typedef struct ChecksumColumnInfo
+{
+    int         attnum;         /* attribute number in the tuple */
+    int         position;       /* column number mixed into checksums */
+    Oid         typid;          /* data type, for NULL collision avoidance */
+    int16       typlen;         /* pg_type.typlen */
+    bool        typbyval;       /* pg_type.typbyval */
+} ChecksumColumnInfo;
+
+/*
+ * Called by pg_checksum_columns_scan() for every visible tuple, with its
+ * TID and the checksum of the requested columns.
+ */
+typedef void (*checksum_row_callback) (ItemPointer tid, uint64 checksum,
+                                       void *arg);
+
+/* Resolving column type properties */
+extern void pg_column_checksum_info_init(ChecksumColumnInfo *info,
+                                         Oid typid, int attnum);
+extern void pg_column_checksum_info_from_desc(ChecksumColumnInfo *info,
+                                              TupleDesc tupleDesc,
+                                              int attnum);
+extern ChecksumColumnInfo *pg_column_checksum_content_info(TupleDesc tupleDesc,
+                                                           int *ncols);
 
 /* Column checksum functions */
+extern uint32 pg_column_checksum_value(const ChecksumColumnInfo *info,
+                                       Datum value, bool isnull);
+extern void pg_slot_column_checksums(TupleTableSlot *slot,
+                                     const ChecksumColumnInfo *cols,
+                                     int ncols, uint32 *checksums);
+extern uint64 pg_slot_columns_checksum(TupleTableSlot *slot,
+                                       const ChecksumColumnInfo *cols,
+                                       int ncols, uint32 *buf);
+extern void pg_checksum_columns_scan(Relation rel, Snapshot snapshot,
+                                     const AttrNumber *attnums, int nattnums,
+                                     checksum_row_callback callback,
+                                     void *arg);
+extern void pg_checksum_content_scan(Relation rel, Snapshot snapshot,
+                                     checksum_row_callback callback,
+                                     void *arg);
 extern uint32 pg_column_checksum_internal(Datum value, bool isnull,
                                           Oid typid, int32 typmod,
                                           int attnum);
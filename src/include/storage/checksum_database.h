@@ -15,13 +15,42 @@
 
 #include "postgres.h"
 
+#include "storage/block.h"
+#include "storage/checksum.h"
+#include "storage/dsm.h"
+#include "storage/shm_toc.h"
+#include "utils/relcache.h"
+
 typedef void (*checksum_progress_callback)(void *state, void *arg);
 
+/*
+ * Result of a database checksum computation for one relation.
+ */
+typedef struct DatabaseChecksumRelation
+{
+    Oid         relid;
+    char        relkind;
+    uint64      n_tuples;
+    uint64      n_pages;
+    uint64      checksum;
+    double      elapsed_ms;
+} DatabaseChecksumRelation;
+
 /* Database checksum functions */
 extern uint64 pg_database_checksum_internal(Oid dboid,
                                             bool include_system,
                                             bool include_toast,
+                                            ChecksumAggregate aggregate,
                                             checksum_progress_callback callback,
-                                            void *callback_arg);
+                                            void *callback_arg,
+                                            DatabaseChecksumRelation **relations,
+                                            int *nrelations);
+extern uint64 pg_relation_checksum_range(Relation rel, BlockNumber startblk,
+                                         BlockNumber endblk,
+                                         ChecksumAggregate aggregate,
+                                         uint64 *n_tuples);
+
+/* Entry point of parallel database checksum workers */
+extern void database_checksum_parallel_main(dsm_segment *seg, shm_toc *toc);
 
 #endif /* CHECKSUM_DATABASE_H */
\ No newline at end of file
@@ -215,61 +215,81 @@ pg_checksum_page(char *page, BlockNumber blkno)
 }
 
 /*
- * Compute checksum for arbitrary data block.
- * This is similar to pg_checksum_block but works with arbitrary length data.
+ * Load one 32-bit word from a possibly unaligned address.
+ *
+ * Callers of pg_checksum_data() routinely pass unaligned pointers (e.g. the
+ * contents of short-header varlenas), so we never dereference the input as a
+ * uint32 directly.  Compilers turn the memcpy into a single load on platforms
+ * that allow unaligned access.
  */
-static uint32
-pg_checksum_data_internal(const char *data, uint32 len, uint32 init_value)
+static inline uint32
+pg_checksum_load_word(const char *p)
+{
+    uint32      word;
+
+    memcpy(&word, p, sizeof(uint32));
+    return word;
+}
+
+/*
+ * Fold nrows full rows of N_SUMS words into the partial checksums.
+ *
+ * This is the portable row kernel.  Arbitrary-length data is processed as a
+ * matrix with N_SUMS columns, exactly like a page in pg_checksum_block(), so
+ * the inner loop has a constant trip count over independent lanes and can be
+ * auto-vectorized.  CPU-specific kernels with the same contract live in
+ * storage/checksum_simd.h; a program that provides one can point
+ * PG_CHECKSUM_DATA_ROWS at it before including this file.
+ */
+static void
+pg_checksum_data_rows_generic(uint32 *sums, const char *data, uint32 nrows)
+{
+    uint32      i,
+                j;
+
+    for (i = 0; i < nrows; i++)
+        for (j = 0; j < N_SUMS; j++)
+            CHECKSUM_COMP(sums[j],
+                          pg_checksum_load_word(data + (i * N_SUMS + j) * sizeof(uint32)));
+}
+
+#ifndef PG_CHECKSUM_DATA_ROWS
+#define PG_CHECKSUM_DATA_ROWS(sums, data, nrows) \
+    pg_checksum_data_rows_generic(sums, data, nrows)
+#endif
+
+/*
+ * Finish a pg_checksum_data() computation: fold in the ntail (< 4) bytes of
+ * a final partial word, zero-padded, into partial sum lane, mix, and fold
+ * the partial sums into the result.  Shared by the one-shot and the
+ * incremental interface, so that they cannot disagree.
+ */
+static inline uint32
+pg_checksum_data_finish(uint32 *sums, uint32 lane, const char *tail,
+                        uint32 ntail, uint32 init_value)
 {
-    uint32      sums[N_SUMS];
     uint32      result = init_value;
-    uint32      i, j, k;
-    uint32      words;
-    const uint32 *p;
-    
-    /* Ensure data is at least 4-byte aligned for performance */
-    Assert((uintptr_t)data % 4 == 0);
-    
-    /* initialize partial checksums to their corresponding offsets */
-    memcpy(sums, checksumBaseOffsets, sizeof(checksumBaseOffsets));
-    
-    /* main checksum calculation - process full words */
-    words = len / sizeof(uint32);
-    p = (const uint32 *) data;
-    
-    for (i = 0; i < words; i++)
-    {
-        /* Cycle through all N_SUMS partial sums */
-        j = i % N_SUMS;
-        CHECKSUM_COMP(sums[j], p[i]);
-    }
-    
-    /* Process remaining bytes if length not multiple of 4 */
-    if (len % sizeof(uint32) != 0)
+    uint32      i, j;
+
+    if (ntail > 0)
     {
-        uint32 last_word = 0;
-        uint32 remaining = len % sizeof(uint32);
-        const char *tail = data + (words * sizeof(uint32));
-        
-        for (k = 0; k < remaining; k++)
-        {
-            last_word |= ((uint32)(unsigned char)tail[k]) << (k * 8);
-        }
-        
-        /* Use next partial sum */
-        j = words % N_SUMS;
-        CHECKSUM_COMP(sums[j], last_word);
+        uint32      last_word = 0;
+
+        for (i = 0; i < ntail; i++)
+            last_word |= ((uint32) (unsigned char) tail[i]) << (i * 8);
+
+        CHECKSUM_COMP(sums[lane], last_word);
     }
-    
+
     /* Finally add in two rounds of zeroes for additional mixing */
     for (i = 0; i < 2; i++)
         for (j = 0; j < N_SUMS; j++)
             CHECKSUM_COMP(sums[j], 0);
-    
+
     /* xor fold partial checksums together */
     for (i = 0; i < N_SUMS; i++)
         result ^= sums[i];
-    
+
     return result;
 }
 
@@ -279,7 +299,11 @@ pg_checksum_data_internal(const char *data, uint32 len, uint32 init_value)
  *
  * This function extends the page checksum algorithm to work with arbitrary
  * data blocks. It uses the same FNV-1a based algorithm as page checksums
- * but handles variable-length data and alignment requirements.
+ * but handles variable-length data and arbitrary alignment.
+ *
+ * Word i of the input is folded into partial sum i % N_SUMS.  Full rows of
+ * N_SUMS words are handed to the row kernel; the trailing words of the last
+ * partial row and the bytes of a final partial word are folded in here.
  *
  * Parameters:
  *    data:       Pointer to the data to checksum
@@ -291,46 +315,428 @@ pg_checksum_data_internal(const char *data, uint32 len, uint32 init_value)
  *    32-bit checksum value
  *
  * Notes:
- *    - Data is automatically aligned to 4-byte boundaries if necessary
+ *    - Data need not be aligned; words are loaded with unaligned-safe reads,
+ *      so the result does not depend on the alignment of data and no copy
+ *      or allocation is ever made
  *    - The algorithm processes data in 4-byte words for efficiency
  *    - Partial words at the end are handled correctly
  */
 uint32
 pg_checksum_data(const char *data, uint32 len, uint32 init_value)
 {
-    /* If data is already 4-byte aligned, use the fast path */
-    if ((uintptr_t)data % 4 == 0)
+    uint32      sums[N_SUMS];
+    uint32      i;
+    uint32      words;
+    uint32      nrows;
+    
+    /* initialize partial checksums to their corresponding offsets */
+    memcpy(sums, checksumBaseOffsets, sizeof(checksumBaseOffsets));
+    
+    /* main checksum calculation - process full rows of words */
+    words = len / sizeof(uint32);
+    nrows = words / N_SUMS;
+    PG_CHECKSUM_DATA_ROWS(sums, data, nrows);
+
+    /* process the words of a final, partial row */
+    for (i = nrows * N_SUMS; i < words; i++)
+        CHECKSUM_COMP(sums[i % N_SUMS],
+                      pg_checksum_load_word(data + i * sizeof(uint32)));
+    
+    /* Process remaining bytes if length not multiple of 4, and finish */
+    return pg_checksum_data_finish(sums, words % N_SUMS,
+                                   data + words * sizeof(uint32),
+                                   len % sizeof(uint32), init_value);
+}
+
+/*
+ * pg_logical_checksum_init
+ *    Start an incremental pg_checksum_data() computation.
+ *
+ * Parameters:
+ *    ctx:        State to initialize
+ *    init_value: Same as for pg_checksum_data()
+ */
+void
+pg_logical_checksum_init(pg_logical_checksum_context *ctx, uint32 init_value)
+{
+    memcpy(ctx->sums, checksumBaseOffsets, sizeof(checksumBaseOffsets));
+    ctx->init_value = init_value;
+    ctx->lane = 0;
+    ctx->ncarry = 0;
+}
+
+/*
+ * pg_logical_checksum_update
+ *    Fold the next len bytes of the input into an incremental checksum.
+ *
+ * Word i of the whole input still goes to partial sum i % N_SUMS, however
+ * the input is divided into pieces: the bytes of a word split between two
+ * pieces are carried over, words up to the next row boundary are folded in
+ * one at a time, and full rows are handed to the row kernel straight from
+ * data.
+ */
+void
+pg_logical_checksum_update(pg_logical_checksum_context *ctx,
+                           const char *data, uint32 len)
+{
+    uint32      nrows;
+
+    /* Complete the word left incomplete by the previous piece */
+    if (ctx->ncarry > 0)
+    {
+        uint32      n = Min(len, sizeof(uint32) - ctx->ncarry);
+
+        memcpy(ctx->carry + ctx->ncarry, data, n);
+        ctx->ncarry += n;
+        data += n;
+        len -= n;
+
+        if (ctx->ncarry < sizeof(uint32))
+            return;
+
+        CHECKSUM_COMP(ctx->sums[ctx->lane], pg_checksum_load_word(ctx->carry));
+        ctx->lane = (ctx->lane + 1) % N_SUMS;
+        ctx->ncarry = 0;
+    }
+
+    /* Fold in single words up to the start of the next row */
+    while (ctx->lane != 0 && len >= sizeof(uint32))
+    {
+        CHECKSUM_COMP(ctx->sums[ctx->lane], pg_checksum_load_word(data));
+        ctx->lane = (ctx->lane + 1) % N_SUMS;
+        data += sizeof(uint32);
+        len -= sizeof(uint32);
+    }
+
+    /* Full rows */
+    if (ctx->lane == 0)
     {
-        return pg_checksum_data_internal(data, len, init_value);
+        nrows = len / (N_SUMS * sizeof(uint32));
+        PG_CHECKSUM_DATA_ROWS(ctx->sums, data, nrows);
+        data += nrows * N_SUMS * sizeof(uint32);
+        len -= nrows * N_SUMS * sizeof(uint32);
     }
-    else
+
+    /* The words of a final, partial row */
+    while (len >= sizeof(uint32))
     {
-        /* Copy to aligned buffer */
-        char *aligned_data;
-        uint32 checksum;
-        
-#ifdef FRONTEND
-        /* For external programs */
-        aligned_data = malloc(len + 4);
-        if (!aligned_data)
-            return 0;
-#else
-        /* Inside PostgreSQL */
-        aligned_data = (char *)palloc(len + 4);
+        CHECKSUM_COMP(ctx->sums[ctx->lane], pg_checksum_load_word(data));
+        ctx->lane = (ctx->lane + 1) % N_SUMS;
+        data += sizeof(uint32);
+        len -= sizeof(uint32);
+    }
+
+    /* Keep the bytes of a final, partial word for the next piece */
+    memcpy(ctx->carry, data, len);
+    ctx->ncarry = len;
+}
+
+/*
+ * pg_logical_checksum_final
+ *    Finish an incremental checksum computation.
+ *
+ * Returns:
+ *    The pg_checksum_data() checksum of all the data passed to
+ *    pg_logical_checksum_update() since pg_logical_checksum_init()
+ *
+ * Notes:
+ *    - This consumes the state; ctx must be initialized again before it
+ *      can be reused
+ */
+uint32
+pg_logical_checksum_final(pg_logical_checksum_context *ctx)
+{
+    return pg_checksum_data_finish(ctx->sums, ctx->lane, ctx->carry,
+                                   ctx->ncarry, ctx->init_value);
+}
+
+/*
+ * Wide checksum variants.
+ *
+ * A 32-bit checksum is fine for detecting corruption of a single value, but
+ * aggregates over billions of tuples need more bits: with 32-bit tuple
+ * checksums the birthday bound is reached after ~65k tuples, and a 32-bit
+ * lane state limits any checksum built from it to 32 bits of collision
+ * resistance no matter how it is folded.
+ *
+ * The wide variants keep the N_SUMS lane layout but widen each lane to 64
+ * bits and consume the input in 64-bit words, so word i is folded into lane
+ * i % N_SUMS exactly as in pg_checksum_data().  That keeps the number of
+ * multiplications per byte the same as the 32-bit kernel.  The 128-bit
+ * variant runs a second, independent family of lanes with a different
+ * multiplier and offsets over the same words.
+ *
+ * The 64-bit FNV prime is sparse, so a few rounds of the lane formula don't
+ * avalanche well in 64 bits; the folded result is therefore finished with
+ * the MurmurHash3 64-bit finalizer.  The input length is folded in as a
+ * final word, so inputs that differ only in trailing zero bytes don't
+ * collide.
+ */
+
+/* prime multipliers of the wide lane families */
+#define FNV_PRIME64 UINT64CONST(0x100000001B3)
+#define WIDE_PRIME64 UINT64CONST(0x9E3779B97F4A7C15)
+
+/*
+ * Base offsets of the 64-bit lanes, and of the second family of lanes used
+ * by the 128-bit variant.  Like checksumBaseOffsets these were chosen
+ * randomly.
+ */
+static const uint64 checksumBaseOffsets64[N_SUMS] = {
+	UINT64CONST(0xBA6DD33E22266A0B), UINT64CONST(0x83C9E5DB8F89697F),
+	UINT64CONST(0xAE5B7A7DA9F7E03C), UINT64CONST(0x8C39D2EE690383A8),
+	UINT64CONST(0x71AD04CF4BE4BE01), UINT64CONST(0x1939B0172C97BFA5),
+	UINT64CONST(0x96256BBEB51F55BF), UINT64CONST(0xD94D7FDCF41C2ED8),
+	UINT64CONST(0x3B0B01D086BFC778), UINT64CONST(0x44E607C587B8D17B),
+	UINT64CONST(0x2A9028A20D9604AE), UINT64CONST(0xC34457D6BA0FC478),
+	UINT64CONST(0xFCC18536CFC647F1), UINT64CONST(0xBEA235B2A0AB26AC),
+	UINT64CONST(0xA22116B9C3FD9D7F), UINT64CONST(0xA7F5050DA4A714D3),
+	UINT64CONST(0xAFD524FB0FBBC1B9), UINT64CONST(0xBE89D0FF00D38174),
+	UINT64CONST(0x9A066965E4811B6A), UINT64CONST(0x5BA1BD9878DB4C1E),
+	UINT64CONST(0x68EAED9E903A586D), UINT64CONST(0xA43916B9AA131079),
+	UINT64CONST(0xA230A4B0F3D71CEA), UINT64CONST(0x97876A865C181AB0),
+	UINT64CONST(0x7762B5C964F7585A), UINT64CONST(0x6E5B33891ED99506),
+	UINT64CONST(0x6BAF298FA2FDA818), UINT64CONST(0x0F74A8C358E4B89F),
+	UINT64CONST(0x9A9BF59280381DE4), UINT64CONST(0xA92FA52B3B41F8B5),
+	UINT64CONST(0x073C953CB490044E), UINT64CONST(0x39279A1979952EE7)
+};
+
+static const uint64 checksumBaseOffsets128[N_SUMS] = {
+	UINT64CONST(0x8271925F8E540A7F), UINT64CONST(0xEB41C4FF504D65AF),
+	UINT64CONST(0x25C06752C25316A9), UINT64CONST(0x23356714C3A24536),
+	UINT64CONST(0xC5644F124083694D), UINT64CONST(0x853A4696DB65B72F),
+	UINT64CONST(0x2635F8788A11DDEC), UINT64CONST(0x17F94F3BC95C8898),
+	UINT64CONST(0xCB23D365E35931CF), UINT64CONST(0xD24F1F56C2B772B0),
+	UINT64CONST(0x7248327067170B31), UINT64CONST(0x13E061D0796D8D6F),
+	UINT64CONST(0xF2B7402048E4E6B7), UINT64CONST(0xDCA7640D230441D5),
+	UINT64CONST(0x28BAA50E1F371E21), UINT64CONST(0x4E2F360AC32A33D5),
+	UINT64CONST(0x5786B560A16EFC06), UINT64CONST(0x1C4C0673A0F6CF04),
+	UINT64CONST(0x587E95517700C5C9), UINT64CONST(0x9AF9EA03990CCF81),
+	UINT64CONST(0x0DC06A71A09B9FAD), UINT64CONST(0x10EF852CE214AC26),
+	UINT64CONST(0xFAE6AA9C52CEBE1D), UINT64CONST(0x5963DBE61768CDFD),
+	UINT64CONST(0x8CA450A6101D63FD), UINT64CONST(0xDBCF6107F7A42EF8),
+	UINT64CONST(0x62C9C99910C215A0), UINT64CONST(0xAFF4CD19B6F51682),
+	UINT64CONST(0x10A03BFEB1398005), UINT64CONST(0xF155611BCBC30030),
+	UINT64CONST(0x686DBD4E20BBFBCE), UINT64CONST(0x81D82AC7ED2749AA)
+};
+
+/*
+ * Calculate one round of a 64-bit lane.
+ */
+#define CHECKSUM_COMP64(checksum, value, prime) \
+do { \
+	uint64 __tmp = (checksum) ^ (value); \
+	(checksum) = __tmp * (prime) ^ (__tmp >> 29); \
+} while (0)
+
+/*
+ * Load one 64-bit word from a possibly unaligned address.
+ */
+static inline uint64
+pg_checksum_load_word64(const char *p)
+{
+    uint64      word;
+
+    memcpy(&word, p, sizeof(uint64));
+    return word;
+}
+
+/*
+ * Load the final, partial 64-bit word of an input, zero-padded.
+ */
+static inline uint64
+pg_checksum_load_tail64(const char *p, uint32 remaining)
+{
+    uint64      word = 0;
+    uint32      k;
+
+    for (k = 0; k < remaining; k++)
+        word |= ((uint64) (unsigned char) p[k]) << (k * 8);
+    return word;
+}
+
+/*
+ * MurmurHash3 64-bit finalizer, for a full avalanche of the folded lanes.
+ */
+static inline uint64
+pg_checksum_fmix64(uint64 h)
+{
+    h ^= h >> 33;
+    h *= UINT64CONST(0xFF51AFD7ED558CCD);
+    h ^= h >> 33;
+    h *= UINT64CONST(0xC4CEB9FE1A85EC53);
+    h ^= h >> 33;
+    return h;
+}
+
+/*
+ * Fold nrows full rows of N_SUMS 64-bit words into the 64-bit lanes.
+ */
+static void
+pg_checksum_data_rows64_generic(uint64 *sums, const char *data, uint32 nrows)
+{
+    uint32      i,
+                j;
+
+    for (i = 0; i < nrows; i++)
+        for (j = 0; j < N_SUMS; j++)
+            CHECKSUM_COMP64(sums[j],
+                            pg_checksum_load_word64(data + (i * N_SUMS + j) * sizeof(uint64)),
+                            FNV_PRIME64);
+}
+
+/*
+ * Fold nrows full rows of N_SUMS 64-bit words into both lane families of
+ * the 128-bit variant.
+ */
+static void
+pg_checksum_data_rows128_generic(uint64 *sums_a, uint64 *sums_b,
+                                 const char *data, uint32 nrows)
+{
+    uint32      i,
+                j;
+
+    for (i = 0; i < nrows; i++)
+        for (j = 0; j < N_SUMS; j++)
+        {
+            uint64      value;
+
+            value = pg_checksum_load_word64(data + (i * N_SUMS + j) * sizeof(uint64));
+            CHECKSUM_COMP64(sums_a[j], value, FNV_PRIME64);
+            CHECKSUM_COMP64(sums_b[j], value, WIDE_PRIME64);
+        }
+}
+
+#ifndef PG_CHECKSUM_DATA_ROWS64
+#define PG_CHECKSUM_DATA_ROWS64(sums, data, nrows) \
+    pg_checksum_data_rows64_generic(sums, data, nrows)
 #endif
-        
-        /* Align to 4-byte boundary */
-        aligned_data = (char *)(((uintptr_t)aligned_data + 3) & ~(uintptr_t)3);
-        memcpy(aligned_data, data, len);
-        
-        checksum = pg_checksum_data_internal(aligned_data, len, init_value);
-        
-#ifdef FRONTEND
-        free(aligned_data);
-#else
-        pfree(aligned_data);
+
+#ifndef PG_CHECKSUM_DATA_ROWS128
+#define PG_CHECKSUM_DATA_ROWS128(sums_a, sums_b, data, nrows) \
+    pg_checksum_data_rows128_generic(sums_a, sums_b, data, nrows)
 #endif
-        
-        return checksum;
+
+/*
+ * pg_checksum_data64
+ *    Compute a 64-bit checksum for arbitrary binary data.
+ *
+ * Parameters:
+ *    data:       Pointer to the data to checksum (any alignment)
+ *    len:        Length of data in bytes
+ *    init_value: Initial value for the checksum, mixed into the final
+ *                avalanche so that it affects every output bit
+ *
+ * Returns:
+ *    64-bit checksum value
+ */
+uint64
+pg_checksum_data64(const char *data, uint32 len, uint64 init_value)
+{
+    uint64      sums[N_SUMS];
+    uint64      result = init_value;
+    uint32      i, j;
+    uint32      words;
+    uint32      nrows;
+
+    memcpy(sums, checksumBaseOffsets64, sizeof(checksumBaseOffsets64));
+
+    /* main checksum calculation - process full rows of 64-bit words */
+    words = len / sizeof(uint64);
+    nrows = words / N_SUMS;
+    PG_CHECKSUM_DATA_ROWS64(sums, data, nrows);
+
+    /* process the words of a final, partial row */
+    for (i = nrows * N_SUMS; i < words; i++)
+        CHECKSUM_COMP64(sums[i % N_SUMS],
+                        pg_checksum_load_word64(data + i * sizeof(uint64)),
+                        FNV_PRIME64);
+
+    /* process remaining bytes if length not multiple of 8 */
+    if (len % sizeof(uint64) != 0)
+        CHECKSUM_COMP64(sums[words % N_SUMS],
+                        pg_checksum_load_tail64(data + words * sizeof(uint64),
+                                                len % sizeof(uint64)),
+                        FNV_PRIME64);
+
+    /* fold in the length, then two rounds of zeroes for additional mixing */
+    CHECKSUM_COMP64(sums[0], (uint64) len, FNV_PRIME64);
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < N_SUMS; j++)
+            CHECKSUM_COMP64(sums[j], 0, FNV_PRIME64);
+
+    /* xor fold partial checksums together */
+    for (i = 0; i < N_SUMS; i++)
+        result ^= sums[i];
+
+    return pg_checksum_fmix64(result);
+}
+
+/*
+ * pg_checksum_data128
+ *    Compute a 128-bit checksum for arbitrary binary data.
+ *
+ * The high half is computed exactly like pg_checksum_data64() (with
+ * init_value.hi); the low half comes from a second, independent family of
+ * lanes (with init_value.lo).
+ */
+pg_checksum128
+pg_checksum_data128(const char *data, uint32 len, pg_checksum128 init_value)
+{
+    uint64      sums_a[N_SUMS];
+    uint64      sums_b[N_SUMS];
+    pg_checksum128 result = init_value;
+    uint32      i, j;
+    uint32      words;
+    uint32      nrows;
+
+    memcpy(sums_a, checksumBaseOffsets64, sizeof(checksumBaseOffsets64));
+    memcpy(sums_b, checksumBaseOffsets128, sizeof(checksumBaseOffsets128));
+
+    /* main checksum calculation - process full rows of 64-bit words */
+    words = len / sizeof(uint64);
+    nrows = words / N_SUMS;
+    PG_CHECKSUM_DATA_ROWS128(sums_a, sums_b, data, nrows);
+
+    /* process the words of a final, partial row */
+    for (i = nrows * N_SUMS; i < words; i++)
+    {
+        uint64      value = pg_checksum_load_word64(data + i * sizeof(uint64));
+
+        CHECKSUM_COMP64(sums_a[i % N_SUMS], value, FNV_PRIME64);
+        CHECKSUM_COMP64(sums_b[i % N_SUMS], value, WIDE_PRIME64);
+    }
+
+    /* process remaining bytes if length not multiple of 8 */
+    if (len % sizeof(uint64) != 0)
+    {
+        uint64      value;
+
+        value = pg_checksum_load_tail64(data + words * sizeof(uint64),
+                                        len % sizeof(uint64));
+        CHECKSUM_COMP64(sums_a[words % N_SUMS], value, FNV_PRIME64);
+        CHECKSUM_COMP64(sums_b[words % N_SUMS], value, WIDE_PRIME64);
+    }
+
+    /* fold in the length, then two rounds of zeroes for additional mixing */
+    CHECKSUM_COMP64(sums_a[0], (uint64) len, FNV_PRIME64);
+    CHECKSUM_COMP64(sums_b[0], (uint64) len, WIDE_PRIME64);
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < N_SUMS; j++)
+        {
+            CHECKSUM_COMP64(sums_a[j], 0, FNV_PRIME64);
+            CHECKSUM_COMP64(sums_b[j], 0, WIDE_PRIME64);
+        }
+
+    /* xor fold partial checksums together */
+    for (i = 0; i < N_SUMS; i++)
+    {
+        result.hi ^= sums_a[i];
+        result.lo ^= sums_b[i];
     }
-}
\ No newline at end of file
+
+    result.hi = pg_checksum_fmix64(result.hi);
+    result.lo = pg_checksum_fmix64(result.lo);
+
+    return result;
+}
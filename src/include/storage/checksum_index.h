@@ -14,11 +14,36 @@
 #define CHECKSUM_INDEX_H
 
 #include "access/itup.h"
+#include "access/tidstore.h"
+#include "storage/block.h"
+#include "utils/relcache.h"
+
+/*
+ * Called once for every logical entry of an index (a key and heap TID pair,
+ * or a BRIN range summary), with its checksum.
+ */
+typedef void (*checksum_index_entry_callback) (uint32 checksum, void *arg);
 
 /* Index checksum functions */
-extern uint32 pg_index_tuple_checksum(IndexTuple itup,
-                                      TupleDesc indexTupDesc,
-                                      OffsetNumber attno);
-extern uint32 pg_index_page_checksum(Page page, TupleDesc indexTupDesc);
+extern uint32 pg_index_tuple_checksum(IndexTuple itup);
+extern BlockNumber pg_index_checksum_scan_range(Relation index,
+                                                BlockNumber startblk,
+                                                BlockNumber endblk,
+                                                checksum_index_entry_callback callback,
+                                                void *arg);
+extern BlockNumber pg_index_checksum_scan_range_ext(Relation index,
+                                                    BlockNumber startblk,
+                                                    BlockNumber endblk,
+                                                    TidStore *exclude_tids,
+                                                    checksum_index_entry_callback callback,
+                                                    void *arg);
+extern void pg_index_heap_checksum_scan_range(Relation heap, Relation index,
+                                              BlockNumber startblk,
+                                              BlockNumber endblk,
+                                              checksum_index_entry_callback callback,
+                                              void *arg);
+extern int64 pg_index_heap_dead_tids(Relation heap, BlockNumber startblk,
+                                     BlockNumber endblk, TidStore *dead_tids,
+                                     size_t max_bytes);
 
-#endif /* CHECKSUM_INDEX_H */
\ No newline at end of file
+#endif /* CHECKSUM_INDEX_H */
@@ -0,0 +1,67 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_logical.h
+ *    Incrementally maintained logical table checksums
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_logical.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_LOGICAL_H
+#define CHECKSUM_LOGICAL_H
+
+#include "access/htup.h"
+#include "access/xlogdefs.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
+
+/* GUC */
+extern PGDLLIMPORT int max_logical_checksum_relations;
+
+/*
+ * Logical checksum of a table: the multiset sum (modulo 2^64) of the
+ * pg_tuple_logical_checksum64() of its rows, and the number of rows.
+ */
+typedef struct LogicalChecksum
+{
+    uint64      checksum;
+    int64       ntuples;
+} LogicalChecksum;
+
+/* Shared memory */
+extern Size LogicalChecksumShmemSize(void);
+extern void LogicalChecksumShmemInit(void);
+
+/* Changes to tables with the logical_checksum storage parameter */
+extern void pg_logical_checksum_insert(Relation rel, HeapTuple tuple);
+extern void pg_logical_checksum_delete(Relation rel, HeapTuple tuple);
+extern void pg_logical_checksum_truncate(Relation rel);
+
+/* Starting and stopping maintenance */
+extern void pg_logical_checksum_enable(Relation rel);
+extern void pg_logical_checksum_disable(Oid relid);
+extern void pg_logical_checksum_rewrite(Oid relid);
+extern void pg_logical_checksum_drop_database(Oid dbid);
+
+/* Reading the checksum */
+extern bool pg_logical_checksum_get(Oid relid, LogicalChecksum *result);
+extern LogicalChecksum pg_table_logical_checksum_internal(Relation rel,
+                                                          Snapshot snapshot);
+
+/* Transaction management */
+extern void AtEOXact_LogicalChecksum(bool isCommit);
+extern void AtEOSubXact_LogicalChecksum(bool isCommit, int nestDepth);
+extern void AtPrepare_LogicalChecksum(void);
+extern void LogicalChecksumLogDeltas(void);
+extern void LogicalChecksumApplyDeltas(XLogRecPtr commit_end);
+
+/* Checkpoints and recovery */
+extern void CheckPointLogicalChecksums(void);
+extern void StartupLogicalChecksums(void);
+extern void LogicalChecksumRedoCommit(TransactionId xid, XLogRecPtr commit_end);
+extern void LogicalChecksumRedoAbort(TransactionId xid);
+
+#endif                          /* CHECKSUM_LOGICAL_H */
@@ -0,0 +1,58 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_logical_xlog.h
+ *    WAL records of incrementally maintained logical table checksums
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_logical_xlog.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_LOGICAL_XLOG_H
+#define CHECKSUM_LOGICAL_XLOG_H
+
+#include "access/xlogreader.h"
+#include "lib/stringinfo.h"
+
+/* XLOG records of the LogicalChecksum resource manager */
+#define XLOG_LOGICAL_CHECKSUM_DELTA 0x00
+
+/* Flags of xl_logical_checksum_item */
+#define XLLC_RESET      0x01    /* replace the aggregate instead of adding */
+#define XLLC_DROP       0x02    /* stop maintaining the aggregate */
+
+/*
+ * Change of the logical checksum of one relation made by a transaction.
+ * checksum is added to the relation's checksum modulo 2^64, and ntuples to
+ * its tuple count; with XLLC_RESET, they replace them instead.
+ */
+typedef struct xl_logical_checksum_item
+{
+    Oid         relid;
+    uint8       flags;
+    int64       ntuples;
+    uint64      checksum;
+} xl_logical_checksum_item;
+
+/*
+ * Changes made by a transaction, logged just before its commit record.  They
+ * take effect when the commit record is replayed.
+ */
+typedef struct xl_logical_checksum_delta
+{
+    Oid         dbid;
+    int         nitems;
+    xl_logical_checksum_item items[FLEXIBLE_ARRAY_MEMBER];
+} xl_logical_checksum_delta;
+
+#define SizeOfLogicalChecksumDelta  offsetof(xl_logical_checksum_delta, items)
+
+extern void logical_checksum_redo(XLogReaderState *record);
+extern void logical_checksum_desc(StringInfo buf, XLogReaderState *record);
+extern const char *logical_checksum_identify(uint8 info);
+extern void logical_checksum_xlog_startup(void);
+extern void logical_checksum_xlog_cleanup(void);
+
+#endif                          /* CHECKSUM_LOGICAL_XLOG_H */
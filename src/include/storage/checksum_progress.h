@@ -0,0 +1,58 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_progress.h
+ *    Progress reporting of checksum computations
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_progress.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_PROGRESS_H
+#define CHECKSUM_PROGRESS_H
+
+#include "commands/progress.h"
+#include "utils/backend_progress.h"
+#include "utils/relcache.h"
+
+/*
+ * Work done by a scan since it last reported progress.  Scans count their
+ * blocks, tuples and bytes here and report them in batches, which keeps
+ * parallel workers from messaging the leader for every page.
+ */
+typedef struct ChecksumProgressCounter
+{
+    int64       blocks;
+    int64       tuples;
+    int64       bytes;
+} ChecksumProgressCounter;
+
+/* Number of blocks a scan processes between two progress reports */
+#define CHECKSUM_PROGRESS_INTERVAL 64
+
+extern bool pg_checksum_progress_begin(int command, Oid relid);
+extern bool pg_checksum_progress_reporting(void);
+extern void pg_checksum_progress_begin_worker(bool report);
+extern void pg_checksum_progress_start_relation(Relation rel, int phase);
+extern void pg_checksum_progress_update(int index, int64 val);
+extern void pg_checksum_progress_incr(int index, int64 incr);
+extern void pg_checksum_progress_flush(ChecksumProgressCounter *counter);
+
+/*
+ * pg_checksum_progress_count
+ *    Count work done by a scan, reporting it once enough blocks are done.
+ */
+static inline void
+pg_checksum_progress_count(ChecksumProgressCounter *counter, int64 blocks,
+                           int64 tuples, int64 bytes)
+{
+    counter->blocks += blocks;
+    counter->tuples += tuples;
+    counter->bytes += bytes;
+    if (counter->blocks >= CHECKSUM_PROGRESS_INTERVAL)
+        pg_checksum_progress_flush(counter);
+}
+
+#endif                          /* CHECKSUM_PROGRESS_H */
@@ -0,0 +1,85 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_scan.h
+ *    Page-at-a-time heap and index scans for logical checksums
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_scan.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_SCAN_H
+#define CHECKSUM_SCAN_H
+
+#include "port/atomics.h"
+#include "storage/bufpage.h"
+#include "utils/relcache.h"
+#include "utils/snapshot.h"
+
+/*
+ * Called once for every heap page, with the page share-locked.  offsets
+ * holds the offset numbers of the noffsets tuples on it that are visible to
+ * the scan's snapshot, in increasing order.
+ */
+typedef void (*checksum_page_callback) (Page page, BlockNumber blkno,
+                                        const OffsetNumber *offsets,
+                                        int noffsets, void *arg);
+
+/*
+ * Called after the page passed to the checksum_page_callback of the same scan
+ * has been unlocked and released, for work that mustn't be done while holding
+ * the buffer lock, such as detoasting or writing to a tuplestore.
+ */
+typedef void (*checksum_page_release_callback) (void *arg);
+
+/*
+ * Called once for every initialized index page, with the page share-locked.
+ */
+typedef void (*checksum_index_page_callback) (Page page, BlockNumber blkno,
+                                              void *arg);
+
+/*
+ * Shared state of a heap scan divided among the participants of a parallel
+ * checksum computation.  Participants claim chunks of consecutive blocks
+ * until none are left.
+ */
+typedef struct ChecksumParallelScanData
+{
+    BlockNumber nblocks;        /* number of blocks to scan */
+    pg_atomic_uint64 next_block;    /* first block of the next chunk */
+} ChecksumParallelScanData;
+
+typedef ChecksumParallelScanData *ChecksumParallelScan;
+
+extern void pg_checksum_heap_scan(Relation rel, Snapshot snapshot,
+                                  checksum_page_callback callback,
+                                  void *arg);
+extern BlockNumber pg_checksum_heap_scan_range(Relation rel,
+                                               Snapshot snapshot,
+                                               BlockNumber startblk,
+                                               BlockNumber endblk,
+                                               checksum_page_callback callback,
+                                               void *arg);
+extern BlockNumber pg_checksum_heap_scan_range_ext(Relation rel,
+                                                   Snapshot snapshot,
+                                                   BlockNumber startblk,
+                                                   BlockNumber endblk,
+                                                   checksum_page_callback callback,
+                                                   checksum_page_release_callback release,
+                                                   void *arg);
+
+extern void pg_checksum_index_scan_range(Relation rel, BlockNumber startblk,
+                                         BlockNumber endblk,
+                                         checksum_index_page_callback callback,
+                                         void *arg);
+
+extern void pg_checksum_parallelscan_initialize(Relation rel,
+                                                ChecksumParallelScan pscan);
+extern void pg_checksum_heap_scan_parallel(Relation rel, Snapshot snapshot,
+                                           ChecksumParallelScan pscan,
+                                           checksum_page_callback callback,
+                                           void *arg);
+
+#endif                          /* CHECKSUM_SCAN_H */
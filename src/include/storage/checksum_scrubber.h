@@ -0,0 +1,24 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_scrubber.h
+ *    Background worker verifying logical checksums of relations
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_scrubber.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_SCRUBBER_H
+#define CHECKSUM_SCRUBBER_H
+
+/* GUCs */
+extern PGDLLIMPORT char *checksum_scrubber_database;
+extern PGDLLIMPORT int checksum_scrubber_max_rate;
+extern PGDLLIMPORT int checksum_scrubber_naptime;
+
+extern void ChecksumScrubberRegister(void);
+extern void ChecksumScrubberMain(Datum main_arg);
+
+#endif                          /* CHECKSUM_SCRUBBER_H */
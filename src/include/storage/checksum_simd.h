@@ -0,0 +1,142 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_simd.h
+ *    CPU-specific kernels for the arbitrary-length data checksum
+ *
+ * pg_checksum_data() treats its input as rows of CHECKSUM_SIMD_N_SUMS 32-bit
+ * words and folds each column of that matrix into its own FNV-based lane.
+ * The row kernels declared here do exactly the same arithmetic as the
+ * portable kernel in storage/checksum_impl.h, just with explicit vector
+ * instructions, so every kernel produces bit-identical results.
+ *
+ * The kernel actually used is chosen at runtime on first use, in the same
+ * way as the CRC-32C implementation (see port/pg_crc32c.h).
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_simd.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_SIMD_H
+#define CHECKSUM_SIMD_H
+
+/*
+ * Lane count and multiplier of the kernels.  These must match N_SUMS and
+ * FNV_PRIME in storage/checksum_impl.h, which is verified at compile time.
+ */
+#define CHECKSUM_SIMD_N_SUMS 32
+#define CHECKSUM_SIMD_FNV_PRIME 16777619
+
+/* Multipliers of the two 64-bit lane families of the wide variants */
+#define CHECKSUM_SIMD_FNV_PRIME64 UINT64CONST(0x100000001B3)
+#define CHECKSUM_SIMD_WIDE_PRIME64 UINT64CONST(0x9E3779B97F4A7C15)
+
+/*
+ * Fold nrows full rows of CHECKSUM_SIMD_N_SUMS words, starting at data, into
+ * the partial checksums in sums.  data need not be aligned.
+ */
+typedef void (*pg_checksum_rows_function) (uint32 *sums, const char *data,
+                                           uint32 nrows);
+
+/*
+ * Row kernels of pg_checksum_data64() and pg_checksum_data128(): a row is
+ * CHECKSUM_SIMD_N_SUMS 64-bit words, folded into one or two families of
+ * 64-bit lanes.
+ */
+typedef void (*pg_checksum_rows64_function) (uint64 *sums, const char *data,
+                                             uint32 nrows);
+typedef void (*pg_checksum_rows128_function) (uint64 *sums_a, uint64 *sums_b,
+                                              const char *data, uint32 nrows);
+
+/* Currently selected row kernels; they start out pointing at a chooser */
+extern PGDLLIMPORT pg_checksum_rows_function pg_checksum_data_rows;
+extern PGDLLIMPORT pg_checksum_rows64_function pg_checksum_data_rows64;
+extern PGDLLIMPORT pg_checksum_rows128_function pg_checksum_data_rows128;
+
+/*
+ * x86-64 kernels need a cpuid instruction to decide which of them is safe to
+ * use.  The AVX2 and AVX-512 ones additionally need XGETBV to verify that the
+ * OS saves the wider registers across context switches.
+ */
+#if (defined(__x86_64__) || defined(_M_AMD64)) && \
+    (defined(HAVE__GET_CPUID) || defined(HAVE__CPUID))
+#define USE_CHECKSUM_SSE41_WITH_RUNTIME_CHECK
+#if defined(HAVE_XSAVE_INTRINSICS) && \
+    (defined(HAVE__GET_CPUID_COUNT) || defined(HAVE__CPUIDEX))
+#define USE_CHECKSUM_AVX2_WITH_RUNTIME_CHECK
+#if defined(USE_AVX512_POPCNT_WITH_RUNTIME_CHECK) || \
+    defined(USE_AVX512_CRC32C_WITH_RUNTIME_CHECK)
+#define USE_CHECKSUM_AVX512_WITH_RUNTIME_CHECK
+#endif
+#endif
+#endif
+
+/* Neon is a mandatory part of aarch64, so no runtime check is needed there */
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define USE_CHECKSUM_NEON
+#endif
+
+#ifdef USE_CHECKSUM_SSE41_WITH_RUNTIME_CHECK
+extern bool pg_checksum_sse41_available(void);
+extern void pg_checksum_data_rows_sse41(uint32 *sums, const char *data,
+                                        uint32 nrows);
+#endif
+#ifdef USE_CHECKSUM_AVX2_WITH_RUNTIME_CHECK
+extern bool pg_checksum_avx2_available(void);
+extern void pg_checksum_data_rows_avx2(uint32 *sums, const char *data,
+                                       uint32 nrows);
+extern void pg_checksum_data_rows64_avx2(uint64 *sums, const char *data,
+                                         uint32 nrows);
+extern void pg_checksum_data_rows128_avx2(uint64 *sums_a, uint64 *sums_b,
+                                          const char *data, uint32 nrows);
+#endif
+#ifdef USE_CHECKSUM_AVX512_WITH_RUNTIME_CHECK
+extern bool pg_checksum_avx512_available(void);
+extern void pg_checksum_data_rows_avx512(uint32 *sums, const char *data,
+                                         uint32 nrows);
+
+/* 64-bit lane multiplication needs AVX-512DQ in addition to AVX-512F */
+extern bool pg_checksum_avx512dq_available(void);
+extern void pg_checksum_data_rows64_avx512(uint64 *sums, const char *data,
+                                           uint32 nrows);
+extern void pg_checksum_data_rows128_avx512(uint64 *sums_a, uint64 *sums_b,
+                                            const char *data, uint32 nrows);
+#endif
+#ifdef USE_CHECKSUM_NEON
+extern void pg_checksum_data_rows_neon(uint32 *sums, const char *data,
+                                       uint32 nrows);
+#endif
+
+/*
+ * Every row kernel compiled into this build, fastest first.  available is
+ * NULL for kernels that need no runtime check.  The first entry whose check
+ * passes is the one pg_checksum_data() uses; tests walk the whole table.
+ */
+typedef struct pg_checksum_rows_kernel
+{
+    const char *name;
+    bool        (*available) (void);
+    pg_checksum_rows_function rows;
+} pg_checksum_rows_kernel;
+
+extern PGDLLIMPORT const pg_checksum_rows_kernel pg_checksum_data_kernels[];
+extern PGDLLIMPORT const int pg_checksum_data_nkernels;
+
+/* Likewise for the row kernels of the wide variants */
+typedef struct pg_checksum_wide_kernel
+{
+    const char *name;
+    bool        (*available) (void);
+    pg_checksum_rows64_function rows64;
+    pg_checksum_rows128_function rows128;
+} pg_checksum_wide_kernel;
+
+extern PGDLLIMPORT const pg_checksum_wide_kernel pg_checksum_data_wide_kernels[];
+extern PGDLLIMPORT const int pg_checksum_data_nwide_kernels;
+
+/* Name of the row kernel in use, for benchmarks and diagnostics */
+extern const char *pg_checksum_data_kernel_name(void);
+
+#endif /* CHECKSUM_SIMD_H */
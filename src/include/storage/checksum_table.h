@@ -0,0 +1,39 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_table.h
+ *    Table-level checksum declarations
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_table.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_TABLE_H
+#define CHECKSUM_TABLE_H
+
+#include "storage/checksum.h"
+#include "storage/dsm.h"
+#include "storage/shm_toc.h"
+
+/*
+ * Width of the tuple checksums aggregated into a table checksum.
+ */
+typedef enum ChecksumWidth
+{
+    CHECKSUM_WIDTH_32,
+    CHECKSUM_WIDTH_64,
+    CHECKSUM_WIDTH_128,
+} ChecksumWidth;
+
+/* Table checksum functions */
+extern pg_checksum128 pg_table_checksum_internal(Oid reloid,
+                                                 bool include_header,
+                                                 ChecksumWidth width,
+                                                 ChecksumAggregate aggregate);
+
+/* Entry point of parallel table checksum workers */
+extern void checksum_table_parallel_main(dsm_segment *seg, shm_toc *toc);
+
+#endif                          /* CHECKSUM_TABLE_H */
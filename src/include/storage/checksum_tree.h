@@ -0,0 +1,44 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_tree.h
+ *    Merkle tree checksums over block ranges of a table
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_tree.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CHECKSUM_TREE_H
+#define CHECKSUM_TREE_H
+
+#include "storage/block.h"
+
+/*
+ * One node of a table checksum tree.  Level 0 holds the root; the leaves
+ * are on the last level.  A node covers blocks startblk up to endblk
+ * (exclusive).
+ */
+typedef struct ChecksumTreeNode
+{
+    int         level;
+    int         node;           /* position within the level */
+    BlockNumber startblk;
+    BlockNumber endblk;
+    uint64      n_tuples;
+    uint64      checksum;
+} ChecksumTreeNode;
+
+/*
+ * Upper limit for the fanout of a tree.  It keeps the per-level arithmetic
+ * from overflowing and bounds the per-node scratch arrays.
+ */
+#define CHECKSUM_TREE_MAX_FANOUT 65536
+
+extern ChecksumTreeNode *pg_table_checksum_tree_internal(Oid reloid,
+                                                         int fanout,
+                                                         BlockNumber leaf_blocks,
+                                                         int *nnodes);
+
+#endif                          /* CHECKSUM_TREE_H */
@@ -13,10 +13,22 @@
 #ifndef CHECKSUM_TUPLE_H
 #define CHECKSUM_TUPLE_H
 
+#include "access/htup.h"
 #include "storage/bufpage.h"
+#include "storage/checksum.h"
 
 /* Tuple checksum functions */
 extern uint32 pg_tuple_checksum(Page page, OffsetNumber offnum, BlockNumber blkno, bool include_header);
 extern uint32 pg_index_checksum(Page page, OffsetNumber offnum);
 
+/* Wide tuple checksums, for aggregation over very large relations */
+extern uint64 pg_tuple_checksum64(Page page, OffsetNumber offnum,
+                                  BlockNumber blkno, bool include_header);
+extern pg_checksum128 pg_tuple_checksum128(Page page, OffsetNumber offnum,
+                                           BlockNumber blkno,
+                                           bool include_header);
+
+/* Location- and MVCC-independent checksum of the contents of a heap tuple */
+extern uint64 pg_tuple_logical_checksum64(HeapTupleHeader tuple, uint32 len);
+
 #endif
\ No newline at end of file
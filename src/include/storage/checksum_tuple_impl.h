@@ -0,0 +1,156 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_tuple_impl.h
+ *    Tuple checksum implementation.
+ *
+ * This file exists for the benefit of external programs that compute the
+ * checksums of heap tuples directly from relation files, like pg_checksums
+ * --logical does.  They can #include this, after storage/checksum_impl.h,
+ * to get the code referenced by pg_tuple_checksum() in
+ * storage/checksum_tuple.h.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/storage/checksum_tuple_impl.h
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "access/htup_details.h"
+#include "storage/bufpage.h"
+#include "storage/checksum.h"
+#include "storage/checksum_tuple.h"
+
+/*
+ * tuple_checksum_input
+ *    Locate the bytes of a heap tuple that make up its checksum.
+ *
+ * Returns false if the offset is invalid or the line pointer is unused, or
+ * if include_header is false and the tuple has no data.  Otherwise sets
+ * *tuple, *data and *len.
+ *
+ * Checksums are computed even for deleted tuples (e.g., old versions after
+ * UPDATE), to maintain integrity of all row versions throughout their
+ * lifecycle.
+ */
+static bool
+tuple_checksum_input(Page page, OffsetNumber offnum, bool include_header,
+                     HeapTupleHeader *tuple, char **data, uint32 *len)
+{
+    ItemId      lp;
+
+    /* Validate offset number range */
+    if (offnum < FirstOffsetNumber || offnum > PageGetMaxOffsetNumber(page))
+        return false;
+
+    lp = PageGetItemId(page, offnum);
+
+    /* Skip unused ItemIds (deallocated tuple slots) */
+    if (!ItemIdIsUsed(lp))
+        return false;
+
+    *tuple = (HeapTupleHeader) PageGetItem(page, lp);
+    *len = ItemIdGetLength(lp);
+
+    if (include_header)
+    {
+        /* Include entire tuple (header + data) in checksum */
+        *data = (char *) *tuple;
+    }
+    else
+    {
+        /* Skip header, checksum only the tuple data */
+        if (*len <= (*tuple)->t_hoff)
+            return false;
+
+        *data = (char *) *tuple + (*tuple)->t_hoff;
+        *len -= (*tuple)->t_hoff;
+    }
+
+    return true;
+}
+
+/*
+ * pg_tuple_checksum
+ *    Compute a checksum for a heap tuple.
+ *
+ * This function calculates a 32-bit checksum for a heap tuple, optionally
+ * including the tuple header. The checksum incorporates:
+ *    - The tuple's physical location (block number and offset)
+ *    - MVCC information (xmin/xmax) when header is not included
+ *    - Either the entire tuple or just the data portion
+ *
+ * Parameters:
+ *    page:           Page containing the tuple
+ *    offnum:         Offset number of the tuple within the page
+ *    blkno:          Block number containing the page
+ *    include_header: If true, include the HeapTupleHeader in the calculation;
+ *                    if false, calculate checksum only on tuple data
+ *
+ * Returns:
+ *    32-bit checksum, or 0 if the offset is invalid or tuple is not used
+ *
+ * Notes:
+ *    - Checksums are computed even for deleted tuples (old row versions)
+ *      to maintain integrity across all MVCC states
+ *    - The block number and offset are encoded into a location hash
+ *      to bind the tuple to its physical location
+ *    - When excluding headers, MVCC information is XORed to differentiate
+ *      between different versions of the same logical row
+ */
+uint32
+pg_tuple_checksum(Page page, OffsetNumber offnum, BlockNumber blkno, bool include_header)
+{
+    HeapTupleHeader tuple;
+    char       *data;
+    uint32      len;
+    uint32      checksum;
+    uint32      location_hash;
+    
+    if (!tuple_checksum_input(page, offnum, include_header,
+                              &tuple, &data, &len))
+        return 0;
+
+    /*
+     * Create a location hash from block number and offset.
+     * This binds the checksum to the tuple's physical location,
+     * ensuring that identical tuples at different locations have
+     * different checksums.
+     */
+    location_hash = (blkno << 16) | offnum;
+    
+    /* Calculate checksum using location_hash as the initial value */
+    checksum = pg_checksum_data(data, len, location_hash);
+    
+    /*
+     * Additionally XOR with location_hash to guarantee uniqueness.
+     * This extra step ensures that even if pg_checksum_data produces
+     * the same result for different locations, the final checksums differ.
+     */
+    checksum ^= location_hash;
+    
+    /*
+     * Incorporate MVCC information to differentiate between row versions.
+     * This ensures that different versions of the same logical row have
+     * different checksums, which is essential for detecting corruption
+     * in MVCC chains (e.g., when xmin/xmax values are corrupted).
+     */
+    if (!include_header)
+    {
+        uint32 mvcc_info = (HeapTupleHeaderGetRawXmin(tuple) ^ 
+                           HeapTupleHeaderGetRawXmax(tuple));
+        checksum ^= mvcc_info;
+    }
+    
+    /*
+     * IMPORTANT: Guarantee that tuple checksums never equal CHECKSUM_NULL.
+     * This prevents collisions with NULL column values.
+     */
+    if (checksum == CHECKSUM_NULL)
+    {
+        checksum = (CHECKSUM_NULL ^ location_hash) & 0xFFFFFFFE;
+    }
+    
+    return checksum;
+}
@@ -28,6 +28,7 @@ typedef enum ProgressCommandType
 	PROGRESS_COMMAND_CREATE_INDEX,
 	PROGRESS_COMMAND_BASEBACKUP,
 	PROGRESS_COMMAND_COPY,
+	PROGRESS_COMMAND_CHECKSUM,
 } ProgressCommandType;
 
 #define PGSTAT_NUM_PROGRESS_PARAM	20
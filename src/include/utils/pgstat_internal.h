@@ -500,6 +500,12 @@ typedef struct PgStatShared_Relation
 	PgStat_StatTabEntry stats;
 } PgStatShared_Relation;
 
+typedef struct PgStatShared_Checksum
+{
+	PgStatShared_Common header;
+	PgStat_StatChecksumEntry stats;
+} PgStatShared_Checksum;
+
 typedef struct PgStatShared_Function
 {
 	PgStatShared_Common header;
@@ -719,6 +725,14 @@ extern void pgstat_checkpointer_reset_all_cb(TimestampTz ts);
 extern void pgstat_checkpointer_snapshot_cb(void);
 
 
+/*
+ * Functions in pgstat_checksum.c
+ */
+
+extern bool pgstat_checksum_flush_cb(PgStat_EntryRef *entry_ref, bool nowait);
+extern void pgstat_checksum_reset_timestamp_cb(PgStatShared_Common *header, TimestampTz ts);
+
+
 /*
  * Functions in pgstat_database.c
  */
@@ -345,6 +345,7 @@ typedef struct StdRdOptions
 	int			toast_tuple_target; /* target for tuple toasting */
 	AutoVacOpts autovacuum;		/* autovacuum-related options */
 	bool		user_catalog_table; /* use as an additional catalog relation */
+	bool		logical_checksum;	/* maintain a logical checksum */
 	int			parallel_workers;	/* max number of parallel workers */
 	StdRdOptIndexCleanup vacuum_index_cleanup;	/* controls index vacuuming */
 	bool		vacuum_truncate;	/* enables vacuum to truncate a relation */
@@ -401,6 +402,27 @@ typedef struct StdRdOptions
 	  (relation)->rd_rel->relkind == RELKIND_MATVIEW) ? \
 	 ((StdRdOptions *) (relation)->rd_options)->user_catalog_table : false)
 
+/*
+ * RelationGetLogicalChecksum
+ *		Returns the relation's logical_checksum reloption setting.
+ *		Note multiple eval of argument!
+ */
+#define RelationGetLogicalChecksum(relation)	\
+	((relation)->rd_options && \
+	 ((relation)->rd_rel->relkind == RELKIND_RELATION || \
+	  (relation)->rd_rel->relkind == RELKIND_MATVIEW) ? \
+	 ((StdRdOptions *) (relation)->rd_options)->logical_checksum : false)
+
+/*
+ * RelationHasLogicalChecksum
+ *		Returns whether changes to the relation maintain its logical checksum,
+ *		which is only done for permanent relations.
+ *		Note multiple eval of argument!
+ */
+#define RelationHasLogicalChecksum(relation)	\
+	(RelationGetLogicalChecksum(relation) && \
+	 (relation)->rd_rel->relpersistence == RELPERSISTENCE_PERMANENT)
+
 /*
  * RelationGetParallelWorkers
  *		Returns the relation's parallel_workers reloption setting.
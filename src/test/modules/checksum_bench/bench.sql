@@ -0,0 +1,47 @@
+-- bench.sql
+-- Report the throughput of the checksum functions, by layer.  Run by
+-- "make bench" against a running server; see README.
+
+\set ON_ERROR_STOP 1
+\pset footer off
+
+CREATE EXTENSION IF NOT EXISTS checksum_bench;
+\ir pgbench/setup.sql
+
+\echo 'pg_checksum_data(), aligned'
+SELECT size, loops, round(ns_per_byte::numeric, 4) AS ns_per_byte,
+       round(gb_per_sec::numeric, 2) AS gb_per_sec
+FROM checksum_bench_data_sizes();
+
+\echo 'pg_checksum_data(), misaligned'
+SELECT a.alignment, s.size, round(b.ns_per_byte::numeric, 4) AS ns_per_byte
+FROM (VALUES (1), (2), (3), (8)) a(alignment),
+     (VALUES (16::int8), (1024), (8192), (1048576)) s(size),
+     checksum_bench_data(s.size, a.alignment) b
+ORDER BY a.alignment, s.size;
+
+\echo 'Tuples, columns, tables and indexes'
+SELECT benchmark, bytes, tuples,
+       round(ns_per_byte::numeric, 4) AS ns_per_byte,
+       round(tuples_per_sec::numeric) AS tuples_per_sec
+FROM (
+    SELECT 'tuple narrow' AS benchmark, * FROM checksum_bench_tuple('checksum_bench_narrow')
+    UNION ALL
+    SELECT 'tuple wide' AS benchmark, * FROM checksum_bench_tuple('checksum_bench_wide')
+    UNION ALL
+    SELECT 'tuple wide, header' AS benchmark, * FROM checksum_bench_tuple('checksum_bench_wide', true)
+    UNION ALL
+    SELECT 'column int4' AS benchmark, * FROM checksum_bench_column('checksum_bench_wide', 1)
+    UNION ALL
+    SELECT 'column text' AS benchmark, * FROM checksum_bench_column('checksum_bench_wide', 3)
+    UNION ALL
+    SELECT 'column numeric' AS benchmark, * FROM checksum_bench_column('checksum_bench_wide', 4)
+    UNION ALL
+    SELECT 'table narrow' AS benchmark, * FROM checksum_bench_table('checksum_bench_narrow')
+    UNION ALL
+    SELECT 'table wide' AS benchmark, * FROM checksum_bench_table('checksum_bench_wide')
+    UNION ALL
+    SELECT 'index int4' AS benchmark, * FROM checksum_bench_index('checksum_bench_narrow_pkey')
+    UNION ALL
+    SELECT 'index text' AS benchmark, * FROM checksum_bench_index('checksum_bench_wide_name')
+) b;
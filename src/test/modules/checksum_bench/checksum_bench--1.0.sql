@@ -0,0 +1,65 @@
+-- checksum_bench--1.0.sql
+-- SQL functions for checksum microbenchmarks
+
+-- Every benchmark returns the number of timed loops, the bytes and tuples
+-- hashed by one loop, the total elapsed time, and the resulting throughput
+CREATE FUNCTION checksum_bench_data(size int8, alignment int4 DEFAULT 0,
+    nloops int4 DEFAULT 0,
+    OUT loops int4, OUT bytes int8, OUT tuples int8, OUT elapsed_ms float8,
+    OUT ns_per_byte float8, OUT tuples_per_sec float8)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE FUNCTION checksum_bench_data_loops(size int8)
+RETURNS int4
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE FUNCTION checksum_bench_tuple(reloid regclass,
+    include_header bool DEFAULT false, nloops int4 DEFAULT 10,
+    OUT loops int4, OUT bytes int8, OUT tuples int8, OUT elapsed_ms float8,
+    OUT ns_per_byte float8, OUT tuples_per_sec float8)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE FUNCTION checksum_bench_column(reloid regclass, attnum int4,
+    nloops int4 DEFAULT 10,
+    OUT loops int4, OUT bytes int8, OUT tuples int8, OUT elapsed_ms float8,
+    OUT ns_per_byte float8, OUT tuples_per_sec float8)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE FUNCTION checksum_bench_table(reloid regclass, nloops int4 DEFAULT 3,
+    OUT loops int4, OUT bytes int8, OUT tuples int8, OUT elapsed_ms float8,
+    OUT ns_per_byte float8, OUT tuples_per_sec float8)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE FUNCTION checksum_bench_index(indexoid regclass, nloops int4 DEFAULT 3,
+    OUT loops int4, OUT bytes int8, OUT tuples int8, OUT elapsed_ms float8,
+    OUT ns_per_byte float8, OUT tuples_per_sec float8)
+RETURNS record
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+-- Time pg_checksum_data() at every power of four from 16 bytes to max_size,
+-- which is at most 1GB
+CREATE FUNCTION checksum_bench_data_sizes(max_size int8 DEFAULT 1073741824,
+    alignment int4 DEFAULT 0, nloops int4 DEFAULT 0,
+    OUT size int8, OUT loops int4,
+    OUT elapsed_ms float8, OUT ns_per_byte float8, OUT gb_per_sec float8)
+RETURNS SETOF record
+AS $$
+    SELECT s.size, b.loops, b.elapsed_ms, b.ns_per_byte,
+           1 / b.ns_per_byte
+    FROM (SELECT 16::int8 << (2 * i) AS size
+          FROM generate_series(0, 13) i) s,
+         checksum_bench_data(s.size, $2, $3) b
+    WHERE s.size <= $1
+    ORDER BY s.size
+$$
+LANGUAGE SQL STRICT;
@@ -0,0 +1,531 @@
+/*-------------------------------------------------------------------------
+ *
+ * checksum_bench.c
+ *    Microbenchmarks for the checksum functions
+ *
+ * Each function here times one layer of the checksum code, from the
+ * pg_checksum_data() kernel up to whole-table and whole-index checksums,
+ * and returns the elapsed time together with the bytes and tuples hashed,
+ * so that throughput can be compared between builds.  Inputs are either
+ * generated from a fixed seed or read from a relation before the clock
+ * starts, and each measurement is preceded by an untimed warm-up run.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * IDENTIFICATION
+ *    src/test/modules/checksum_bench/checksum_bench.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "access/relation.h"
+#include "access/htup_details.h"
+#include "access/tableam.h"
+#include "catalog/index.h"
+#include "common/pg_prng.h"
+#include "executor/tuptable.h"
+#include "fmgr.h"
+#include "funcapi.h"
+#include "portability/instr_time.h"
+#include "storage/bufmgr.h"
+#include "storage/checksum.h"
+#include "storage/checksum_column.h"
+#include "storage/checksum_index.h"
+#include "storage/checksum_scan.h"
+#include "storage/checksum_table.h"
+#include "storage/checksum_tuple.h"
+#include "utils/datum.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/snapmgr.h"
+
+PG_MODULE_MAGIC;
+
+/* Largest input of checksum_bench_data() */
+#define BENCH_MAX_DATA_SIZE ((int64) 1024 * 1024 * 1024)
+
+/* Largest misalignment checksum_bench_data() can apply */
+#define BENCH_MAX_ALIGNMENT 63
+
+/* Bytes hashed per measurement when checksum_bench_data() picks the loops */
+#define BENCH_TARGET_BYTES ((int64) 256 * 1024 * 1024)
+
+/* Seed of the generated data, so every run hashes the same bytes */
+#define BENCH_SEED 0x5eed
+
+/* A heap page copied out of shared buffers, with its visible tuples */
+typedef struct BenchPage
+{
+    BlockNumber blkno;
+    int         noffsets;
+    OffsetNumber offsets[MaxHeapTuplesPerPage];
+    PGAlignedBlock data;
+} BenchPage;
+
+/* Pages collected by bench_collect_page() */
+typedef struct BenchPages
+{
+    List       *pages;
+    int64       ntuples;
+} BenchPages;
+
+/* Entries counted by bench_count_entry() */
+typedef struct BenchEntries
+{
+    int64       nentries;
+    uint32      checksum;
+} BenchEntries;
+
+/*
+ * bench_result
+ *    Form the result row shared by all benchmark functions.
+ *
+ * bytes and tuples are the amounts hashed by one loop; tuples is negative
+ * if the benchmark has no notion of tuples.
+ */
+static Datum
+bench_result(FunctionCallInfo fcinfo, int loops, int64 bytes, int64 tuples,
+             instr_time elapsed)
+{
+    TupleDesc   tupdesc;
+    Datum       values[6];
+    bool        nulls[6] = {0};
+    double      ns = (double) INSTR_TIME_GET_NANOSEC(elapsed);
+
+    if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+        elog(ERROR, "return type must be a row type");
+
+    /* Don't divide by zero for empty inputs or a coarse clock */
+    ns = Max(ns, 1.0);
+
+    values[0] = Int32GetDatum(loops);
+    values[1] = Int64GetDatum(bytes);
+    values[3] = Float8GetDatum(ns / 1000000.0);
+    if (bytes > 0)
+        values[4] = Float8GetDatum(ns / ((double) bytes * loops));
+    else
+        nulls[4] = true;
+    if (tuples >= 0)
+    {
+        values[2] = Int64GetDatum(tuples);
+        values[5] = Float8GetDatum((double) tuples * loops * 1e9 / ns);
+    }
+    else
+    {
+        nulls[2] = true;
+        nulls[5] = true;
+    }
+
+    PG_RETURN_DATUM(HeapTupleGetDatum(heap_form_tuple(tupdesc, values, nulls)));
+}
+
+/*
+ * bench_check_loops
+ *    Error out unless loops is a usable number of timed runs.
+ */
+static void
+bench_check_loops(int loops)
+{
+    if (loops < 1)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("number of loops must be at least 1")));
+}
+
+/*
+ * bench_data_loops
+ *    Number of loops to hash about BENCH_TARGET_BYTES, size bytes at a time.
+ */
+static int32
+bench_data_loops(int64 size)
+{
+    return (int32) Max(1, Min(BENCH_TARGET_BYTES / size, PG_INT32_MAX));
+}
+
+/*
+ * checksum_bench_data
+ *    SQL function: checksum_bench_data(size, alignment, nloops)
+ *
+ * Times pg_checksum_data() over size bytes of generated data, starting
+ * alignment bytes past a 64-byte boundary, nloops times.  If nloops is 0,
+ * enough loops are run to hash about BENCH_TARGET_BYTES.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_data);
+Datum
+checksum_bench_data(PG_FUNCTION_ARGS)
+{
+    int64       size = PG_GETARG_INT64(0);
+    int32       alignment = PG_GETARG_INT32(1);
+    int32       loops = PG_GETARG_INT32(2);
+    char       *buffer;
+    char       *data;
+    pg_prng_state prng;
+    uint32      checksum = 0;
+    instr_time  start;
+    instr_time  elapsed;
+
+    if (size < 1 || size > BENCH_MAX_DATA_SIZE)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("size must be between 1 and %lld bytes",
+                        (long long) BENCH_MAX_DATA_SIZE)));
+    if (alignment < 0 || alignment > BENCH_MAX_ALIGNMENT)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("alignment must be between 0 and %d",
+                        BENCH_MAX_ALIGNMENT)));
+    if (loops == 0)
+        loops = bench_data_loops(size);
+    bench_check_loops(loops);
+
+    /* Room for the data at any misalignment, past a 64-byte boundary */
+    buffer = palloc_extended(size + 2 * (BENCH_MAX_ALIGNMENT + 1),
+                             MCXT_ALLOC_HUGE);
+    data = (char *) TYPEALIGN(BENCH_MAX_ALIGNMENT + 1, buffer) + alignment;
+
+    pg_prng_seed(&prng, BENCH_SEED);
+    for (int64 i = 0; i < size; i++)
+        data[i] = (char) pg_prng_uint32(&prng);
+
+    /* Warm up the caches, and the CPU */
+    checksum ^= pg_checksum_data(data, (uint32) size, 0);
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (int i = 0; i < loops; i++)
+        checksum ^= pg_checksum_data(data, (uint32) size, checksum);
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, start);
+
+    pfree(buffer);
+
+    return bench_result(fcinfo, loops, size, -1, elapsed);
+}
+
+/*
+ * checksum_bench_data_loops
+ *    SQL function: checksum_bench_data_loops(size)
+ *
+ * Returns the number of loops checksum_bench_data() runs for size bytes
+ * when nloops is 0, without running them.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_data_loops);
+Datum
+checksum_bench_data_loops(PG_FUNCTION_ARGS)
+{
+    int64       size = PG_GETARG_INT64(0);
+
+    if (size < 1 || size > BENCH_MAX_DATA_SIZE)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("size must be between 1 and %lld bytes",
+                        (long long) BENCH_MAX_DATA_SIZE)));
+
+    PG_RETURN_INT32(bench_data_loops(size));
+}
+
+/*
+ * bench_collect_page
+ *    Copy a heap page and the offsets of its visible tuples; a
+ *    checksum_page_callback for pg_checksum_heap_scan().
+ */
+static void
+bench_collect_page(Page page, BlockNumber blkno, const OffsetNumber *offsets,
+                   int noffsets, void *arg)
+{
+    BenchPages *pages = (BenchPages *) arg;
+    BenchPage  *copy = palloc(sizeof(BenchPage));
+
+    copy->blkno = blkno;
+    copy->noffsets = noffsets;
+    memcpy(copy->offsets, offsets, noffsets * sizeof(OffsetNumber));
+    memcpy(copy->data.data, page, BLCKSZ);
+
+    pages->pages = lappend(pages->pages, copy);
+    pages->ntuples += noffsets;
+}
+
+/*
+ * bench_tuple_pass
+ *    Hash every collected tuple once, adding up their sizes in *bytes.
+ */
+static uint32
+bench_tuple_pass(List *pages, bool include_header, int64 *bytes)
+{
+    ListCell   *lc;
+    uint32      checksum = 0;
+
+    foreach(lc, pages)
+    {
+        BenchPage  *page = (BenchPage *) lfirst(lc);
+
+        for (int i = 0; i < page->noffsets; i++)
+        {
+            checksum ^= pg_tuple_checksum((Page) page->data.data,
+                                          page->offsets[i], page->blkno,
+                                          include_header);
+            if (bytes != NULL)
+                *bytes += ItemIdGetLength(PageGetItemId((Page) page->data.data,
+                                                        page->offsets[i]));
+        }
+    }
+
+    return checksum;
+}
+
+/*
+ * checksum_bench_tuple
+ *    SQL function: checksum_bench_tuple(reloid, include_header, nloops)
+ *
+ * Times pg_tuple_checksum() over every tuple of a table visible to the
+ * current snapshot.  The pages are copied into local memory first, so
+ * only hashing is timed, not reading or locking buffers.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_tuple);
+Datum
+checksum_bench_tuple(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    bool        include_header = PG_GETARG_BOOL(1);
+    int32       loops = PG_GETARG_INT32(2);
+    Relation    rel;
+    BenchPages  pages = {NIL, 0};
+    int64       bytes = 0;
+    instr_time  start;
+    instr_time  elapsed;
+
+    bench_check_loops(loops);
+
+    rel = relation_open(reloid, AccessShareLock);
+    pg_checksum_heap_scan(rel, GetActiveSnapshot(), bench_collect_page,
+                          &pages);
+    relation_close(rel, AccessShareLock);
+
+    /* The warm-up pass also measures the tuples */
+    (void) bench_tuple_pass(pages.pages, include_header, &bytes);
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (int i = 0; i < loops; i++)
+        (void) bench_tuple_pass(pages.pages, include_header, NULL);
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, start);
+
+    list_free_deep(pages.pages);
+
+    return bench_result(fcinfo, loops, bytes, pages.ntuples, elapsed);
+}
+
+/*
+ * bench_column_pass
+ *    Hash every collected value of a column once.
+ */
+static uint32
+bench_column_pass(const Datum *values, const bool *isnull, int64 nvalues,
+                  Form_pg_attribute attr)
+{
+    uint32      checksum = 0;
+
+    for (int64 i = 0; i < nvalues; i++)
+        checksum ^= pg_column_checksum_internal(values[i], isnull[i],
+                                                attr->atttypid,
+                                                attr->atttypmod,
+                                                attr->attnum);
+
+    return checksum;
+}
+
+/*
+ * checksum_bench_column
+ *    SQL function: checksum_bench_column(reloid, attnum, nloops)
+ *
+ * Times pg_column_checksum_internal() over the values of one column in
+ * every row of a table visible to the current snapshot.  The values are
+ * copied out of the table first, as stored; toasted values are hashed the
+ * way pg_column_checksum_internal() handles them.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_column);
+Datum
+checksum_bench_column(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    int32       attnum = PG_GETARG_INT32(1);
+    int32       loops = PG_GETARG_INT32(2);
+    Relation    rel;
+    TupleDesc   tupdesc;
+    Form_pg_attribute attr;
+    TableScanDesc scan;
+    TupleTableSlot *slot;
+    Datum      *values;
+    bool       *isnull;
+    int64       nvalues = 0;
+    int64       maxvalues = 1024;
+    int64       bytes = 0;
+    instr_time  start;
+    instr_time  elapsed;
+
+    bench_check_loops(loops);
+
+    rel = relation_open(reloid, AccessShareLock);
+    tupdesc = RelationGetDescr(rel);
+
+    if (attnum < 1 || attnum > tupdesc->natts ||
+        TupleDescAttr(tupdesc, attnum - 1)->attisdropped)
+        ereport(ERROR,
+                (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                 errmsg("invalid attribute number %d for relation \"%s\"",
+                        attnum, RelationGetRelationName(rel))));
+    attr = TupleDescAttr(tupdesc, attnum - 1);
+
+    values = palloc_array(Datum, maxvalues);
+    isnull = palloc_array(bool, maxvalues);
+
+    slot = table_slot_create(rel, NULL);
+    scan = table_beginscan(rel, GetActiveSnapshot(), 0, NULL);
+    while (table_scan_getnextslot(scan, ForwardScanDirection, slot))
+    {
+        if (nvalues == maxvalues)
+        {
+            maxvalues *= 2;
+            values = repalloc_huge(values, maxvalues * sizeof(Datum));
+            isnull = repalloc_huge(isnull, maxvalues * sizeof(bool));
+        }
+
+        values[nvalues] = slot_getattr(slot, attnum, &isnull[nvalues]);
+        if (!isnull[nvalues])
+        {
+            values[nvalues] = datumCopy(values[nvalues], attr->attbyval,
+                                        attr->attlen);
+            bytes += datumGetSize(values[nvalues], attr->attbyval,
+                                  attr->attlen);
+        }
+        nvalues++;
+    }
+    table_endscan(scan);
+    ExecDropSingleTupleTableSlot(slot);
+
+    /* Warm up the type cache */
+    (void) bench_column_pass(values, isnull, nvalues, attr);
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (int i = 0; i < loops; i++)
+        (void) bench_column_pass(values, isnull, nvalues, attr);
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, start);
+
+    relation_close(rel, AccessShareLock);
+
+    return bench_result(fcinfo, loops, bytes, nvalues, elapsed);
+}
+
+/*
+ * bench_count_tuples
+ *    Count the visible tuples of a page; a checksum_page_callback.
+ */
+static void
+bench_count_tuples(Page page, BlockNumber blkno, const OffsetNumber *offsets,
+                   int noffsets, void *arg)
+{
+    *(int64 *) arg += noffsets;
+}
+
+/*
+ * checksum_bench_table
+ *    SQL function: checksum_bench_table(reloid, nloops)
+ *
+ * Times pg_table_checksum_internal() with 64-bit tuple checksums, the
+ * path of pg_checksum_table64(), including reading the table through
+ * shared buffers and any parallel workers it uses.  bytes is the size of
+ * the table.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_table);
+Datum
+checksum_bench_table(PG_FUNCTION_ARGS)
+{
+    Oid         reloid = PG_GETARG_OID(0);
+    int32       loops = PG_GETARG_INT32(1);
+    Relation    rel;
+    int64       bytes;
+    int64       ntuples = 0;
+    instr_time  start;
+    instr_time  elapsed;
+
+    bench_check_loops(loops);
+
+    /* Counting the tuples doubles as the warm-up run */
+    rel = relation_open(reloid, AccessShareLock);
+    bytes = (int64) RelationGetNumberOfBlocks(rel) * BLCKSZ;
+    pg_checksum_heap_scan(rel, GetActiveSnapshot(), bench_count_tuples,
+                          &ntuples);
+    relation_close(rel, AccessShareLock);
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (int i = 0; i < loops; i++)
+        (void) pg_table_checksum_internal(reloid, false, CHECKSUM_WIDTH_64,
+                                          CHECKSUM_AGGREGATE_XOR);
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, start);
+
+    return bench_result(fcinfo, loops, bytes, ntuples, elapsed);
+}
+
+/*
+ * bench_count_entry
+ *    Count and combine index entry checksums; a
+ *    checksum_index_entry_callback.
+ */
+static void
+bench_count_entry(uint32 checksum, void *arg)
+{
+    BenchEntries *entries = (BenchEntries *) arg;
+
+    entries->nentries++;
+    entries->checksum ^= checksum;
+}
+
+/*
+ * checksum_bench_index
+ *    SQL function: checksum_bench_index(indexoid, nloops)
+ *
+ * Times pg_index_checksum_scan_range() over a whole index, the path of
+ * pg_checksum_index(), including reading the index through shared
+ * buffers.  bytes is the size of the index, and tuples the number of
+ * entries hashed.
+ */
+PG_FUNCTION_INFO_V1(checksum_bench_index);
+Datum
+checksum_bench_index(PG_FUNCTION_ARGS)
+{
+    Oid         indexoid = PG_GETARG_OID(0);
+    int32       loops = PG_GETARG_INT32(1);
+    Relation    index;
+    BenchEntries entries = {0, 0};
+    int64       bytes;
+    instr_time  start;
+    instr_time  elapsed;
+
+    bench_check_loops(loops);
+
+    index = index_open(indexoid, AccessShareLock);
+    bytes = (int64) RelationGetNumberOfBlocks(index) * BLCKSZ;
+
+    /* The warm-up run also counts the entries */
+    pg_index_checksum_scan_range(index, 0, InvalidBlockNumber,
+                                 bench_count_entry, &entries);
+
+    INSTR_TIME_SET_CURRENT(start);
+    for (int i = 0; i < loops; i++)
+    {
+        BenchEntries run = {0, 0};
+
+        pg_index_checksum_scan_range(index, 0, InvalidBlockNumber,
+                                     bench_count_entry, &run);
+    }
+    INSTR_TIME_SET_CURRENT(elapsed);
+    INSTR_TIME_SUBTRACT(elapsed, start);
+
+    index_close(index, AccessShareLock);
+
+    return bench_result(fcinfo, loops, bytes, entries.nentries, elapsed);
+}
@@ -0,0 +1,4 @@
+-- pg_checksum_column() on the widest column of one row, found by key
+\set id random(1, 200000)
+SELECT pg_checksum_column('checksum_bench_wide', ctid, 3)
+FROM checksum_bench_wide WHERE id = :id;
@@ -0,0 +1,2 @@
+-- Whole-index checksum of a text index
+SELECT pg_checksum_index('checksum_bench_wide_name');
@@ -0,0 +1,22 @@
+-- Tables for the checksum benchmarks.  The data is generated without
+-- random(), so every run hashes the same rows.
+DROP TABLE IF EXISTS checksum_bench_narrow, checksum_bench_wide;
+
+CREATE TABLE checksum_bench_narrow (id int4 PRIMARY KEY, val int8);
+INSERT INTO checksum_bench_narrow
+    SELECT g, g * 7919 FROM generate_series(1, 1000000) g;
+
+CREATE TABLE checksum_bench_wide (
+    id int4 PRIMARY KEY,
+    name text,
+    payload text,
+    amount numeric,
+    created timestamptz
+);
+INSERT INTO checksum_bench_wide
+    SELECT g, md5(g::text), repeat(md5(g::text), 1 + g % 8),
+           g * 1.25, '2026-01-01'::timestamptz + g * interval '1 second'
+    FROM generate_series(1, 200000) g;
+CREATE INDEX checksum_bench_wide_name ON checksum_bench_wide (name);
+
+VACUUM FREEZE ANALYZE checksum_bench_narrow, checksum_bench_wide;
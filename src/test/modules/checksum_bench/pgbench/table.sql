@@ -0,0 +1,2 @@
+-- Whole-table checksum of the wide table
+SELECT pg_checksum_table64('checksum_bench_wide', false);
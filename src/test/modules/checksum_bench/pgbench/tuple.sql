@@ -0,0 +1,4 @@
+-- pg_checksum_tuple() on one row, found by key
+\set id random(1, 1000000)
+SELECT pg_checksum_tuple('checksum_bench_narrow', ctid, false)
+FROM checksum_bench_narrow WHERE id = :id;
@@ -0,0 +1,43 @@
+CREATE EXTENSION checksum_bench;
+
+-- The timings vary from run to run, so only check what was measured
+
+-- Any size and alignment can be hashed
+SELECT s.size, a.alignment, b.loops, b.bytes, b.tuples,
+       b.ns_per_byte > 0 AS timed
+FROM (VALUES (1::int8), (16), (8191)) s(size),
+     (VALUES (0), (3)) a(alignment),
+     checksum_bench_data(s.size, a.alignment, 2) b
+ORDER BY s.size, a.alignment;
+
+SELECT size, loops FROM checksum_bench_data_sizes(4096, 0, 2);
+
+-- Without a number of loops, about 256MB are hashed
+SELECT s.size, checksum_bench_data_loops(s.size) AS loops
+FROM (VALUES (1::int8), (16), (1048576), (1073741824)) s(size);
+SELECT checksum_bench_data_loops(0);
+
+SELECT * FROM checksum_bench_data(0);
+SELECT * FROM checksum_bench_data(1073741825);
+SELECT * FROM checksum_bench_data(16, 64);
+SELECT * FROM checksum_bench_data(16, 0, -1);
+
+CREATE TABLE bench_table (id int4 PRIMARY KEY, name text);
+INSERT INTO bench_table SELECT g, md5(g::text) FROM generate_series(1, 1000) g;
+
+SELECT loops, tuples, bytes > 0 AS has_bytes, tuples_per_sec > 0 AS timed
+FROM checksum_bench_tuple('bench_table', false, 2);
+SELECT loops, tuples, bytes > 0 AS has_bytes, tuples_per_sec > 0 AS timed
+FROM checksum_bench_tuple('bench_table', true, 2);
+
+-- Values are measured as stored, here with a 1-byte varlena header
+SELECT loops, tuples, bytes, tuples_per_sec > 0 AS timed
+FROM checksum_bench_column('bench_table', 2, 2);
+SELECT * FROM checksum_bench_column('bench_table', 3);
+
+SELECT loops, tuples, bytes > 0 AS has_bytes, tuples_per_sec > 0 AS timed
+FROM checksum_bench_table('bench_table', 1);
+SELECT loops, tuples, bytes > 0 AS has_bytes, tuples_per_sec > 0 AS timed
+FROM checksum_bench_index('bench_table_pkey', 1);
+
+DROP TABLE bench_table;
@@ -12,6 +12,16 @@ RETURNS void
 AS 'MODULE_PATHNAME'
 LANGUAGE C STRICT;
 
+CREATE OR REPLACE FUNCTION test_column_checksum_typinfo()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
+CREATE OR REPLACE FUNCTION test_column_checksum_compressed(text)
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+
 CREATE OR REPLACE FUNCTION test_index_checksum_basic()
 RETURNS void
 AS 'MODULE_PATHNAME'
@@ -20,4 +30,16 @@ LANGUAGE C STRICT;
 CREATE OR REPLACE FUNCTION test_page_checksum_consistency()
 RETURNS void
 AS 'MODULE_PATHNAME'
-LANGUAGE C STRICT;
\ No newline at end of file
+LANGUAGE C STRICT;
+CREATE OR REPLACE FUNCTION test_checksum_data_kernels()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+CREATE OR REPLACE FUNCTION test_checksum_data_streaming()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
+CREATE OR REPLACE FUNCTION test_checksum_multiset()
+RETURNS void
+AS 'MODULE_PATHNAME'
+LANGUAGE C STRICT;
@@ -21,13 +21,19 @@
 #include "access/htup_details.h"
 #include "access/heapam.h"
 #include "access/tableam.h"
+#include "access/detoast.h"
+#include "access/heaptoast.h"
+#include "access/toast_compression.h"
+#include "access/toast_internals.h"
 #include "catalog/pg_type.h"
+#include "executor/tuptable.h"
 #include "storage/bufpage.h"
 #include "storage/checksum.h"
 #include "storage/checksum_tuple.h"
 #include "storage/checksum_column.h"
 #include "storage/checksum_index.h"
 #include "storage/checksum_database.h"
+#include "storage/checksum_simd.h"
 #include "utils/builtins.h"
 #include "utils/rel.h"
 #include "utils/memutils.h"
@@ -168,6 +174,203 @@ test_column_checksum_null(PG_FUNCTION_ARGS)
     PG_RETURN_VOID();
 }
 
+/*
+ * Checksums of the columns of test_column_checksum_typinfo(), as computed by
+ * the original implementation that looked up every value's type in the
+ * syscache.  Pass-by-value types and varlena headers are hashed in their
+ * in-memory form, so those depend on byte order.  The NULL column is left
+ * out.
+ */
+static const uint32 typinfo_expected[6] = {
+#ifdef WORDS_BIGENDIAN
+    0xFD4F19B5,                 /* int4 7 */
+    0x9E71C574,                 /* text 'column checksum' */
+    CHECKSUM_NULL,
+    0x223F98F6,                 /* name 'checksum' */
+    0x1D2FF92B,                 /* float8 2.5 */
+    0xE5783719                  /* cstring 'c string' */
+#else
+    0x3E2B1EE2,                 /* int4 7 */
+    0xF8A50823,                 /* text 'column checksum' */
+    CHECKSUM_NULL,
+    0x223F98F6,                 /* name 'checksum' */
+    0x635DB3EE,                 /* float8 2.5 */
+    0xE5783719                  /* cstring 'c string' */
+#endif
+};
+
+/*
+ * test_column_checksum_typinfo
+ *    Test that column checksums computed from precomputed type information,
+ *    per value and from a deformed slot, match the values the catalog-driven
+ *    implementation produced
+ */
+PG_FUNCTION_INFO_V1(test_column_checksum_typinfo);
+Datum
+test_column_checksum_typinfo(PG_FUNCTION_ARGS)
+{
+    MemoryContext oldcontext;
+    MemoryContext testcontext;
+    TupleDesc   tupdesc;
+    Datum       values[6];
+    bool        nulls[6] = {false, false, true, false, false, false};
+    NameData    name;
+    HeapTuple   tuple;
+    TupleTableSlot *slot;
+    ChecksumColumnInfo cols[6];
+    uint32      checksums[6];
+    int         attnum;
+
+    testcontext = AllocSetContextCreate(CurrentMemoryContext,
+                                        "ChecksumTestContext",
+                                        ALLOCSET_DEFAULT_SIZES);
+    oldcontext = MemoryContextSwitchTo(testcontext);
+
+    /* One column of every storage class, and a NULL */
+    tupdesc = CreateTemplateTupleDesc(6);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 1, "id", INT4OID, -1, 0);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 2, "label", TEXTOID, -1, 0);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 3, "missing", INT8OID, -1, 0);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 4, "ident", NAMEOID, -1, 0);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 5, "value", FLOAT8OID, -1, 0);
+    TupleDescInitEntry(tupdesc, (AttrNumber) 6, "note", CSTRINGOID, -1, 0);
+
+    namestrcpy(&name, "checksum");
+    values[0] = Int32GetDatum(7);
+    values[1] = CStringGetTextDatum("column checksum");
+    values[2] = (Datum) 0;
+    values[3] = NameGetDatum(&name);
+    values[4] = Float8GetDatum(2.5);
+    values[5] = CStringGetDatum("c string");
+
+    tuple = heap_form_tuple(tupdesc, values, nulls);
+    slot = MakeSingleTupleTableSlot(tupdesc, &TTSOpsHeapTuple);
+    ExecStoreHeapTuple(tuple, slot, false);
+
+    /* Request the columns out of order, so the slot must deform them all */
+    for (attnum = 6; attnum >= 1; attnum--)
+    {
+        ChecksumColumnInfo typinfo;
+
+        pg_column_checksum_info_from_desc(&cols[6 - attnum], tupdesc, attnum);
+        pg_column_checksum_info_init(&typinfo,
+                                     TupleDescAttr(tupdesc, attnum - 1)->atttypid,
+                                     attnum);
+        if (typinfo.typlen != cols[6 - attnum].typlen ||
+            typinfo.typbyval != cols[6 - attnum].typbyval ||
+            typinfo.typid != cols[6 - attnum].typid)
+            elog(ERROR, "type cache and tuple descriptor disagree on attribute %d",
+                 attnum);
+    }
+
+    pg_slot_column_checksums(slot, cols, 6, checksums);
+
+    for (attnum = 6; attnum >= 1; attnum--)
+    {
+        uint32      expected = typinfo_expected[attnum - 1];
+        uint32      actual;
+
+        actual = pg_column_checksum_internal(values[attnum - 1],
+                                             nulls[attnum - 1],
+                                             TupleDescAttr(tupdesc, attnum - 1)->atttypid,
+                                             -1, attnum);
+        if (actual != expected)
+            elog(ERROR, "checksum of attribute %d is %08X, expected %08X",
+                 attnum, actual, expected);
+        if (checksums[6 - attnum] != expected)
+            elog(ERROR, "slot checksum of attribute %d is %08X, expected %08X",
+                 attnum, checksums[6 - attnum], expected);
+        actual = pg_tuple_column_checksum(tuple->t_data, attnum, tupdesc);
+        if (actual != expected)
+            elog(ERROR, "tuple checksum of attribute %d is %08X, expected %08X",
+                 attnum, actual, expected);
+    }
+
+    ExecDropSingleTupleTableSlot(slot);
+    heap_freetuple(tuple);
+    MemoryContextSwitchTo(oldcontext);
+    MemoryContextDelete(testcontext);
+
+    PG_RETURN_VOID();
+}
+
+/*
+ * Checksum, as column 1, of the 1MB text value built by checksum_kernels.sql:
+ * the md5() of 1..16384, each followed by 32 dashes
+ */
+#ifdef WORDS_BIGENDIAN
+#define COMPRESSED_EXPECTED 0xE09BBA8D
+#else
+#define COMPRESSED_EXPECTED 0xD588F5BE
+#endif
+
+/* Bytes of compressed data checksum_varlena() reads at a time */
+#define COMPRESSED_SLICE_SIZE   (64 * TOAST_MAX_CHUNK_SIZE)
+
+/*
+ * test_column_checksum_compressed
+ *    Test that a value whose compressed form is larger than the slice the
+ *    column checksum reads at a time hashes to its pinned checksum, stored
+ *    out of line and compressed inline with each compression method
+ */
+PG_FUNCTION_INFO_V1(test_column_checksum_compressed);
+Datum
+test_column_checksum_compressed(PG_FUNCTION_ARGS)
+{
+    Datum       value = PG_GETARG_DATUM(0);
+    struct varlena *attr = (struct varlena *) DatumGetPointer(value);
+    struct varatt_external toast_pointer;
+    struct varlena *detoasted;
+    static const char cmethods[] = {
+        TOAST_PGLZ_COMPRESSION,
+#ifdef USE_LZ4
+        TOAST_LZ4_COMPRESSION,
+#endif
+    };
+    uint32      actual;
+
+    if (!VARATT_IS_EXTERNAL_ONDISK(attr))
+        elog(ERROR, "value is not stored out of line");
+    VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+    if (!VARATT_EXTERNAL_IS_COMPRESSED(toast_pointer) ||
+        VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer) <= COMPRESSED_SLICE_SIZE)
+        elog(ERROR, "value is not compressed to more than one slice");
+
+    actual = pg_column_checksum_internal(value, false, TEXTOID, -1, 1);
+    if (actual != COMPRESSED_EXPECTED)
+        elog(ERROR, "checksum of out-of-line value is %08X, expected %08X",
+             actual, COMPRESSED_EXPECTED);
+
+    detoasted = PG_DETOAST_DATUM(value);
+    actual = pg_column_checksum_internal(PointerGetDatum(detoasted), false,
+                                         TEXTOID, -1, 1);
+    if (actual != COMPRESSED_EXPECTED)
+        elog(ERROR, "checksum of detoasted value is %08X, expected %08X",
+             actual, COMPRESSED_EXPECTED);
+
+    for (int i = 0; i < lengthof(cmethods); i++)
+    {
+        Datum       compressed;
+
+        compressed = toast_compress_datum(PointerGetDatum(detoasted),
+                                          cmethods[i]);
+        if (DatumGetPointer(compressed) == NULL ||
+            VARSIZE(DatumGetPointer(compressed)) <= COMPRESSED_SLICE_SIZE)
+            elog(ERROR, "value is not compressed to more than one slice with method %c",
+                 cmethods[i]);
+
+        actual = pg_column_checksum_internal(compressed, false, TEXTOID, -1, 1);
+        if (actual != COMPRESSED_EXPECTED)
+            elog(ERROR, "checksum of value compressed with method %c is %08X, expected %08X",
+                 cmethods[i], actual, COMPRESSED_EXPECTED);
+        pfree(DatumGetPointer(compressed));
+    }
+
+    pfree(detoasted);
+
+    PG_RETURN_VOID();
+}
+
 /*
  * test_index_checksum_basic
  *    Basic test for index tuple checksum
@@ -178,7 +381,6 @@ test_index_checksum_basic(PG_FUNCTION_ARGS)
 {
     MemoryContext oldcontext;
     MemoryContext testcontext;
-    TupleDesc   tupdesc;
     IndexTuple  itup1, itup2;
     uint32      checksum1, checksum2;
     Size        size;
@@ -191,11 +393,6 @@ test_index_checksum_basic(PG_FUNCTION_ARGS)
                                         ALLOCSET_DEFAULT_SIZES);
     oldcontext = MemoryContextSwitchTo(testcontext);
     
-    /* Create a simple tuple descriptor for index */
-    tupdesc = CreateTemplateTupleDesc(2);
-    TupleDescInitEntry(tupdesc, (AttrNumber) 1, "key", INT4OID, -1, 0);
-    TupleDescInitEntry(tupdesc, (AttrNumber) 2, "tid_block", INT8OID, -1, 0);
-    
     /* Create index tuples - simplified approach */
     size = sizeof(IndexTupleData) + sizeof(int32) + sizeof(int64);
     itup1 = (IndexTuple) palloc0(size);
@@ -220,12 +417,17 @@ test_index_checksum_basic(PG_FUNCTION_ARGS)
     memcpy(data2 + sizeof(int32), &tid_val, sizeof(int64));
     
     /* Calculate checksums */
-    checksum1 = pg_index_tuple_checksum(itup1, tupdesc, 1);
-    checksum2 = pg_index_tuple_checksum(itup2, tupdesc, 1);
+    checksum1 = pg_index_tuple_checksum(itup1);
+    checksum2 = pg_index_tuple_checksum(itup2);
     
     /* Verify identical index tuples have identical checksums */
     if (checksum1 != checksum2)
         elog(ERROR, "Identical index tuples should have identical checksums");
+
+    /* Verify the heap TID is part of the checksum */
+    ItemPointerSet(&itup2->t_tid, 1, 2);
+    if (pg_index_tuple_checksum(itup2) == checksum1)
+        elog(ERROR, "Index tuples pointing to different heap tuples should have different checksums");
     
     pfree(itup1);
     pfree(itup2);
@@ -289,4 +491,441 @@ test_page_checksum_consistency(PG_FUNCTION_ARGS)
     MemoryContextDelete(testcontext);
     
     PG_RETURN_VOID();
-}
\ No newline at end of file
+}
+/*
+ * Reference implementation of pg_checksum_data(): feed word i of the input
+ * into partial sum i % N_SUMS, one word at a time.  This is the definition
+ * every row kernel has to reproduce bit for bit.
+ */
+static uint32
+reference_checksum_data(const char *data, uint32 len, uint32 init_value)
+{
+    static const uint32 offsets[CHECKSUM_SIMD_N_SUMS] = {
+        0x5B1F36E9, 0xB8525960, 0x02AB50AA, 0x1DE66D2A,
+        0x79FF467A, 0x9BB9F8A3, 0x217E7CD2, 0x83E13D2C,
+        0xF8D4474F, 0xE39EB970, 0x42C6AE16, 0x993216FA,
+        0x7B093B5D, 0x98DAFF3C, 0xF718902A, 0x0B1C9CDB,
+        0xE58F764B, 0x187636BC, 0x5D7B3BB1, 0xE73DE7DE,
+        0x92BEC979, 0xCCA6C0B2, 0x304A0979, 0x85AA43D4,
+        0x783125BB, 0x6CA8EAA2, 0xE407EAC6, 0x4B5CFC3E,
+        0x9FBF8C76, 0x15CA20BE, 0xF2CA9FD3, 0x959BD756
+    };
+    uint32      sums[CHECKSUM_SIMD_N_SUMS];
+    uint32      words = len / sizeof(uint32);
+    uint32      result = init_value;
+    uint32      i, j;
+
+#define REFERENCE_COMP(sum, value) \
+    do { \
+        uint32 __tmp = (sum) ^ (value); \
+        (sum) = __tmp * CHECKSUM_SIMD_FNV_PRIME ^ (__tmp >> 17); \
+    } while (0)
+
+    memcpy(sums, offsets, sizeof(sums));
+
+    for (i = 0; i < words; i++)
+    {
+        uint32      word;
+
+        memcpy(&word, data + i * sizeof(uint32), sizeof(uint32));
+        REFERENCE_COMP(sums[i % CHECKSUM_SIMD_N_SUMS], word);
+    }
+
+    if (len % sizeof(uint32) != 0)
+    {
+        uint32      last_word = 0;
+
+        for (j = 0; j < len % sizeof(uint32); j++)
+            last_word |= ((uint32) (unsigned char) data[words * sizeof(uint32) + j]) << (j * 8);
+        REFERENCE_COMP(sums[words % CHECKSUM_SIMD_N_SUMS], last_word);
+    }
+
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < CHECKSUM_SIMD_N_SUMS; j++)
+            REFERENCE_COMP(sums[j], 0);
+
+    for (i = 0; i < CHECKSUM_SIMD_N_SUMS; i++)
+        result ^= sums[i];
+
+    return result;
+}
+
+/* Base offsets of the two lane families of the wide variants */
+static const uint64 reference_offsets64[CHECKSUM_SIMD_N_SUMS] = {
+    UINT64CONST(0xBA6DD33E22266A0B), UINT64CONST(0x83C9E5DB8F89697F),
+    UINT64CONST(0xAE5B7A7DA9F7E03C), UINT64CONST(0x8C39D2EE690383A8),
+    UINT64CONST(0x71AD04CF4BE4BE01), UINT64CONST(0x1939B0172C97BFA5),
+    UINT64CONST(0x96256BBEB51F55BF), UINT64CONST(0xD94D7FDCF41C2ED8),
+    UINT64CONST(0x3B0B01D086BFC778), UINT64CONST(0x44E607C587B8D17B),
+    UINT64CONST(0x2A9028A20D9604AE), UINT64CONST(0xC34457D6BA0FC478),
+    UINT64CONST(0xFCC18536CFC647F1), UINT64CONST(0xBEA235B2A0AB26AC),
+    UINT64CONST(0xA22116B9C3FD9D7F), UINT64CONST(0xA7F5050DA4A714D3),
+    UINT64CONST(0xAFD524FB0FBBC1B9), UINT64CONST(0xBE89D0FF00D38174),
+    UINT64CONST(0x9A066965E4811B6A), UINT64CONST(0x5BA1BD9878DB4C1E),
+    UINT64CONST(0x68EAED9E903A586D), UINT64CONST(0xA43916B9AA131079),
+    UINT64CONST(0xA230A4B0F3D71CEA), UINT64CONST(0x97876A865C181AB0),
+    UINT64CONST(0x7762B5C964F7585A), UINT64CONST(0x6E5B33891ED99506),
+    UINT64CONST(0x6BAF298FA2FDA818), UINT64CONST(0x0F74A8C358E4B89F),
+    UINT64CONST(0x9A9BF59280381DE4), UINT64CONST(0xA92FA52B3B41F8B5),
+    UINT64CONST(0x073C953CB490044E), UINT64CONST(0x39279A1979952EE7)
+};
+
+static const uint64 reference_offsets128[CHECKSUM_SIMD_N_SUMS] = {
+    UINT64CONST(0x8271925F8E540A7F), UINT64CONST(0xEB41C4FF504D65AF),
+    UINT64CONST(0x25C06752C25316A9), UINT64CONST(0x23356714C3A24536),
+    UINT64CONST(0xC5644F124083694D), UINT64CONST(0x853A4696DB65B72F),
+    UINT64CONST(0x2635F8788A11DDEC), UINT64CONST(0x17F94F3BC95C8898),
+    UINT64CONST(0xCB23D365E35931CF), UINT64CONST(0xD24F1F56C2B772B0),
+    UINT64CONST(0x7248327067170B31), UINT64CONST(0x13E061D0796D8D6F),
+    UINT64CONST(0xF2B7402048E4E6B7), UINT64CONST(0xDCA7640D230441D5),
+    UINT64CONST(0x28BAA50E1F371E21), UINT64CONST(0x4E2F360AC32A33D5),
+    UINT64CONST(0x5786B560A16EFC06), UINT64CONST(0x1C4C0673A0F6CF04),
+    UINT64CONST(0x587E95517700C5C9), UINT64CONST(0x9AF9EA03990CCF81),
+    UINT64CONST(0x0DC06A71A09B9FAD), UINT64CONST(0x10EF852CE214AC26),
+    UINT64CONST(0xFAE6AA9C52CEBE1D), UINT64CONST(0x5963DBE61768CDFD),
+    UINT64CONST(0x8CA450A6101D63FD), UINT64CONST(0xDBCF6107F7A42EF8),
+    UINT64CONST(0x62C9C99910C215A0), UINT64CONST(0xAFF4CD19B6F51682),
+    UINT64CONST(0x10A03BFEB1398005), UINT64CONST(0xF155611BCBC30030),
+    UINT64CONST(0x686DBD4E20BBFBCE), UINT64CONST(0x81D82AC7ED2749AA)
+};
+
+/*
+ * Reference implementation of one lane family of the wide variants, one
+ * word at a time.
+ */
+static uint64
+reference_checksum_wide(const char *data, uint32 len, uint64 init_value,
+                        const uint64 *offsets, uint64 prime)
+{
+    uint64      sums[CHECKSUM_SIMD_N_SUMS];
+    uint32      words = len / sizeof(uint64);
+    uint64      result = init_value;
+    uint32      i, j;
+
+#define REFERENCE_COMP64(sum, value) \
+    do { \
+        uint64 __tmp = (sum) ^ (value); \
+        (sum) = __tmp * prime ^ (__tmp >> 29); \
+    } while (0)
+
+    memcpy(sums, offsets, sizeof(sums));
+
+    for (i = 0; i < words; i++)
+    {
+        uint64      word;
+
+        memcpy(&word, data + i * sizeof(uint64), sizeof(uint64));
+        REFERENCE_COMP64(sums[i % CHECKSUM_SIMD_N_SUMS], word);
+    }
+
+    if (len % sizeof(uint64) != 0)
+    {
+        uint64      last_word = 0;
+
+        for (j = 0; j < len % sizeof(uint64); j++)
+            last_word |= ((uint64) (unsigned char) data[words * sizeof(uint64) + j]) << (j * 8);
+        REFERENCE_COMP64(sums[words % CHECKSUM_SIMD_N_SUMS], last_word);
+    }
+
+    REFERENCE_COMP64(sums[0], (uint64) len);
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < CHECKSUM_SIMD_N_SUMS; j++)
+            REFERENCE_COMP64(sums[j], 0);
+
+    for (i = 0; i < CHECKSUM_SIMD_N_SUMS; i++)
+        result ^= sums[i];
+
+    result ^= result >> 33;
+    result *= UINT64CONST(0xFF51AFD7ED558CCD);
+    result ^= result >> 33;
+    result *= UINT64CONST(0xC4CEB9FE1A85EC53);
+    result ^= result >> 33;
+
+    return result;
+}
+
+/*
+ * Reference implementation of pg_checksum_data64().
+ */
+static uint64
+reference_checksum_data64(const char *data, uint32 len, uint64 init_value)
+{
+    return reference_checksum_wide(data, len, init_value,
+                                   reference_offsets64,
+                                   CHECKSUM_SIMD_FNV_PRIME64);
+}
+
+/*
+ * Reference implementation of pg_checksum_data128(): the high half is the
+ * 64-bit checksum, the low half the second lane family.
+ */
+static pg_checksum128
+reference_checksum_data128(const char *data, uint32 len,
+                           pg_checksum128 init_value)
+{
+    pg_checksum128 result;
+
+    result.hi = reference_checksum_wide(data, len, init_value.hi,
+                                        reference_offsets64,
+                                        CHECKSUM_SIMD_FNV_PRIME64);
+    result.lo = reference_checksum_wide(data, len, init_value.lo,
+                                        reference_offsets128,
+                                        CHECKSUM_SIMD_WIDE_PRIME64);
+    return result;
+}
+
+/*
+ * check_checksum_data_kernel
+ *    Compare pg_checksum_data() with the reference implementation over a
+ *    range of lengths and alignments, using whichever row kernel is
+ *    currently installed
+ */
+static void
+check_checksum_data_kernel(const char *name, const char *buffer)
+{
+    uint32      len;
+    uint32      offset;
+
+    for (offset = 0; offset < 8; offset++)
+    {
+        for (len = 0; len <= 2 * BLCKSZ; len += (len < 300 ? 1 : 61))
+        {
+            uint32      expected = reference_checksum_data(buffer + offset, len, len);
+            uint32      actual = pg_checksum_data(buffer + offset, len, len);
+
+            if (expected != actual)
+                elog(ERROR, "%s kernel checksum mismatch at offset %u, length %u: %08X != %08X",
+                     name, offset, len, actual, expected);
+        }
+    }
+}
+
+/*
+ * check_checksum_wide_kernel
+ *    Compare pg_checksum_data64() and both halves of pg_checksum_data128()
+ *    with the reference implementations, using whichever wide row kernels
+ *    are currently installed
+ */
+static void
+check_checksum_wide_kernel(const char *name, const char *buffer)
+{
+    uint32      len;
+    uint32      offset;
+
+    for (offset = 0; offset < 8; offset++)
+    {
+        for (len = 0; len <= 2 * BLCKSZ; len += (len < 300 ? 1 : 61))
+        {
+            pg_checksum128 init = {len, ~(uint64) len};
+            pg_checksum128 expected128;
+            pg_checksum128 actual128;
+
+            if (pg_checksum_data64(buffer + offset, len, len) !=
+                reference_checksum_data64(buffer + offset, len, len))
+                elog(ERROR, "%s kernel 64-bit checksum mismatch at offset %u, length %u",
+                     name, offset, len);
+
+            expected128 = reference_checksum_data128(buffer + offset, len, init);
+            actual128 = pg_checksum_data128(buffer + offset, len, init);
+            if (actual128.hi != expected128.hi || actual128.lo != expected128.lo)
+                elog(ERROR, "%s kernel 128-bit checksum mismatch at offset %u, length %u",
+                     name, offset, len);
+        }
+    }
+}
+
+/*
+ * test_checksum_data_kernels
+ *    Test that every row kernel this CPU supports, and the wide variants,
+ *    match the reference implementations for a range of lengths and
+ *    alignments
+ */
+PG_FUNCTION_INFO_V1(test_checksum_data_kernels);
+Datum
+test_checksum_data_kernels(PG_FUNCTION_ARGS)
+{
+    pg_checksum_rows_function saved_rows = pg_checksum_data_rows;
+    pg_checksum_rows64_function saved_rows64 = pg_checksum_data_rows64;
+    pg_checksum_rows128_function saved_rows128 = pg_checksum_data_rows128;
+    char       *buffer;
+    uint32      seed = 0x2545F491;
+    int         ntested = 0;
+    int         i;
+
+    buffer = (char *) palloc(2 * BLCKSZ + 8);
+    for (i = 0; i < 2 * BLCKSZ + 8; i++)
+    {
+        /* xorshift, so the input is deterministic */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        buffer[i] = (char) seed;
+    }
+
+    /* The kernel selected for this CPU, through the usual dispatch */
+    check_checksum_data_kernel(pg_checksum_data_kernel_name(), buffer);
+
+    /* Then each kernel the CPU supports, installed in turn */
+    PG_TRY();
+    {
+        for (i = 0; i < pg_checksum_data_nkernels; i++)
+        {
+            const pg_checksum_rows_kernel *kernel = &pg_checksum_data_kernels[i];
+
+            if (kernel->available != NULL && !kernel->available())
+                continue;
+
+            pg_checksum_data_rows = kernel->rows;
+            check_checksum_data_kernel(kernel->name, buffer);
+            ntested++;
+        }
+    }
+    PG_FINALLY();
+    {
+        pg_checksum_data_rows = saved_rows;
+    }
+    PG_END_TRY();
+
+    /* The portable kernel at least is always there */
+    if (ntested == 0)
+        elog(ERROR, "no checksum row kernel was tested");
+
+    /* The wide variants, likewise */
+    check_checksum_wide_kernel("selected", buffer);
+
+    PG_TRY();
+    {
+        for (i = 0; i < pg_checksum_data_nwide_kernels; i++)
+        {
+            const pg_checksum_wide_kernel *kernel = &pg_checksum_data_wide_kernels[i];
+
+            if (kernel->available != NULL && !kernel->available())
+                continue;
+
+            pg_checksum_data_rows64 = kernel->rows64;
+            pg_checksum_data_rows128 = kernel->rows128;
+            check_checksum_wide_kernel(kernel->name, buffer);
+        }
+    }
+    PG_FINALLY();
+    {
+        pg_checksum_data_rows64 = saved_rows64;
+        pg_checksum_data_rows128 = saved_rows128;
+    }
+    PG_END_TRY();
+
+    pfree(buffer);
+
+    PG_RETURN_VOID();
+}
+
+/*
+ * test_checksum_data_streaming
+ *    Test that the incremental checksum interface gives the one-shot
+ *    result however the input is divided into pieces
+ */
+PG_FUNCTION_INFO_V1(test_checksum_data_streaming);
+Datum
+test_checksum_data_streaming(PG_FUNCTION_ARGS)
+{
+    static const uint32 piece_sizes[] = {1, 0, 3, 2, 7, 128, 5, 131, 4, 64};
+    char       *buffer;
+    uint32      seed = 0x9E3779B9;
+    uint32      len;
+    uint32      split;
+    int         i;
+
+    buffer = (char *) palloc(2 * BLCKSZ);
+    for (i = 0; i < 2 * BLCKSZ; i++)
+    {
+        /* xorshift, so the input is deterministic */
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        buffer[i] = (char) seed;
+    }
+
+    /* Two pieces, split at every possible position */
+    for (len = 0; len <= 300; len++)
+    {
+        uint32      expected = pg_checksum_data(buffer, len, len);
+
+        for (split = 0; split <= len; split++)
+        {
+            pg_logical_checksum_context ctx;
+
+            pg_logical_checksum_init(&ctx, len);
+            pg_logical_checksum_update(&ctx, buffer, split);
+            pg_logical_checksum_update(&ctx, buffer + split, len - split);
+            if (pg_logical_checksum_final(&ctx) != expected)
+                elog(ERROR, "incremental checksum mismatch for length %u split at %u",
+                     len, split);
+        }
+    }
+
+    /* Many pieces of varying, unaligned sizes, including empty ones */
+    for (len = 0; len <= 2 * BLCKSZ; len += (len < 600 ? 1 : 97))
+    {
+        pg_logical_checksum_context ctx;
+        uint32      offset = 0;
+
+        pg_logical_checksum_init(&ctx, len);
+        for (i = 0; offset < len; i++)
+        {
+            uint32      n = Min(piece_sizes[i % lengthof(piece_sizes)],
+                                len - offset);
+
+            pg_logical_checksum_update(&ctx, buffer + offset, n);
+            offset += n;
+        }
+        if (pg_logical_checksum_final(&ctx) != pg_checksum_data(buffer, len, len))
+            elog(ERROR, "incremental checksum mismatch for length %u in pieces",
+                 len);
+    }
+
+    pfree(buffer);
+
+    PG_RETURN_VOID();
+}
+
+/*
+ * test_checksum_multiset
+ *    Test the properties of the multiset aggregation that XOR lacks
+ */
+PG_FUNCTION_INFO_V1(test_checksum_multiset);
+Datum
+test_checksum_multiset(PG_FUNCTION_ARGS)
+{
+    uint64      a = pg_checksum_multiset_element(42);
+    uint64      b = pg_checksum_multiset_element(4711);
+    uint64      sum;
+    pg_checksum128 a128 = {0, PG_UINT64_MAX};
+    pg_checksum128 b128 = {1, 1};
+    pg_checksum128 sum128;
+
+    /* An element added twice must not cancel out, unlike with XOR */
+    sum = pg_checksum_multiset_add64(0, a);
+    sum = pg_checksum_multiset_add64(sum, a);
+    if (sum == 0 || sum == a)
+        elog(ERROR, "duplicated multiset element cancelled out");
+
+    /* The sum must not depend on the order of the elements */
+    if (pg_checksum_multiset_add64(pg_checksum_multiset_add64(0, a), b) !=
+        pg_checksum_multiset_add64(pg_checksum_multiset_add64(0, b), a))
+        elog(ERROR, "multiset sum depends on element order");
+
+    /* Removing an element must undo adding it */
+    sum = pg_checksum_multiset_add64(pg_checksum_multiset_add64(0, a), b);
+    if (pg_checksum_multiset_remove64(sum, b) != a)
+        elog(ERROR, "removing a multiset element did not undo adding it");
+
+    /* The 128-bit sum must carry from the low into the high half */
+    sum128 = pg_checksum_multiset_add128(a128, b128);
+    if (sum128.hi != 2 || sum128.lo != 0)
+        elog(ERROR, "128-bit multiset sum did not carry");
+    sum128 = pg_checksum_multiset_remove128(sum128, b128);
+    if (sum128.hi != a128.hi || sum128.lo != a128.lo)
+        elog(ERROR, "removing a 128-bit multiset element did not undo adding it");
+
+    PG_RETURN_VOID();
+}
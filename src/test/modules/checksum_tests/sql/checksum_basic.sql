@@ -115,5 +115,39 @@ SELECT
     AS all_name_checksums_unique
 FROM test_basic;
 
+-- Test H: pg_checksum_tuples returns the checksums of all visible rows,
+-- matching pg_checksum_tuple
+SELECT COUNT(*) = 5 AS bulk_matches_point_lookups
+FROM pg_checksum_tuples('test_basic'::regclass, false) b
+JOIN test_basic t ON t.ctid = b.ctid
+WHERE b.checksum = pg_checksum_tuple('test_basic'::regclass, t.ctid, false);
+
+-- Test I: pg_checksum_tuples can be limited to a block range
+SELECT
+    (SELECT COUNT(*) FROM pg_checksum_tuples('test_basic'::regclass, true, 0, 0)) AS empty_range,
+    (SELECT COUNT(*) FROM pg_checksum_tuples('test_basic'::regclass, true, 0, 1)) AS first_block,
+    (SELECT COUNT(*) FROM pg_checksum_tuples('test_basic'::regclass, true, 1, 100)) AS past_end;
+SELECT * FROM pg_checksum_tuples('test_basic'::regclass, false, 1, 0);
+
+-- Test J: Column checksums of TOASTed values don't depend on how they are
+-- stored; uncompressed out-of-line values are streamed slice by slice
+CREATE TABLE test_toast_ext (id int, payload text);
+ALTER TABLE test_toast_ext ALTER COLUMN payload SET STORAGE EXTERNAL;
+CREATE TABLE test_toast_comp (id int, payload text);
+INSERT INTO test_toast_ext VALUES
+    (1, 'short'), (2, repeat('abc', 400)), (3, repeat('abc', 100000)),
+    (4, repeat('xyzw', 50001));
+INSERT INTO test_toast_comp SELECT * FROM test_toast_ext;
+SELECT e.id,
+       pg_column_compression(e.payload) IS NOT NULL AS ext_compressed,
+       pg_column_compression(c.payload) IS NOT NULL AS comp_compressed,
+       pg_checksum_column('test_toast_ext'::regclass, e.ctid, 2) =
+           pg_checksum_column('test_toast_comp'::regclass, c.ctid, 2)
+           AS checksums_match
+FROM test_toast_ext e JOIN test_toast_comp c USING (id)
+ORDER BY e.id;
+DROP TABLE test_toast_ext;
+DROP TABLE test_toast_comp;
+
 -- Clean up
 DROP TABLE test_basic;
\ No newline at end of file
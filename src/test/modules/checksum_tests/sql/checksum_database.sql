@@ -50,5 +50,52 @@ SELECT
     COUNT(DISTINCT checksum) = 2 AS different_tables_have_different_checksums
 FROM table_checksums;
 
+-- Test C: Multiset database checksum is stable and differs from the XOR one
+SELECT
+    pg_database_checksum_multiset(false, false) =
+    pg_database_checksum_multiset(false, false)
+    AS multiset_is_stable,
+    pg_database_checksum_multiset(false, false) !=
+    pg_database_checksum(false, false)
+    AS multiset_differs_from_xor;
+
+-- Test D: The result doesn't depend on the number of parallel workers
+SET max_parallel_maintenance_workers = 0;
+CREATE TEMP TABLE serial_db_checksums AS
+SELECT pg_database_checksum(false, false) AS xor_checksum,
+       pg_database_checksum_multiset(false, false) AS multiset_checksum;
+SET max_parallel_maintenance_workers = 4;
+SELECT
+    pg_database_checksum(false, false) = xor_checksum AS parallel_xor_matches,
+    pg_database_checksum_multiset(false, false) = multiset_checksum
+    AS parallel_multiset_matches
+FROM serial_db_checksums;
+RESET max_parallel_maintenance_workers;
+
+-- Test E: The per-relation manifest adds up to the database checksum
+SELECT bit_xor(checksum) = pg_database_checksum(false, false)
+       AS manifest_matches_database
+FROM pg_database_checksum_manifest(false, false);
+SELECT relid::regclass, relkind, tuples, pages > 0 AS has_pages,
+       elapsed_ms >= 0 AS has_elapsed_ms
+FROM pg_database_checksum_manifest(false, false)
+WHERE relid IN ('test_checksum_schema.table1'::regclass,
+                'test_checksum_schema.table2'::regclass)
+ORDER BY relid::regclass::text;
+
+-- Test F: Blocks without visible tuples still count as pages
+CREATE TABLE test_checksum_schema.table3 (id integer, filler text)
+    WITH (autovacuum_enabled = off);
+INSERT INTO test_checksum_schema.table3
+SELECT gs, repeat('x', 200) FROM generate_series(1, 100) gs;
+DELETE FROM test_checksum_schema.table3 WHERE (ctid::text::point)[0] = 1;
+SELECT pages = pg_relation_size('test_checksum_schema.table3') /
+               current_setting('block_size')::int AS pages_include_empty_block,
+       tuples = (SELECT count(*) FROM test_checksum_schema.table3)
+       AS tuples_match
+FROM pg_database_checksum_manifest(false, false)
+WHERE relid = 'test_checksum_schema.table3'::regclass;
+DROP TABLE test_checksum_schema.table3;
+
 -- Clean up
 DROP SCHEMA test_checksum_schema CASCADE;
\ No newline at end of file
@@ -82,4 +82,122 @@ CREATE INDEX idx_test_expression ON test_index_checksum ((key1 * 2));
 
 SELECT 
     'idx_test_expression' as index_name,
-    pg_checksum_index('idx_test_expression'::regclass) != 0 AS checksum_non_zero;
\ No newline at end of file
+    pg_checksum_index('idx_test_expression'::regclass) != 0 AS checksum_non_zero;
+
+-- Test F: Multiset index checksums
+SELECT
+    pg_checksum_index_multiset('idx_test_btree'::regclass) != 0
+    AS multiset_non_zero,
+    pg_checksum_index_multiset('idx_test_btree'::regclass) !=
+    pg_checksum_index_multiset('idx_test_btree_multi'::regclass)
+    AS multiset_differs_between_indexes;
+
+-- Test G: Only leaf entries are hashed, so index checksums survive page
+-- splits, deduplication, GIN pending lists and REINDEX
+CREATE TABLE test_index_rebuild (
+    id integer NOT NULL,
+    grp integer NOT NULL,
+    tags text[] NOT NULL,
+    span int4range NOT NULL
+);
+CREATE INDEX idx_rebuild_btree ON test_index_rebuild (id);
+CREATE INDEX idx_rebuild_dedup ON test_index_rebuild (grp);
+CREATE INDEX idx_rebuild_hash ON test_index_rebuild USING hash (id);
+CREATE INDEX idx_rebuild_gin ON test_index_rebuild USING gin (tags)
+    WITH (fastupdate = on);
+CREATE INDEX idx_rebuild_gist ON test_index_rebuild USING gist (span);
+
+-- Grow the indexes by insertion, splitting pages as they fill up
+INSERT INTO test_index_rebuild
+SELECT gs, gs % 10, ARRAY['tag_' || (gs % 7), 'all'], int4range(gs, gs + 10)
+FROM generate_series(1, 5000) gs;
+
+CREATE INDEX idx_rebuild_brin ON test_index_rebuild USING brin (id)
+    WITH (pages_per_range = 4);
+
+CREATE TEMP TABLE index_checksums_before AS
+SELECT c.relname,
+       pg_checksum_index(c.oid) AS checksum,
+       pg_checksum_index_multiset(c.oid) AS multiset
+FROM pg_index i JOIN pg_class c ON c.oid = i.indexrelid
+WHERE i.indrelid = 'test_index_rebuild'::regclass;
+
+-- Rebuild without posting lists and without a pending list
+ALTER INDEX idx_rebuild_dedup SET (deduplicate_items = off);
+ALTER INDEX idx_rebuild_gin SET (fastupdate = off);
+REINDEX TABLE test_index_rebuild;
+
+SELECT relname,
+       pg_checksum_index(relname::regclass) = checksum AS same_checksum,
+       pg_checksum_index_multiset(relname::regclass) = multiset
+       AS same_multiset
+FROM index_checksums_before
+ORDER BY relname;
+
+-- Test H: The checksum still tracks the indexed data
+DO $$
+DECLARE
+    old_checksum integer;
+BEGIN
+    old_checksum := pg_checksum_index('idx_rebuild_gin'::regclass);
+    INSERT INTO test_index_rebuild VALUES (5001, 1, ARRAY['new'], 'empty');
+    IF pg_checksum_index('idx_rebuild_gin'::regclass) = old_checksum THEN
+        RAISE EXCEPTION 'GIN index checksum should change after an insert';
+    END IF;
+END;
+$$;
+
+-- Test I: Each index matches its table, entry for entry
+CREATE INDEX idx_rebuild_partial ON test_index_rebuild (id) WHERE grp = 3;
+CREATE INDEX idx_rebuild_expression ON test_index_rebuild ((id * 2));
+SELECT c.relname, v.consistent, v.index_entries, v.heap_entries,
+       v.index_checksum = v.heap_checksum AS same_checksum
+FROM pg_index i
+JOIN pg_class c ON c.oid = i.indexrelid,
+LATERAL pg_checksum_index_verify(c.oid) v
+WHERE i.indrelid = 'test_index_rebuild'::regclass
+  AND c.relname <> 'idx_rebuild_brin'
+ORDER BY c.relname;
+SELECT consistent FROM pg_checksum_index_verify('idx_rebuild_brin');
+
+-- Deleted rows whose entries VACUUM hasn't removed yet don't make a healthy
+-- index inconsistent, as the entries pointing to them are left out
+DELETE FROM test_index_rebuild WHERE id <= 100;
+SELECT c.relname, v.consistent
+FROM pg_index i
+JOIN pg_class c ON c.oid = i.indexrelid,
+LATERAL pg_checksum_index_verify(c.oid) v
+WHERE i.indrelid = 'test_index_rebuild'::regclass
+  AND c.relname <> 'idx_rebuild_brin'
+ORDER BY c.relname;
+VACUUM test_index_rebuild;
+SELECT c.relname, v.consistent
+FROM pg_index i
+JOIN pg_class c ON c.oid = i.indexrelid,
+LATERAL pg_checksum_index_verify(c.oid) v
+WHERE i.indrelid = 'test_index_rebuild'::regclass
+  AND c.relname <> 'idx_rebuild_brin'
+ORDER BY c.relname;
+
+DROP TABLE test_index_rebuild;
+
+-- Test J: Leaving out the entries of dead tuples doesn't hide an entry that
+-- is missing from the index
+CREATE FUNCTION checksum_test_indexed(id int) RETURNS bool
+LANGUAGE plpgsql IMMUTABLE AS $$ BEGIN RETURN id <= 50; END $$;
+CREATE TABLE test_index_missing (id int) WITH (autovacuum_enabled = off);
+INSERT INTO test_index_missing SELECT generate_series(1, 100);
+CREATE INDEX idx_missing ON test_index_missing (id)
+    WHERE checksum_test_indexed(id);
+DELETE FROM test_index_missing WHERE id = 1;
+-- Not really immutable: row 51 now belongs in the index, which lacks it
+CREATE OR REPLACE FUNCTION checksum_test_indexed(id int) RETURNS bool
+LANGUAGE plpgsql IMMUTABLE AS $$ BEGIN RETURN id <= 51; END $$;
+SELECT consistent, index_entries < heap_entries AS entry_missing
+FROM pg_checksum_index_verify('idx_missing');
+-- The dead row alone doesn't make the index inconsistent
+CREATE OR REPLACE FUNCTION checksum_test_indexed(id int) RETURNS bool
+LANGUAGE plpgsql IMMUTABLE AS $$ BEGIN RETURN id <= 50; END $$;
+SELECT consistent FROM pg_checksum_index_verify('idx_missing');
+DROP TABLE test_index_missing;
+DROP FUNCTION checksum_test_indexed(int);
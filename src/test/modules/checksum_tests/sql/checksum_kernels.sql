@@ -0,0 +1,29 @@
+-- Checksum kernel tests
+
+CREATE EXTENSION checksum_tests;
+
+-- Test A: The row kernel chosen for this CPU matches the reference algorithm
+SELECT test_checksum_data_kernels();
+
+-- Test B: Multiset aggregation keeps duplicates, is order-independent and
+-- can be decremented
+SELECT test_checksum_multiset();
+
+-- Test C: Column checksums from precomputed type information and deformed
+-- slots match the catalog-driven ones
+SELECT test_column_checksum_typinfo();
+
+-- Test D: The incremental checksum gives the one-shot result however the
+-- input is divided
+SELECT test_checksum_data_streaming();
+
+-- Test E: A compressed value larger than the slice the column checksum
+-- reads at a time is decompressed as it is hashed, to its pinned checksum
+CREATE TABLE test_compressed (payload text);
+INSERT INTO test_compressed
+    SELECT string_agg(md5(i::text) || repeat('-', 32), '' ORDER BY i)
+    FROM generate_series(1, 16384) i;
+SELECT test_column_checksum_compressed(payload) FROM test_compressed;
+DROP TABLE test_compressed;
+
+DROP EXTENSION checksum_tests;
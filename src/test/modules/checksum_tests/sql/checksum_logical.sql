@@ -0,0 +1,101 @@
+-- Incrementally maintained logical table checksums
+CREATE FUNCTION lc_check(rel regclass, OUT matches bool, OUT tuples int8) AS $$
+    SELECT m.checksum = c.checksum AND m.tuples = c.tuples, m.tuples
+    FROM pg_logical_checksum(rel) m, pg_logical_checksum_compute(rel) c
+$$ LANGUAGE sql;
+
+-- Test A: The checksum of a new table is maintained from the start
+CREATE TABLE lc_test (id integer, val text) WITH (logical_checksum = on);
+SELECT * FROM lc_check('lc_test');
+
+-- Test B: Inserts, updates and deletes keep it in sync with the contents
+INSERT INTO lc_test SELECT g, 'row ' || g FROM generate_series(1, 100) g;
+SELECT * FROM lc_check('lc_test');
+
+COPY lc_test FROM stdin;
+101	row 101
+102	row 102
+103	\N
+\.
+
+SELECT * FROM lc_check('lc_test');
+
+UPDATE lc_test SET val = val || ' updated' WHERE id % 2 = 0;
+SELECT * FROM lc_check('lc_test');
+
+DELETE FROM lc_test WHERE id > 93;
+SELECT * FROM lc_check('lc_test');
+
+-- Test C: Changes of aborted (sub)transactions are discarded
+BEGIN;
+INSERT INTO lc_test SELECT g, 'row ' || g FROM generate_series(201, 205) g;
+SAVEPOINT s1;
+INSERT INTO lc_test SELECT g, 'row ' || g FROM generate_series(206, 210) g;
+DELETE FROM lc_test WHERE id <= 50;
+ROLLBACK TO s1;
+INSERT INTO lc_test VALUES (211, 'row 211');
+COMMIT;
+SELECT * FROM lc_check('lc_test');
+
+BEGIN;
+DELETE FROM lc_test;
+ROLLBACK;
+SELECT * FROM lc_check('lc_test');
+
+-- Test D: Uncommitted changes are not reflected until commit
+BEGIN;
+INSERT INTO lc_test VALUES (301, 'row 301');
+SELECT tuples FROM pg_logical_checksum('lc_test');
+
+COMMIT;
+SELECT * FROM lc_check('lc_test');
+
+-- Test E: Toasted values are covered
+INSERT INTO lc_test
+SELECT 400, string_agg(md5(g::text), '') FROM generate_series(1, 1000) g;
+UPDATE lc_test SET id = 401 WHERE id = 400;
+SELECT * FROM lc_check('lc_test');
+
+-- Test F: Rewrites and truncation
+VACUUM FULL lc_test;
+SELECT * FROM lc_check('lc_test');
+
+ALTER TABLE lc_test ALTER COLUMN id TYPE bigint;
+SELECT * FROM lc_check('lc_test');
+
+BEGIN;
+TRUNCATE lc_test;
+INSERT INTO lc_test SELECT g, 'row ' || g FROM generate_series(1, 20) g;
+COMMIT;
+SELECT * FROM lc_check('lc_test');
+
+-- Test G: The checksum only depends on the contents, not on the order
+-- or location of the rows
+CREATE TABLE lc_copy (LIKE lc_test) WITH (logical_checksum = on);
+INSERT INTO lc_copy SELECT * FROM lc_test ORDER BY id DESC;
+SELECT a.checksum = b.checksum AS same_checksum
+FROM pg_logical_checksum('lc_test') a, pg_logical_checksum('lc_copy') b;
+
+UPDATE lc_copy SET val = 'changed' WHERE id = 1;
+SELECT a.checksum = b.checksum AS same_checksum
+FROM pg_logical_checksum('lc_test') a, pg_logical_checksum('lc_copy') b;
+
+CREATE TABLE lc_plain AS SELECT * FROM lc_test;
+SELECT a.checksum = b.checksum AS same_checksum
+FROM pg_logical_checksum('lc_test') a, pg_logical_checksum_compute('lc_plain') b;
+
+-- Test H: Turning the storage parameter off and on again
+ALTER TABLE lc_copy RESET (logical_checksum);
+SELECT * FROM pg_logical_checksum('lc_copy');
+
+ALTER TABLE lc_copy SET (logical_checksum = on);
+SELECT * FROM lc_check('lc_copy');
+
+-- Test I: Only permanent tables are supported
+CREATE UNLOGGED TABLE lc_unlogged (id integer) WITH (logical_checksum = on);
+
+-- Clean up
+DROP TABLE lc_plain;
+DROP TABLE lc_copy;
+DROP TABLE lc_test;
+DROP FUNCTION lc_check;
@@ -105,6 +105,221 @@ SELECT
     COUNT(DISTINCT group_checksum) = COUNT(*) AS all_groups_have_unique_checksums
 FROM group_checksums;
 
+-- Test G: Wide table checksums
+SELECT
+    pg_checksum_table64('test_table_checksum'::regclass, false) != 0
+    AS table64_non_zero,
+    pg_checksum_table64('test_table_checksum'::regclass, false) !=
+    pg_checksum_table64('test_table_checksum'::regclass, true)
+    AS header_changes_table64,
+    pg_checksum_table64('test_empty_table'::regclass, false) = 0
+    AS empty_table64_zero,
+    length(pg_checksum_table128('test_table_checksum'::regclass, false)) = 16
+    AS table128_is_16_bytes;
+
+-- Test H: The 64-bit table checksum is the XOR of the 64-bit tuple checksums,
+-- and the high half of the 128-bit one
+SELECT
+    BIT_XOR(pg_checksum_tuple64('test_table_checksum'::regclass, ctid, false)) =
+    pg_checksum_table64('test_table_checksum'::regclass, false)
+    AS table64_is_xor_of_tuples,
+    substring(pg_checksum_table128('test_table_checksum'::regclass, false) FROM 1 FOR 8) =
+    int8send(pg_checksum_table64('test_table_checksum'::regclass, false))
+    AS table128_extends_table64
+FROM test_table_checksum;
+
+-- Test I: The multiset table checksum is the sum, modulo 2^64, of the 64-bit
+-- tuple checksums
+SELECT
+    (SUM(pg_checksum_tuple64('test_table_checksum'::regclass, ctid, false)::numeric) -
+     pg_checksum_table_multiset('test_table_checksum'::regclass, false)) %
+    18446744073709551616 = 0
+    AS multiset_is_sum_of_tuples,
+    pg_checksum_table_multiset('test_empty_table'::regclass, false) = 0
+    AS empty_multiset_zero,
+    length(pg_checksum_table128_multiset('test_table_checksum'::regclass, false)) = 16
+    AS multiset128_is_16_bytes
+FROM test_table_checksum;
+
+-- Test J: Parallel table checksums equal serial ones
+CREATE TABLE test_parallel_checksum AS
+SELECT gs AS id, repeat('x', 80) AS padding
+FROM generate_series(1, 20000) gs;
+
+SET max_parallel_workers_per_gather = 0;
+CREATE TEMP TABLE serial_checksums AS
+SELECT
+    pg_checksum_table('test_parallel_checksum'::regclass, false) AS c32,
+    pg_checksum_table64('test_parallel_checksum'::regclass, true) AS c64,
+    pg_checksum_table_multiset('test_parallel_checksum'::regclass, false) AS m64,
+    pg_checksum_table128_multiset('test_parallel_checksum'::regclass, true) AS m128;
+
+SET max_parallel_workers_per_gather = 4;
+SET min_parallel_table_scan_size = 0;
+SELECT
+    c32 = pg_checksum_table('test_parallel_checksum'::regclass, false)
+    AS parallel_c32_matches,
+    c64 = pg_checksum_table64('test_parallel_checksum'::regclass, true)
+    AS parallel_c64_matches,
+    m64 = pg_checksum_table_multiset('test_parallel_checksum'::regclass, false)
+    AS parallel_m64_matches,
+    m128 = pg_checksum_table128_multiset('test_parallel_checksum'::regclass, true)
+    AS parallel_m128_matches
+FROM serial_checksums;
+
+-- The parallel_workers reloption takes precedence over the table size
+ALTER TABLE test_parallel_checksum SET (parallel_workers = 2);
+SELECT
+    c32 = pg_checksum_table('test_parallel_checksum'::regclass, false)
+    AS reloption_c32_matches
+FROM serial_checksums;
+
+-- Temporary tables are checksummed without workers, which can't read them
+CREATE TEMP TABLE test_parallel_temp AS
+SELECT gs AS id, repeat('x', 80) AS padding
+FROM generate_series(1, 20000) gs;
+ALTER TABLE test_parallel_temp SET (parallel_workers = 2);
+SET max_parallel_workers_per_gather = 0;
+CREATE TEMP TABLE serial_temp_checksums AS
+SELECT
+    pg_checksum_table('test_parallel_temp'::regclass, false) AS c32,
+    pg_checksum_table_multiset('test_parallel_temp'::regclass, false) AS m64;
+SET max_parallel_workers_per_gather = 4;
+SELECT
+    c32 = pg_checksum_table('test_parallel_temp'::regclass, false)
+    AS temp_c32_matches,
+    m64 = pg_checksum_table_multiset('test_parallel_temp'::regclass, false)
+    AS temp_m64_matches
+FROM serial_temp_checksums;
+DROP TABLE serial_temp_checksums;
+DROP TABLE test_parallel_temp;
+
+RESET min_parallel_table_scan_size;
+RESET max_parallel_workers_per_gather;
+DROP TABLE serial_checksums;
+DROP TABLE test_parallel_checksum;
+
+-- Test K: Merkle tree of block range checksums
+CREATE TABLE test_tree_a AS
+SELECT g AS id, repeat('x', 100) AS filler FROM generate_series(1, 1000) g;
+CREATE TABLE test_tree_b AS
+SELECT g AS id, repeat('x', 100) AS filler FROM generate_series(1, 1000) g;
+-- One root covering the table, one leaf per block
+SELECT
+    count(*) FILTER (WHERE level = 0) AS roots,
+    bool_and(start_block = 0 AND tuples = 1000 AND
+             end_block = pg_relation_size('test_tree_a') /
+                         current_setting('block_size')::int)
+        FILTER (WHERE level = 0) AS root_covers_table,
+    count(*) FILTER (WHERE level = (SELECT max(level) FROM
+        pg_checksum_table_tree('test_tree_a', 4, 1))) =
+        pg_relation_size('test_tree_a') / current_setting('block_size')::int
+        AS one_leaf_per_block
+FROM pg_checksum_table_tree('test_tree_a', 4, 1);
+-- Identical copies have identical trees
+SELECT count(*) AS differing_nodes
+FROM pg_checksum_table_tree('test_tree_a', 4, 1) a
+JOIN pg_checksum_table_tree('test_tree_b', 4, 1) b USING (level, node)
+WHERE a.checksum != b.checksum;
+-- After a change, the root differs, and so do only the leaves holding the
+-- old and the new version of the row
+UPDATE test_tree_b SET filler = 'y' WHERE id = 1;
+WITH a AS (SELECT * FROM pg_checksum_table_tree('test_tree_a', 4, 1)),
+     b AS (SELECT * FROM pg_checksum_table_tree('test_tree_b', 4, 1))
+SELECT
+    bool_or(a.checksum != b.checksum) FILTER (WHERE a.level = 0)
+        AS root_differs,
+    count(*) FILTER (WHERE a.checksum != b.checksum AND
+                     a.level = (SELECT max(level) FROM a)) BETWEEN 1 AND 2
+        AS few_leaves_differ
+FROM a JOIN b USING (level, node);
+-- An empty table has a single, empty leaf
+SELECT level, node, start_block, end_block, tuples
+FROM pg_checksum_table_tree('test_empty_table', 16, 8);
+SELECT * FROM pg_checksum_table_tree('test_tree_a', 1, 1);
+SELECT * FROM pg_checksum_table_tree('test_tree_a', 2147483647, 1);
+SELECT * FROM pg_checksum_table_tree('test_tree_a', 2, 0);
+DROP TABLE test_tree_a;
+DROP TABLE test_tree_b;
+
+-- Test L: Checksums of a set of columns
+CREATE TABLE test_cols_a (id int, name text, amount numeric, note text);
+INSERT INTO test_cols_a
+SELECT g, 'name ' || g, g * 1.5, CASE WHEN g % 3 = 0 THEN NULL ELSE 'note' END
+FROM generate_series(1, 500) g;
+CREATE TABLE test_cols_b AS SELECT * FROM test_cols_a ORDER BY id DESC;
+-- One row per tuple; equal rows have equal checksums wherever they are
+-- stored
+SELECT count(*) AS rows, count(*) FILTER (WHERE a.checksum = b.checksum)
+    AS matching
+FROM pg_checksum_columns('test_cols_a', '{1,3}') a
+JOIN test_cols_a ta ON ta.ctid = a.ctid
+JOIN test_cols_b tb ON tb.id = ta.id
+JOIN pg_checksum_columns('test_cols_b', '{1,3}') b ON b.ctid = tb.ctid;
+-- The aggregate doesn't depend on row order, only changes with the listed
+-- columns, and depends on the order of the columns
+UPDATE test_cols_b SET note = 'changed' WHERE id = 10;
+SELECT
+    pg_checksum_table_columns('test_cols_a', '{1,3}') =
+        pg_checksum_table_columns('test_cols_b', '{1,3}') AS same_projection,
+    pg_checksum_table_columns('test_cols_a', '{1,4}') !=
+        pg_checksum_table_columns('test_cols_b', '{1,4}') AS note_differs,
+    pg_checksum_table_columns('test_cols_a', '{1,3}') !=
+        pg_checksum_table_columns('test_cols_a', '{3,1}') AS order_matters;
+SELECT pg_checksum_table_columns('test_cols_a', '{}');
+SELECT pg_checksum_table_columns('test_cols_a', '{5}');
+SELECT * FROM pg_checksum_columns('test_cols_a', '{1,NULL}');
+DROP TABLE test_cols_a;
+DROP TABLE test_cols_b;
+
+-- Test M: Content-only checksums don't depend on how or where rows are
+-- stored
+CREATE TABLE test_content_a (id int, junk int, name text, payload text);
+ALTER TABLE test_content_a DROP COLUMN junk;
+INSERT INTO test_content_a
+SELECT g, 'name ' || g, repeat(md5(g::text), 200)
+FROM generate_series(1, 300) g;
+CREATE TABLE test_content_b (id int, name text, payload text);
+ALTER TABLE test_content_b ALTER COLUMN payload SET STORAGE EXTERNAL;
+INSERT INTO test_content_b SELECT * FROM test_content_a ORDER BY id DESC;
+CREATE TEMP TABLE content_before AS
+SELECT pg_checksum_table_content('test_content_a') AS content,
+       pg_checksum_table64('test_content_a', false) AS physical;
+UPDATE test_content_a SET name = name WHERE id % 2 = 0;
+VACUUM FULL test_content_a;
+-- The copy without the dropped column and with uncompressed out-of-line
+-- values matches, and the rewrite only changes the physical checksum
+SELECT
+    pg_checksum_table_content('test_content_a') =
+        pg_checksum_table_content('test_content_b') AS copies_match,
+    pg_checksum_table_content('test_content_a') = content AS survives_rewrite,
+    pg_checksum_table64('test_content_a', false) != physical
+        AS physical_changes
+FROM content_before;
+-- Without dropped columns, it is the checksum of all columns
+SELECT pg_checksum_table_content('test_content_b') =
+    pg_checksum_table_columns('test_content_b', '{1,2,3}') AS all_columns;
+-- Matching rows by key finds the one row that differs
+UPDATE test_content_b SET payload = 'changed' WHERE id = 7;
+SELECT ta.id
+FROM pg_checksum_tuples_content('test_content_a') a
+JOIN test_content_a ta ON ta.ctid = a.ctid
+JOIN test_content_b tb ON tb.id = ta.id
+JOIN pg_checksum_tuples_content('test_content_b') b ON b.ctid = tb.ctid
+WHERE a.checksum != b.checksum;
+DROP TABLE content_before;
+DROP TABLE test_content_a;
+DROP TABLE test_content_b;
+
+-- Checksum runs are counted in pg_stat_checksums
+CREATE TABLE test_checksum_stats AS SELECT g AS id FROM generate_series(1, 100) g;
+SELECT pg_checksum_table64('test_checksum_stats', false) IS NOT NULL AS computed;
+SELECT pg_stat_force_next_flush();
+SELECT invocations, tuples, bytes > 0 AS has_bytes,
+       last_result IS NOT NULL AS has_result, mismatches
+FROM pg_stat_checksums WHERE relid = 'test_checksum_stats'::regclass;
+DROP TABLE test_checksum_stats;
+
 -- Clean up
 DROP TABLE test_empty_table;
 DROP TABLE test_table_checksum;
\ No newline at end of file
@@ -351,6 +351,83 @@ sub test_various_data_types {
     $node->safe_psql('postgres', 'DROP TABLE test_types');
 }
 
+# Test 10: Logical checksums survive a clean restart and a crash
+sub test_logical_checksum_recovery {
+    my $node = shift;
+    my $check = "SELECT m.checksum = c.checksum AND m.tuples = c.tuples, m.tuples
+        FROM pg_logical_checksum('test_logical') m,
+             pg_logical_checksum_compute('test_logical') c";
+
+    $node->safe_psql('postgres',
+        'CREATE TABLE test_logical (id int, data text) WITH (logical_checksum = on)');
+    $node->safe_psql('postgres',
+        "INSERT INTO test_logical SELECT g, 'row ' || g FROM generate_series(1, 1000) g");
+
+    $node->restart;
+    is($node->safe_psql('postgres', $check), "t|1000",
+        'logical checksum restored after clean restart');
+
+    # Changes before and after a checkpoint are replayed as needed
+    $node->safe_psql('postgres', 'DELETE FROM test_logical WHERE id <= 100');
+    $node->safe_psql('postgres', 'CHECKPOINT');
+    $node->safe_psql('postgres',
+        "UPDATE test_logical SET data = 'updated' WHERE id % 3 = 0");
+    $node->safe_psql('postgres',
+        'BEGIN; DELETE FROM test_logical WHERE id > 900; ROLLBACK');
+    $node->safe_psql('postgres',
+        'INSERT INTO test_logical SELECT g, NULL FROM generate_series(2001, 2050) g');
+
+    $node->stop('immediate');
+    $node->start;
+    is($node->safe_psql('postgres', $check), "t|950",
+        'logical checksum recovered after crash');
+
+    $node->safe_psql('postgres', 'DROP TABLE test_logical');
+}
+
+# Test 11: Concurrent enables can't take more entries than there are
+sub test_logical_checksum_limit {
+    my $node = shift;
+
+    $node->append_conf('postgresql.conf', 'max_logical_checksum_relations = 2');
+    $node->restart;
+
+    # Two open transactions reserve both entries before either commits
+    my $psql1 = $node->background_psql('postgres');
+    my $psql2 = $node->background_psql('postgres');
+    $psql1->query_safe('BEGIN');
+    $psql1->query_safe(
+        'CREATE TABLE test_limit1 (id int) WITH (logical_checksum = on)');
+    $psql2->query_safe('BEGIN');
+    $psql2->query_safe(
+        'CREATE TABLE test_limit2 (id int) WITH (logical_checksum = on)');
+
+    my ($ret, $stdout, $stderr) = $node->psql('postgres',
+        'CREATE TABLE test_limit3 (id int) WITH (logical_checksum = on)');
+    isnt($ret, 0, 'enable fails while all entries are reserved');
+    like($stderr, qr/could not maintain the logical checksum of table "test_limit3"/,
+        'enable reports the reserved entries');
+
+    # An abort gives its reservation back, a commit turns it into an entry
+    $psql1->query_safe('ROLLBACK');
+    $psql2->query_safe('COMMIT');
+    $psql1->quit;
+    $psql2->quit;
+
+    $node->safe_psql('postgres',
+        'CREATE TABLE test_limit3 (id int) WITH (logical_checksum = on)');
+    is($node->safe_psql('postgres',
+        "SELECT a.tuples, b.tuples
+         FROM pg_logical_checksum('test_limit2') a,
+              pg_logical_checksum('test_limit3') b"), '0|0',
+        'both committed enables are maintained');
+
+    $node->safe_psql('postgres', 'DROP TABLE test_limit2, test_limit3');
+
+    $node->append_conf('postgresql.conf', 'max_logical_checksum_relations = 1000');
+    $node->restart;
+}
+
 # Run all tests
 test_tuple_checksum_basic($node);
 test_column_checksum_basic($node);
@@ -361,6 +438,8 @@ test_checksum_detects_corruption($node);
 test_identical_data_different_location($node);
 test_mvcc_checksum_behavior($node);
 test_various_data_types($node);
+test_logical_checksum_recovery($node);
+test_logical_checksum_limit($node);
 
 # Clean up
 $node->stop;
@@ -0,0 +1,103 @@
+# Copyright (c) 2026, PostgreSQL Global Development Group
+#
+# TAP tests for the background checksum scrubber
+
+use strict;
+use warnings FATAL => 'all';
+
+use PostgreSQL::Test::Utils;
+use Test::More;
+use PostgreSQL::Test::Cluster;
+
+# Set up a node whose scrubber verifies the postgres database without delay
+my $node = PostgreSQL::Test::Cluster->new('checksum_scrubber');
+$node->init;
+$node->append_conf('postgresql.conf', qq(
+checksum_scrubber_database = 'postgres'
+checksum_scrubber_max_rate = 0
+checksum_scrubber_naptime = 1s
+));
+$node->start;
+
+$node->safe_psql('postgres',
+    'CREATE TABLE test_scrub (id int PRIMARY KEY, data text)');
+$node->safe_psql('postgres',
+    "INSERT INTO test_scrub SELECT g, repeat('x', g % 100) FROM generate_series(1, 10000) g");
+$node->safe_psql('postgres',
+    'CREATE UNLOGGED TABLE test_scrub_unlogged AS SELECT * FROM test_scrub');
+
+ok( $node->poll_query_until('postgres',
+        "SELECT count(*) = 1 FROM pg_stat_activity WHERE backend_type = 'checksum scrubber'"),
+    'checksum scrubber is running');
+
+# Both the table and its index are verified by a later pass
+ok( $node->poll_query_until('postgres',
+        "SELECT count(*) = 2
+           FROM (VALUES ('test_scrub'::regclass), ('test_scrub_pkey'::regclass)) v(rel),
+                pg_stat_get_checksum_stats(rel) s
+          WHERE s.scrub_count > 0"),
+    'table and index verified by the scrubber');
+
+# The scrubber records the checksum the database manifest reports
+is( $node->safe_psql('postgres',
+        "SELECT s.last_checksum = m.checksum,
+                s.last_verified_lsn <= pg_current_wal_insert_lsn(),
+                s.last_verified_time <= now()
+           FROM pg_database_checksum_manifest(true, true) m,
+                pg_stat_get_checksum_stats(m.relid) s
+          WHERE m.relid = 'test_scrub'::regclass"),
+    't|t|t',
+    'scrubber result matches the database checksum manifest');
+
+# Unlogged tables are left out, as they are from database checksums
+is( $node->safe_psql('postgres',
+        "SELECT scrub_count, last_checksum IS NULL, last_verified_time IS NULL
+           FROM pg_stat_get_checksum_stats('test_scrub_unlogged'::regclass)"),
+    '0|t|t',
+    'unlogged table not verified');
+
+# Dropping a relation drops its checksum statistics
+my $relid = $node->safe_psql('postgres',
+    "SELECT 'test_scrub'::regclass::oid");
+$node->safe_psql('postgres', 'DROP TABLE test_scrub');
+is( $node->safe_psql('postgres',
+        "SELECT pg_stat_have_stats('checksum',
+                    (SELECT oid FROM pg_database WHERE datname = current_database()),
+                    $relid)"),
+    'f',
+    'checksum statistics dropped with the table');
+
+# An error while verifying a relation is recorded, and the scrubber goes on
+$node->safe_psql('postgres',
+    'CREATE TABLE test_scrub_corrupt AS SELECT g AS id FROM generate_series(1, 1000) g');
+my $corrupt_path = $node->safe_psql('postgres',
+    "SELECT pg_relation_filepath('test_scrub_corrupt')");
+$node->stop;
+
+open(my $fh, '+<', $node->data_dir . '/' . $corrupt_path)
+  or die "could not open $corrupt_path: $!";
+binmode $fh;
+sysseek($fh, 0, 0) or die "could not seek in $corrupt_path: $!";
+syswrite($fh, "\xff" x 64) or die "could not write to $corrupt_path: $!";
+close($fh);
+
+$node->start;
+ok( $node->poll_query_until('postgres',
+        "SELECT scrub_failures > 0 AND last_failure_time IS NOT NULL
+           FROM pg_stat_get_checksum_stats('test_scrub_corrupt'::regclass)"),
+    'verification failure recorded');
+
+my $scrubber_pid = $node->safe_psql('postgres',
+    "SELECT pid FROM pg_stat_activity WHERE backend_type = 'checksum scrubber'");
+ok( $node->poll_query_until('postgres',
+        "SELECT scrub_failures > 1
+           FROM pg_stat_get_checksum_stats('test_scrub_corrupt'::regclass)"),
+    'relation retried by a later pass');
+is( $node->safe_psql('postgres',
+        "SELECT pid FROM pg_stat_activity WHERE backend_type = 'checksum scrubber'"),
+    $scrubber_pid,
+    'scrubber keeps running after a failure');
+
+$node->stop;
+
+done_testing();